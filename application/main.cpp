@@ -1,4 +1,5 @@
 #include "../cli/mainfeatures.h"
+#include "../cli/server.h"
 #if defined(TAGEDITOR_GUI_QTWIDGETS)
 #include "../gui/initiate.h"
 #include "./knownfieldmodel.h"
@@ -29,10 +30,12 @@ using namespace QtUtilities;
 
 namespace Cli {
 
-SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argument &pedanticArg)
+SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argument &pedanticArg, Argument &jobsArg, Argument &profileArg)
     : filesArg(filesArg)
     , verboseArg(verboseArg)
     , pedanticArg(pedanticArg)
+    , jobsArg(jobsArg)
+    , profileArg(profileArg)
     , quietArg("quiet", 'q', "suppress printing progress information")
     , docTitleArg("doc-title", 'd', "specifies the document title (has no affect if not supported by the container)",
           { "title of first segment", "title of second segment" })
@@ -69,6 +72,14 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
           { "max. padding in byte" })
     , prefPaddingArg("preferred-padding", '\0', "specifies the preferred padding before the media data (used when the file is rewritten)",
           { "preferred padding in byte" })
+    , paddingPolicyArg("padding-policy", '\0',
+          "specifies whether the padding is fixed (as specified via --preferred-padding/--max-padding) or adaptive (determined per file from "
+          "the size of its tags and covers and its edit history)",
+          { "fixed/adaptive" })
+    , paddingHistoryArg("padding-history", '\0',
+          "specifies a file to record the number of edits per file in so the adaptive padding policy reserves more padding for frequently "
+          "edited files",
+          { "path" })
     , tagPosValueArg("value", '\0', "specifies the position, either front, back or current", { "front/back/current" })
     , forceTagPosArg("force", '\0', "forces the specified position even if the file needs to be rewritten")
     , tagPosArg("tag-pos", '\0', "specifies the preferred tag position")
@@ -77,10 +88,24 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
     , indexPosArg("index-pos", '\0', "specifies the preferred index position")
     , forceRewriteArg(
           "force-rewrite", '\0', "forces the file to rewritten from the scratch which ensures a backup is created and the preferred padding is used")
+    , planArg("plan", '\0',
+          "prints whether the changes would fit into the existing padding or require rewriting the file and the projected I/O without "
+          "modifying any files")
     , valuesArg("values", 'n', "specifies the values to be set", { "title=foo", "album=bar", "cover=/path/to/file" })
     , outputFilesArg("output-files", 'o', "specifies the output files; if present, the files specified with --files will not be modified",
           { "path 1", "path 2" })
+    , noCloneArg("no-clone", '\0',
+          "writes output files from scratch even if the file system supports cloning the input files (and updating the clones "
+          "in-place)")
+    , manifestArg("manifest", '\0',
+          "reads the files and the values to be set for each file from the specified manifest (tab-separated values or NDJSON if the file "
+          "extension is .ndjson/.jsonl; \"-\" to read tab-separated values from stdin) instead of --files",
+          { "path" })
     , backupDirArg("temp-dir", '\0', "specifies the directory for temporary/backup files", { "path" })
+    , journalArg("journal", '\0',
+          "saves the regions of files updated in-place which are going to be overwritten to the specified directory first so the files "
+          "can be restored after a crash (pending journals are restored when specifying the directory the next time)",
+          { "directory" })
     , layoutOnlyArg("layout-only", 'l', "confirms layout-only changes")
     , preserveModificationTimeArg("preserve-modification-time", '\0', "preserves the file's modification time")
     , preserveMuxingAppArg("preserve-muxing-app", '\0', "preserves the file's muxing app meta-data value")
@@ -94,6 +119,13 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
           "specifies the delimiter for providing cover type and description after the cover path (defaults to \":\" so the default syntax for cover "
           "values is \"path:cover-type:description\")",
           { "delimiter" })
+    , coverMaxSizeArg("cover-max-size", '\0',
+          "scales covers (the ones being set as well as existing ones) down to the specified size if they exceed it (preserving the aspect "
+          "ratio)",
+          { "<width>x<height>" })
+    , coverFormatArg("cover-format", '\0', "re-encodes covers (the ones being set as well as existing ones) using the specified image format",
+          { "jpeg/png/..." })
+    , coverQualityArg("cover-quality", '\0', "specifies the quality (0 to 100) to re-encode covers with", { "quality" })
     , setTagInfoArg("set", 's', "sets the specified tag information and attachments")
 {
     docTitleArg.setRequiredValueCount(Argument::varValueCount);
@@ -114,6 +146,8 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
     removeAttachmentArg.setConstraints(0, Argument::varValueCount);
     removeAttachmentArg.setPreDefinedCompletionValues("name id");
     removeAttachmentArg.setValueCompletionBehavior(ValueCompletionBehavior::PreDefinedValues | ValueCompletionBehavior::AppendEquationSign);
+    paddingPolicyArg.setPreDefinedCompletionValues("fixed adaptive");
+    paddingHistoryArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
     tagPosValueArg.setPreDefinedCompletionValues("front back current");
     tagPosValueArg.setImplicit(true);
     tagPosValueArg.setRequired(true);
@@ -128,9 +162,11 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
     valuesArg.setPreDefinedCompletionValues(Cli::fieldNamesForSet);
     valuesArg.setValueCompletionBehavior(ValueCompletionBehavior::PreDefinedValues | ValueCompletionBehavior::AppendEquationSign);
     outputFilesArg.setRequiredValueCount(Argument::varValueCount);
+    manifestArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
     jsArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
     jsSettingsArg.setValueCompletionBehavior(ValueCompletionBehavior::AppendEquationSign);
     jsSettingsArg.setRequiredValueCount(Argument::varValueCount);
+    coverFormatArg.setPreDefinedCompletionValues("jpeg png webp");
     setTagInfoArg.setCallback(std::bind(Cli::setTagInfo, std::cref(*this)));
     setTagInfoArg.setExample(PROJECT_NAME
         " set title=\"Title of \"{1st,2nd,3rd}\" file\" title=\"Title of \"{4..16}\"th file\" album=\"The Album\" -f /some/dir/*.m4a\n" PROJECT_NAME
@@ -145,9 +181,10 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
     setTagInfoArg.setSubArguments({ &valuesArg, &filesArg, &docTitleArg, &removeOtherFieldsArg, &treatUnknownFilesAsMp3FilesArg, &id3v1UsageArg,
         &id3v2UsageArg, &id3InitOnCreateArg, &id3TransferOnRemovalArg, &mergeMultipleSuccessiveTagsArg, &id3v2VersionArg, &encodingArg,
         &removeTargetArg, &addAttachmentArg, &updateAttachmentArg, &removeAttachmentArg, &removeExistingAttachmentsArg, &minPaddingArg,
-        &maxPaddingArg, &prefPaddingArg, &tagPosArg, &indexPosArg, &forceRewriteArg, &backupDirArg, &layoutOnlyArg, &preserveModificationTimeArg,
-        &preserveMuxingAppArg, &preserveWritingAppArg, &preserveTotalFieldsArg, &jsArg, &jsSettingsArg, &coverTypeDelimiterArg, &verboseArg,
-        &pedanticArg, &quietArg, &outputFilesArg });
+        &maxPaddingArg, &prefPaddingArg, &paddingPolicyArg, &paddingHistoryArg, &tagPosArg, &indexPosArg, &forceRewriteArg, &planArg,
+        &backupDirArg, &journalArg, &layoutOnlyArg, &preserveModificationTimeArg, &preserveMuxingAppArg, &preserveWritingAppArg,
+        &preserveTotalFieldsArg, &jsArg, &jsSettingsArg, &coverTypeDelimiterArg, &coverMaxSizeArg, &coverFormatArg, &coverQualityArg,
+        &verboseArg, &pedanticArg, &quietArg, &outputFilesArg, &noCloneArg, &manifestArg, &jobsArg, &profileArg });
 }
 
 } // namespace Cli
@@ -179,6 +216,17 @@ int main(int argc, char *argv[])
     ConfigValueArgument filesArg("files", 'f', "specifies the path of the file(s) to be opened", { "path 1", "path 2" });
     filesArg.setRequiredValueCount(Argument::varValueCount);
     ConfigValueArgument outputFileArg("output-file", 'o', "specifies the path of the output file", { "path" });
+    // number of files to process in parallel
+    ConfigValueArgument jobsArg(
+        "jobs", '\0', "specifies the number of files to process in parallel (0 or \"auto\" for one job per hardware thread)", { "number" });
+    // profiling
+    ConfigValueArgument profileArg("profile", '\0',
+        "prints the time spent in each phase of processing the files at the end (and writes a trace in Chrome's trace event format to the specified "
+        "file)",
+        { "trace file" });
+    profileArg.setRequiredValueCount(Argument::varValueCount); // the trace file is optional; more than one value is rejected by the profiler
+    // cache for read-only operations
+    ConfigValueArgument cacheArg("cache", '\0', "specifies the path of a cache file to speed up reading files which have not changed", { "path" });
     // print field names
     OperationArgument printFieldNamesArg("print-field-names", '\0', "lists available field names, track attribute names and modifier");
     printFieldNamesArg.setCallback(Cli::printFieldNames);
@@ -186,9 +234,9 @@ int main(int argc, char *argv[])
     ConfigValueArgument validateArg(
         "validate", 'c', "validates the file integrity as accurately as possible; the structure of the file will be parsed completely");
     OperationArgument displayFileInfoArg("info", 'i', "displays general file information", PROJECT_NAME " info -f /some/dir/*.m4a");
-    displayFileInfoArg.setCallback(
-        std::bind(Cli::displayFileInfo, _1, std::cref(filesArg), std::cref(verboseArg), std::cref(pedanticArg), std::cref(validateArg)));
-    displayFileInfoArg.setSubArguments({ &filesArg, &validateArg, &verboseArg, &pedanticArg });
+    displayFileInfoArg.setCallback(std::bind(Cli::displayFileInfo, _1, std::cref(filesArg), std::cref(verboseArg), std::cref(pedanticArg),
+        std::cref(validateArg), std::cref(jobsArg), std::cref(profileArg)));
+    displayFileInfoArg.setSubArguments({ &filesArg, &validateArg, &verboseArg, &pedanticArg, &jobsArg, &profileArg });
     // display tag info
     ConfigValueArgument fieldsArg("fields", 'n', "specifies the field names to be displayed", { "title", "album", "artist", "trackpos" });
     fieldsArg.setRequiredValueCount(Argument::varValueCount);
@@ -198,31 +246,55 @@ int main(int argc, char *argv[])
         PROJECT_NAME " get title album artist -f /some/dir/*.m4a");
     ConfigValueArgument showUnsupportedArg("show-unsupported", 'u', "shows unsupported fields (has only effect when no field names specified)");
     displayTagInfoArg.setCallback(std::bind(Cli::displayTagInfo, std::cref(fieldsArg), std::cref(showUnsupportedArg), std::cref(filesArg),
-        std::cref(verboseArg), std::cref(pedanticArg)));
-    displayTagInfoArg.setSubArguments({ &fieldsArg, &showUnsupportedArg, &filesArg, &verboseArg, &pedanticArg });
+        std::cref(verboseArg), std::cref(pedanticArg), std::cref(jobsArg), std::cref(cacheArg), std::cref(profileArg)));
+    displayTagInfoArg.setSubArguments({ &fieldsArg, &showUnsupportedArg, &filesArg, &verboseArg, &pedanticArg, &jobsArg, &cacheArg, &profileArg });
     // set tag info
-    Cli::SetTagInfoArgs setTagInfoArgs(filesArg, verboseArg, pedanticArg);
+    Cli::SetTagInfoArgs setTagInfoArgs(filesArg, verboseArg, pedanticArg, jobsArg, profileArg);
     // extract cover
     ConfigValueArgument fieldArg("field", 'n', "specifies the field to be extracted", { "field name" });
     fieldArg.setImplicit(true);
     ConfigValueArgument attachmentArg("attachment", 'a', "specifies the attachment to be extracted", { "id=..." });
     ConfigValueArgument indexArg("index", 'i', "specifies the value/attachment to extract by its index, e.g. 0 for the first value", { "0/1/2/..." });
+    ConfigValueArgument extractFilesArg("file", 'f', "specifies the path of the file(s) to extract the field/attachment from", { "path 1", "path 2" });
+    extractFilesArg.setRequiredValueCount(Argument::varValueCount);
+    extractFilesArg.setRequired(true);
     OperationArgument extractFieldArg("extract", 'e',
         "saves the value of the specified field (e.g. cover or other binary field) or attachment to the specified file or writes it to stdout if no "
         "output file has been specified");
-    extractFieldArg.setSubArguments({ &fieldArg, &attachmentArg, &indexArg, &fileArg, &outputFileArg, &verboseArg });
-    extractFieldArg.setExample(PROJECT_NAME " extract cover --output-file the-cover.jpg --file some-file.opus");
-    extractFieldArg.setCallback(std::bind(Cli::extractField, std::cref(fieldArg), std::cref(attachmentArg), std::cref(fileArg),
-        std::cref(outputFileArg), std::cref(indexArg), std::cref(verboseArg)));
+    extractFieldArg.setSubArguments({ &fieldArg, &attachmentArg, &indexArg, &extractFilesArg, &outputFileArg, &verboseArg, &jobsArg });
+    extractFieldArg.setExample(PROJECT_NAME " extract cover --output-file the-cover.jpg --file some-file.opus\n" PROJECT_NAME
+                                            " extract cover --output-file '{dir}/{basename}-{index}.{ext}' --file /some/dir/*.opus --jobs auto");
+    extractFieldArg.setCallback(std::bind(Cli::extractField, std::cref(fieldArg), std::cref(attachmentArg), std::cref(extractFilesArg),
+        std::cref(outputFileArg), std::cref(indexArg), std::cref(verboseArg), std::cref(jobsArg)));
     // export to JSON
     ConfigValueArgument prettyArg("pretty", '\0', "prints with indentation and spacing");
+    ConfigValueArgument ndjsonArg(
+        "ndjson", '\0', "prints one JSON object per line for each file as soon as it has been read (instead of a single JSON array at the end)");
     OperationArgument exportArg("export", 'j', "exports the tag information for the specified files to JSON");
-    exportArg.setSubArguments({ &filesArg, &prettyArg });
-    exportArg.setCallback(std::bind(Cli::exportToJson, _1, std::cref(filesArg), std::cref(prettyArg)));
+    exportArg.setSubArguments({ &fieldsArg, &filesArg, &prettyArg, &ndjsonArg, &jobsArg, &cacheArg, &profileArg });
+    exportArg.setCallback(std::bind(Cli::exportToJson, _1, std::cref(fieldsArg), std::cref(filesArg), std::cref(prettyArg), std::cref(ndjsonArg),
+        std::cref(jobsArg), std::cref(cacheArg), std::cref(profileArg)));
     // file info
     OperationArgument genInfoArg("html-info", '\0', "generates technical information about the specified file as HTML document");
     genInfoArg.setSubArguments({ &fileArg, &validateArg, &outputFileArg });
     genInfoArg.setCallback(std::bind(Cli::generateFileInfo, _1, std::cref(fileArg), std::cref(outputFileArg), std::cref(validateArg)));
+    // serve requests
+    ConfigValueArgument socketArg("socket", '\0', "specifies the path of the Unix domain socket to listen on", { "path" });
+    socketArg.setRequired(true);
+    ConfigValueArgument maxConnectionsArg(
+        "max-connections", '\0', "specifies the number of connections to serve before exiting (serves connections forever if omitted)", { "number" });
+    OperationArgument serveArg("serve", '\0',
+        "serves requests for the info, get, set and export operations received via a Unix domain socket (one JSON-RPC 2.0 request per line)",
+        PROJECT_NAME " serve --socket /run/tageditor.sock");
+    serveArg.setSubArguments({ &socketArg, &maxConnectionsArg });
+    const auto runCommand = [&parser, &timeSpanFormatArg](int argc, const char *const *argv) {
+        parser.resetArgs();
+        parser.parseArgs(argc, argv, ParseArgumentBehavior::CheckConstraints | ParseArgumentBehavior::ExitOnFailure);
+        Cli::applyGeneralConfig(timeSpanFormatArg);
+        parser.invokeCallbacks();
+        return Cli::exitCode;
+    };
+    serveArg.setCallback(std::bind(Cli::serve, std::cref(socketArg), std::cref(maxConnectionsArg), Cli::CommandRunner(runCommand)));
     // renaming utility
     ConfigValueArgument renamingUtilityArg("renaming-utility", '\0', "launches the renaming utility instead of the main GUI");
     // set arguments to parser
@@ -230,7 +302,8 @@ int main(int argc, char *argv[])
     qtConfigArgs.qtWidgetsGuiArg().addSubArgument(&defaultFileArg);
     qtConfigArgs.qtWidgetsGuiArg().addSubArgument(&renamingUtilityArg);
     parser.setMainArguments({ &qtConfigArgs.qtWidgetsGuiArg(), &printFieldNamesArg, &displayFileInfoArg, &displayTagInfoArg,
-        &setTagInfoArgs.setTagInfoArg, &extractFieldArg, &exportArg, &genInfoArg, &timeSpanFormatArg, &parser.noColorArg(), &parser.helpArg() });
+        &setTagInfoArgs.setTagInfoArg, &extractFieldArg, &exportArg, &genInfoArg, &serveArg, &timeSpanFormatArg, &parser.noColorArg(),
+        &parser.helpArg() });
     // parse given arguments
     parser.parseArgs(argc, argv, ParseArgumentBehavior::CheckConstraints | ParseArgumentBehavior::ExitOnFailure);
 
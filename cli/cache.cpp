@@ -0,0 +1,270 @@
+#include "./cache.h"
+
+#include "resources/config.h"
+
+#include <c++utilities/io/ansiescapecodes.h>
+#include <c++utilities/io/binaryreader.h>
+#include <c++utilities/io/binarywriter.h>
+#include <c++utilities/io/nativefilestream.h>
+#include <c++utilities/io/path.h>
+
+#if defined(PLATFORM_UNIX)
+#include <sys/stat.h>
+#endif
+
+#include <filesystem>
+#include <iostream>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+
+namespace Cli {
+
+/// \brief The magic bytes at the beginning of a cache file.
+static constexpr auto cacheMagic = std::string_view("TAGEDITOR-CACHE");
+/// \brief The version of the cache file format; increment when changing the format.
+static constexpr auto cacheFormatVersion = std::uint32_t(2);
+
+/*!
+ * \brief Determines the status of the file with the specified \a path.
+ * \remarks The returned status is not valid if the file does not exist or is not accessible.
+ */
+FileStatus FileStatus::fromPath(const char *path)
+{
+    auto status = FileStatus();
+    auto error = std::error_code();
+    const auto nativePath = std::filesystem::path(makeNativePath(path));
+    const auto absolutePath = std::filesystem::absolute(nativePath, error);
+    if (error) {
+        return status;
+    }
+    status.absolutePath = absolutePath.string();
+    status.size = static_cast<std::uint64_t>(std::filesystem::file_size(nativePath, error));
+    if (error) {
+        return status;
+    }
+    status.modificationTime = static_cast<std::int64_t>(std::filesystem::last_write_time(nativePath, error).time_since_epoch().count());
+    if (error) {
+        return status;
+    }
+#if defined(PLATFORM_UNIX)
+    struct stat fileStat;
+    if (::stat(path, &fileStat)) {
+        return status;
+    }
+    status.device = static_cast<std::uint64_t>(fileStat.st_dev);
+    status.inode = static_cast<std::uint64_t>(fileStat.st_ino);
+#if defined(PLATFORM_MAC)
+    status.statusChangeTime = static_cast<std::int64_t>(fileStat.st_ctimespec.tv_sec) * 1000000000 + fileStat.st_ctimespec.tv_nsec;
+#else
+    status.statusChangeTime = static_cast<std::int64_t>(fileStat.st_ctim.tv_sec) * 1000000000 + fileStat.st_ctim.tv_nsec;
+#endif
+#endif
+    status.valid = true;
+    return status;
+}
+
+/*!
+ * \brief Loads the cache stored at the specified \a path.
+ * \remarks Starts with an empty cache if the file does not exist yet or can not be read.
+ */
+ResultCache::ResultCache(std::string_view path)
+    : m_path(path)
+    , m_modified(false)
+{
+    load();
+}
+
+/*!
+ * \brief Returns the result cached for the specified \a variant and file or std::nullopt if there's no valid result.
+ */
+std::optional<std::string> ResultCache::find(std::string_view variant, const FileStatus &status)
+{
+    if (!status.valid) {
+        return std::nullopt;
+    }
+    const auto key = makeKey(variant, status.absolutePath);
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    const auto entry = m_entries.find(key);
+    if (entry == m_entries.end() || entry->second.size != status.size || entry->second.modificationTime != status.modificationTime
+        || entry->second.statusChangeTime != status.statusChangeTime || entry->second.device != status.device || entry->second.inode != status.inode) {
+        return std::nullopt;
+    }
+    return entry->second.result;
+}
+
+/*!
+ * \brief Stores the specified \a result for the specified \a variant and file (replacing a possibly outdated result).
+ */
+void ResultCache::store(std::string_view variant, const FileStatus &status, std::string &&result)
+{
+    if (!status.valid) {
+        return;
+    }
+    auto key = makeKey(variant, status.absolutePath);
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    auto &entry = m_entries[std::move(key)];
+    entry.size = status.size;
+    entry.modificationTime = status.modificationTime;
+    entry.statusChangeTime = status.statusChangeTime;
+    entry.device = status.device;
+    entry.inode = status.inode;
+    entry.result = std::move(result);
+    m_modified = true;
+}
+
+/*!
+ * \brief Writes the cache back to disk if it has been modified.
+ * \remarks The cache is written to a temporary file first which is renamed afterwards so the cache file is never left
+ *          in a half-written state.
+ */
+void ResultCache::save()
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    dropEntriesOfMissingFiles();
+    if (!m_modified) {
+        return;
+    }
+    const auto tempPath = m_path + ".tmp";
+    try {
+        auto stream = NativeFileStream();
+        stream.exceptions(ios_base::failbit | ios_base::badbit);
+        stream.open(tempPath, ios_base::out | ios_base::trunc | ios_base::binary);
+        auto writer = BinaryWriter(&stream);
+        const auto writeString = [&writer](std::string_view value) {
+            writer.writeUInt64LE(value.size());
+            writer.write(value.data(), static_cast<std::streamsize>(value.size()));
+        };
+        writer.write(cacheMagic.data(), static_cast<std::streamsize>(cacheMagic.size()));
+        writer.writeUInt32LE(cacheFormatVersion);
+        writeString(APP_VERSION);
+        writer.writeUInt64LE(m_entries.size());
+        for (const auto &[key, entry] : m_entries) {
+            writeString(key);
+            writer.writeUInt64LE(entry.size);
+            writer.writeInt64LE(entry.modificationTime);
+            writer.writeInt64LE(entry.statusChangeTime);
+            writer.writeUInt64LE(entry.device);
+            writer.writeUInt64LE(entry.inode);
+            writeString(entry.result);
+        }
+        stream.flush();
+        stream.close();
+        std::filesystem::rename(makeNativePath(tempPath), makeNativePath(m_path));
+        m_modified = false;
+    } catch (const std::ios_base::failure &e) {
+        cerr << Phrases::Warning << "An IO error occurred when writing the cache file \"" << tempPath << "\": " << e.what() << Phrases::EndFlush;
+    } catch (const std::filesystem::filesystem_error &e) {
+        cerr << Phrases::Warning << "Unable to replace the cache file \"" << m_path << "\": " << e.what() << Phrases::EndFlush;
+    }
+}
+
+/*!
+ * \brief Reads all entries from the cache file.
+ */
+void ResultCache::load()
+{
+    auto error = std::error_code();
+    const auto fileSize = std::filesystem::file_size(makeNativePath(m_path), error);
+    if (error) {
+        return; // assume the cache has just not been created yet
+    }
+    try {
+        auto stream = NativeFileStream();
+        stream.exceptions(ios_base::failbit | ios_base::badbit);
+        stream.open(m_path, ios_base::in | ios_base::binary);
+        auto reader = BinaryReader(&stream);
+        const auto readString = [&reader, fileSize] {
+            const auto size = reader.readUInt64LE();
+            if (size > fileSize) {
+                throw std::ios_base::failure("string size exceeds file size");
+            }
+            return reader.readString(static_cast<std::size_t>(size));
+        };
+        if (reader.readString(cacheMagic.size()) != cacheMagic) {
+            cerr << Phrases::Warning << "The file \"" << m_path << "\" is no cache file, it will be overridden." << Phrases::EndFlush;
+            return;
+        }
+        if (reader.readUInt32LE() != cacheFormatVersion || readString() != APP_VERSION) {
+            return; // discard cache created by another version
+        }
+        for (auto count = reader.readUInt64LE(); count; --count) {
+            auto key = readString();
+            auto entry = Entry();
+            entry.size = reader.readUInt64LE();
+            entry.modificationTime = reader.readInt64LE();
+            entry.statusChangeTime = reader.readInt64LE();
+            entry.device = reader.readUInt64LE();
+            entry.inode = reader.readUInt64LE();
+            entry.result = readString();
+            m_entries.insert_or_assign(std::move(key), std::move(entry));
+        }
+    } catch (const std::ios_base::failure &e) {
+        m_entries.clear();
+        cerr << Phrases::Warning << "Unable to read the cache file \"" << m_path << "\": " << e.what() << Phrases::End
+             << "note: The cache will be rebuilt." << endl;
+    }
+}
+
+/*!
+ * \brief Removes the entries of files which do not exist anymore so the cache does not grow indefinitely.
+ * \remarks The mutex must be locked when calling this function.
+ */
+void ResultCache::dropEntriesOfMissingFiles()
+{
+    auto error = std::error_code();
+    for (auto i = m_entries.begin(); i != m_entries.end();) {
+        const auto &key = i->first;
+        const auto absolutePath = std::string_view(key).substr(key.find('\0') + 1);
+        if (std::filesystem::exists(makeNativePath(absolutePath), error) || error) {
+            ++i;
+            continue;
+        }
+        i = m_entries.erase(i);
+        m_modified = true;
+    }
+}
+
+/*!
+ * \brief Returns the key for the specified \a variant and \a absolutePath.
+ */
+std::string ResultCache::makeKey(std::string_view variant, std::string_view absolutePath)
+{
+    auto key = std::string();
+    key.reserve(variant.size() + 1 + absolutePath.size());
+    key += variant;
+    key += '\0';
+    key += absolutePath;
+    return key;
+}
+
+/*!
+ * \brief Starts capturing the output written to \a stream.
+ */
+OutputCapture::OutputCapture(std::ostream &stream)
+    : m_stream(stream)
+    , m_originalBuffer(stream.rdbuf(m_buffer.rdbuf()))
+{
+}
+
+/*!
+ * \brief Stops capturing and passes the captured output on to the stream.
+ */
+OutputCapture::~OutputCapture()
+{
+    m_stream.rdbuf(m_originalBuffer);
+    if (const auto output = m_buffer.str(); !output.empty()) {
+        m_stream << output << std::flush;
+    }
+}
+
+/*!
+ * \brief Returns the output captured so far.
+ */
+std::string OutputCapture::str() const
+{
+    return m_buffer.str();
+}
+
+} // namespace Cli
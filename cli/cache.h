@@ -0,0 +1,88 @@
+#ifndef CLI_CACHE
+#define CLI_CACHE
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Cli {
+
+/*!
+ * \brief The FileStatus struct holds the information used to determine whether a cached result for a file is still valid.
+ */
+struct FileStatus {
+    static FileStatus fromPath(const char *path);
+
+    std::string absolutePath;
+    std::uint64_t size = 0;
+    std::int64_t modificationTime = 0;
+    std::int64_t statusChangeTime = 0;
+    std::uint64_t device = 0;
+    std::uint64_t inode = 0;
+    bool valid = false;
+};
+
+/*!
+ * \brief The ResultCache class implements a persistent cache for the results of read-only operations.
+ *
+ * Results are stored per variant (e.g. the operation and the options affecting its output) and file. A result is only
+ * considered valid as long as the size, modification time, status change time and inode of the file remain unchanged. The
+ * status change time is taken into account because the modification time can be set arbitrarily (e.g. via touch).
+ *
+ * \remarks
+ * - The cache is loaded completely when constructing the object and only written back when invoking save().
+ * - find() and store() may be invoked from multiple threads.
+ * - The cache is discarded if it has been written by another version of the tag editor.
+ * - Entries of files which do not exist anymore are dropped when saving the cache.
+ */
+class ResultCache {
+public:
+    explicit ResultCache(std::string_view path);
+
+    std::optional<std::string> find(std::string_view variant, const FileStatus &status);
+    void store(std::string_view variant, const FileStatus &status, std::string &&result);
+    void save();
+
+private:
+    struct Entry {
+        std::uint64_t size = 0;
+        std::int64_t modificationTime = 0;
+        std::int64_t statusChangeTime = 0;
+        std::uint64_t device = 0;
+        std::uint64_t inode = 0;
+        std::string result;
+    };
+
+    void load();
+    void dropEntriesOfMissingFiles();
+    static std::string makeKey(std::string_view variant, std::string_view absolutePath);
+
+    std::string m_path;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::mutex m_mutex;
+    bool m_modified;
+};
+
+/*!
+ * \brief The OutputCapture class captures everything written to the specified stream while the object is alive.
+ * \remarks The captured output is passed on to the stream when the object is destroyed.
+ */
+class OutputCapture {
+public:
+    explicit OutputCapture(std::ostream &stream);
+    ~OutputCapture();
+    std::string str() const;
+
+private:
+    std::ostream &m_stream;
+    std::ostringstream m_buffer;
+    std::streambuf *m_originalBuffer;
+};
+
+} // namespace Cli
+
+#endif // CLI_CACHE
@@ -0,0 +1,131 @@
+#include "./changedetection.h"
+#include "./contenthash.h"
+#include "./countingstreambuffer.h"
+
+#include <tagparser/abstractcontainer.h>
+#include <tagparser/abstracttrack.h>
+#include <tagparser/diagnostics.h>
+#include <tagparser/exceptions.h>
+#include <tagparser/id3/id3v1tag.h>
+#include <tagparser/id3/id3v2tag.h>
+#include <tagparser/matroska/matroskatag.h>
+#include <tagparser/mediafileinfo.h>
+#include <tagparser/mp4/mp4tag.h>
+#include <tagparser/vorbis/vorbiscomment.h>
+
+#include <ostream>
+#include <string_view>
+
+using namespace std;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \brief The HashingStreamBuffer class discards everything written to it but computes the FNV-1a hash of the written bytes.
+ * \remarks Used to fingerprint tags which can only be serialized to a stream without buffering them.
+ */
+class HashingStreamBuffer : public CountingStreamBuffer {
+public:
+    void add(std::string_view data);
+    template <typename NumberType> void add(NumberType number);
+    std::uint64_t hash() const
+    {
+        return m_hash;
+    }
+
+protected:
+    std::streamsize xsputn(const char *data, std::streamsize count) override
+    {
+        m_hash = computeContentHash(data, static_cast<std::size_t>(count), m_hash);
+        return CountingStreamBuffer::xsputn(data, count);
+    }
+
+private:
+    std::uint64_t m_hash = contentHashBasis;
+};
+
+/*!
+ * \brief Adds the specified \a data (prefixed with its size so consecutive strings can not be confused) to the hash.
+ */
+void HashingStreamBuffer::add(std::string_view data)
+{
+    add(static_cast<std::uint64_t>(data.size()));
+    xsputn(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+/*!
+ * \brief Adds the specified \a number to the hash.
+ */
+template <typename NumberType> void HashingStreamBuffer::add(NumberType number)
+{
+    xsputn(reinterpret_cast<const char *>(&number), sizeof(number));
+}
+
+/*!
+ * \brief Returns a fingerprint of the meta-data of \a fileInfo which can be altered via the set operation.
+ *
+ * The fingerprint covers the tags as serialized by the tag parser, the track meta-data (name, language, track number and
+ * flags) and the titles of the container. So if the fingerprint taken after modifying the meta-data equals the one taken
+ * right after parsing the file, applying the changes would not alter the file semantically.
+ *
+ * \returns Returns the fingerprint or std::nullopt if a tag can not be serialized (and thus not compared).
+ * \remarks
+ * - Attachments are not covered; the caller needs to assume a change if attachments have been altered.
+ * - Changes of the file layout (e.g. padding) and of the writing/muxing application are not considered a change.
+ */
+std::optional<std::uint64_t> computeMetaDataFingerprint(MediaFileInfo &fileInfo)
+{
+    auto diag = Diagnostics();
+    auto buffer = HashingStreamBuffer();
+    auto stream = std::ostream(&buffer);
+    try {
+        for (auto *const tag : fileInfo.tags()) {
+            buffer.add(static_cast<std::uint64_t>(tag->type()));
+            switch (tag->type()) {
+            case TagType::Id3v1Tag:
+                static_cast<Id3v1Tag *>(tag)->make(stream, diag);
+                break;
+            case TagType::Id3v2Tag:
+                static_cast<Id3v2Tag *>(tag)->prepareMaking(diag).make(stream, 0, diag);
+                break;
+            case TagType::Mp4Tag:
+                static_cast<Mp4Tag *>(tag)->prepareMaking(diag).make(stream, diag);
+                break;
+            case TagType::MatroskaTag:
+                static_cast<MatroskaTag *>(tag)->prepareMaking(diag).make(stream);
+                break;
+            case TagType::VorbisComment:
+            case TagType::OggVorbisComment:
+                static_cast<VorbisComment *>(tag)->make(stream, VorbisCommentFlags::None, diag);
+                break;
+            default:
+                // note: Other tag formats are not written by the tag parser anyways.
+                break;
+            }
+        }
+    } catch (const TagParser::Failure &) {
+        return std::nullopt;
+    }
+    if (!stream) {
+        return std::nullopt;
+    }
+    for (const auto *const track : fileInfo.tracks()) {
+        buffer.add(track->id());
+        buffer.add(track->name());
+        buffer.add(static_cast<std::uint64_t>(track->locale().size()));
+        for (const auto &detail : track->locale()) {
+            buffer.add(std::string_view(detail));
+        }
+        buffer.add(track->trackNumber());
+        buffer.add(static_cast<std::uint8_t>(track->isEnabled() | (track->isForced() << 1) | (track->isDefault() << 2)));
+    }
+    if (const auto *const container = fileInfo.container()) {
+        for (const auto &title : container->titles()) {
+            buffer.add(title);
+        }
+    }
+    return buffer.hash();
+}
+
+} // namespace Cli
@@ -0,0 +1,17 @@
+#ifndef CLI_CHANGEDETECTION
+#define CLI_CHANGEDETECTION
+
+#include <cstdint>
+#include <optional>
+
+namespace TagParser {
+class MediaFileInfo;
+}
+
+namespace Cli {
+
+std::optional<std::uint64_t> computeMetaDataFingerprint(TagParser::MediaFileInfo &fileInfo);
+
+} // namespace Cli
+
+#endif // CLI_CHANGEDETECTION
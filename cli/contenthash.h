@@ -0,0 +1,28 @@
+#ifndef CLI_CONTENTHASH
+#define CLI_CONTENTHASH
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Cli {
+
+/*!
+ * \brief The initial value for computeContentHash() (the FNV-1a offset basis).
+ */
+constexpr std::uint64_t contentHashBasis = 0xcbf29ce484222325ull;
+
+/*!
+ * \brief Returns the FNV-1a hash of the specified \a data.
+ * \remarks Pass the previously returned value as \a hash to continue hashing, e.g. when the data is written in chunks.
+ */
+inline std::uint64_t computeContentHash(const char *data, std::size_t size, std::uint64_t hash = contentHashBasis)
+{
+    for (const auto *const end = data + size; data != end; ++data) {
+        hash = (hash ^ static_cast<unsigned char>(*data)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+} // namespace Cli
+
+#endif // CLI_CONTENTHASH
@@ -0,0 +1,51 @@
+#ifndef CLI_COUNTINGSTREAMBUFFER
+#define CLI_COUNTINGSTREAMBUFFER
+
+#include <cstdint>
+#include <ios>
+#include <streambuf>
+
+namespace Cli {
+
+/*!
+ * \brief The CountingStreamBuffer class discards everything written to it but counts the number of bytes.
+ * \remarks
+ * - Used to examine tags which can only be serialized to a stream without buffering them. The diagnostic messages emitted
+ *   when serializing are supposed to be discarded because the same messages are emitted when actually applying the changes.
+ * - Derived classes may override xsputn() to examine the written bytes as overflow() forwards single bytes to it. The
+ *   overriding function must invoke CountingStreamBuffer::xsputn() as well.
+ */
+class CountingStreamBuffer : public std::streambuf {
+public:
+    std::uint64_t count() const
+    {
+        return m_count;
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            const auto byte = traits_type::to_char_type(c);
+            xsputn(&byte, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char *, std::streamsize count) override
+    {
+        m_count += static_cast<std::uint64_t>(count);
+        return count;
+    }
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        return !off && dir == std::ios_base::cur && (which & std::ios_base::out) ? pos_type(static_cast<off_type>(m_count))
+                                                                                 : pos_type(off_type(-1));
+    }
+
+private:
+    std::uint64_t m_count = 0;
+};
+
+} // namespace Cli
+
+#endif // CLI_COUNTINGSTREAMBUFFER
@@ -0,0 +1,140 @@
+#include "./covercache.h"
+
+#include <tagparser/diagnostics.h>
+#include <tagparser/mediafileinfo.h>
+#include <tagparser/progressfeedback.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \brief Returns a TagValue of the specified \a dataType holding a copy of the cached contents and the MIME type.
+ * \remarks A TagValue always owns its data so copying the contents (in memory) can not be avoided here.
+ */
+TagValue CachedCover::toTagValue(TagDataType dataType) const
+{
+    auto value = TagValue(data.get(), size, dataType, TagTextEncoding::Utf8);
+    value.setMimeType(mimeType);
+    return value;
+}
+
+/*!
+ * \brief Returns the contents of the file at the specified \a path reading the file only if not done so before.
+ * \remarks Throws TagParser::Failure if the MIME type can not be determined and std::ios_base::failure if an IO error
+ *          occurs (like MediaFileInfo does).
+ */
+std::shared_ptr<const CachedCover> CoverCache::get(std::string_view path)
+{
+    auto slot = std::shared_ptr<Slot>();
+    auto key = std::string(path);
+    {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        ++m_requests;
+        slot = m_slotsByPath.slot(key);
+    }
+    // read the file outside of the lock so different files can be read concurrently (std::call_once will let the next
+    // thread try again if reading throws)
+    std::call_once(slot->loaded, [&] { slot->cover = read(key); });
+    cache(key, slot);
+    return slot->cover;
+}
+
+/*!
+ * \brief Marks the loaded \a slot for the specified \a path as most recently used and drops the least recently used slots
+ *        if the cache exceeds maxBytes().
+ * \remarks Slots which have already been dropped (by another thread) are not added again; the cover is still returned.
+ */
+void CoverCache::cache(const std::string &path, const std::shared_ptr<Slot> &slot)
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    auto evictedHashes = std::vector<std::uint64_t>();
+    // note: Contents shared by multiple paths are accounted for each path so the bound is conservative.
+    m_slotsByPath.markUsed(path, slot, slot->cover->size, [&](const Slot &evicted) { evictedHashes.emplace_back(evicted.cover->hash); });
+    // forget the contents of dropped slots for deduplication as well unless they are still in use
+    for (const auto hash : evictedHashes) {
+        for (auto [i, end] = m_coversByHash.equal_range(hash); i != end;) {
+            i = i->second.expired() ? m_coversByHash.erase(i) : std::next(i);
+        }
+    }
+}
+
+/*!
+ * \brief Returns how many files have actually been read.
+ */
+std::size_t CoverCache::filesRead() const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    return m_filesRead;
+}
+
+/*!
+ * \brief Returns how many times contents have been requested via get().
+ */
+std::size_t CoverCache::requests() const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    return m_requests;
+}
+
+/*!
+ * \brief Returns the total size of the files currently cached.
+ */
+std::size_t CoverCache::cachedBytes() const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    return m_slotsByPath.bytes();
+}
+
+/*!
+ * \brief Returns the max. total size of the cached files.
+ */
+std::size_t CoverCache::maxBytes() const
+{
+    return m_slotsByPath.maxBytes();
+}
+
+/*!
+ * \brief Reads the file at the specified \a path and determines its MIME type.
+ * \remarks Returns a previously read cover with the same contents if there is one.
+ */
+std::shared_ptr<const CachedCover> CoverCache::read(const std::string &path)
+{
+    auto coverFileInfo = MediaFileInfo(path);
+    auto coverDiag = Diagnostics();
+    auto coverProgress = AbortableProgressFeedback();
+    coverFileInfo.open(true);
+    coverFileInfo.parseContainerFormat(coverDiag, coverProgress);
+    auto cover = std::make_shared<CachedCover>();
+    cover->size = static_cast<std::size_t>(coverFileInfo.size());
+    cover->data = make_unique<char[]>(cover->size);
+    coverFileInfo.stream().seekg(static_cast<streamoff>(0));
+    coverFileInfo.stream().read(cover->data.get(), static_cast<streamoff>(cover->size));
+    cover->mimeType = coverFileInfo.mimeType();
+    cover->hash = computeContentHash(cover->data.get(), cover->size);
+
+    // use the cover read before if the contents are identical (e.g. the same picture has been stored under different paths)
+    // and it is still in use (covers which are not in use anymore are forgotten)
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    ++m_filesRead;
+    for (auto [i, end] = m_coversByHash.equal_range(cover->hash); i != end;) {
+        const auto existingCover = i->second.lock();
+        if (!existingCover) {
+            i = m_coversByHash.erase(i);
+            continue;
+        }
+        if (existingCover->size == cover->size && existingCover->mimeType == cover->mimeType
+            && !std::memcmp(existingCover->data.get(), cover->data.get(), cover->size)) {
+            return existingCover;
+        }
+        ++i;
+    }
+    m_coversByHash.emplace(cover->hash, cover);
+    return cover;
+}
+
+} // namespace Cli
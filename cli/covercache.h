@@ -0,0 +1,84 @@
+#ifndef CLI_COVERCACHE
+#define CLI_COVERCACHE
+
+#include "./contenthash.h"
+#include "./lrucache.h"
+
+#include <tagparser/tagvalue.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Cli {
+
+/*!
+ * \brief The CachedCover struct holds the contents of a file denoted as field value (usually a cover) and its MIME type.
+ */
+struct CachedCover {
+    TagParser::TagValue toTagValue(TagParser::TagDataType dataType) const;
+
+    std::unique_ptr<char[]> data;
+    std::size_t size = 0;
+    std::string mimeType;
+    std::uint64_t hash = 0;
+};
+
+/*!
+ * \brief The CoverCache class reads files denoted as field values (e.g. "cover=/path/to/front.jpg") only once per run.
+ *
+ * Each file is read and its MIME type determined when it is requested for the first time. Further requests (for the same
+ * or other files and tag formats) just return the cached contents. Files with identical contents are only kept once in
+ * memory as the cache is content-addressed.
+ *
+ * \remarks
+ * - get() may be invoked from multiple threads. Only the thread requesting a file first reads it; other threads requesting
+ *   the same file wait for it.
+ * - Files are assumed to remain unchanged during the run.
+ * - Failures are not cached so they are reported for each file the value is supposed to be set for.
+ * - The cache is bounded by the total size of the cached files (see maxBytes()). When exceeded, the least recently requested
+ *   files are dropped from the cache and read again if requested again. Contents handed out before remain valid.
+ */
+class CoverCache {
+public:
+    static constexpr std::size_t defaultMaxBytes = 64 * 1024 * 1024;
+
+    explicit CoverCache(std::size_t maxBytes = defaultMaxBytes);
+    std::shared_ptr<const CachedCover> get(std::string_view path);
+    std::size_t filesRead() const;
+    std::size_t requests() const;
+    std::size_t maxBytes() const;
+    std::size_t cachedBytes() const;
+
+private:
+    struct Slot {
+        std::once_flag loaded;
+        std::shared_ptr<const CachedCover> cover;
+    };
+
+    std::shared_ptr<const CachedCover> read(const std::string &path);
+    void cache(const std::string &path, const std::shared_ptr<Slot> &slot);
+
+    LruCache<std::string, Slot> m_slotsByPath;
+    std::unordered_multimap<std::uint64_t, std::weak_ptr<const CachedCover>> m_coversByHash;
+    mutable std::mutex m_mutex;
+    std::size_t m_filesRead = 0;
+    std::size_t m_requests = 0;
+};
+
+/*!
+ * \brief Constructs a new cache keeping at most \a maxBytes of file contents.
+ * \remarks A file bigger than \a maxBytes is still cached until the next file is requested.
+ */
+inline CoverCache::CoverCache(std::size_t maxBytes)
+    : m_slotsByPath(maxBytes)
+{
+}
+
+} // namespace Cli
+
+#endif // CLI_COVERCACHE
@@ -0,0 +1,314 @@
+#include "./covernormalizer.h"
+
+#include <tagparser/id3/id3v2tag.h>
+#include <tagparser/mp4/mp4tag.h>
+#include <tagparser/tagvalue.h>
+#include <tagparser/vorbis/vorbiscomment.h>
+
+#include <c++utilities/application/argumentparser.h>
+#include <c++utilities/application/global.h>
+#include <c++utilities/conversion/conversionexception.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#if defined(TAGEDITOR_GUI_QTWIDGETS) || defined(TAGEDITOR_GUI_QTQUICK)
+#include <QBuffer>
+#include <QByteArray>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QMimeDatabase>
+#include <QMimeType>
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \brief Returns the format name Qt uses for the specified \a format (e.g. "jpeg" for "JPG").
+ */
+static std::string normalizedFormatName(std::string_view format)
+{
+    auto name = std::string(format);
+    for (auto &c : name) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return name == "jpg" ? std::string("jpeg") : name;
+}
+
+#if defined(TAGEDITOR_GUI_QTWIDGETS) || defined(TAGEDITOR_GUI_QTQUICK)
+/*!
+ * \brief Returns the MIME type for the specified Qt image \a format (e.g. "image/tiff" for "tif").
+ * \remarks The format name is not necessarily the MIME subtype so the MIME type is looked up via the usual file extension.
+ *          Returns "application/octet-stream" if the format is unknown.
+ */
+static std::string mimeTypeForFormat(const std::string &format)
+{
+    return QMimeDatabase()
+        .mimeTypeForFile(QStringLiteral("cover.") + QString::fromStdString(format), QMimeDatabase::MatchExtension)
+        .name()
+        .toStdString();
+}
+#endif
+
+/*!
+ * \brief Parses the settings specified via --cover-max-size, --cover-format and --cover-quality.
+ * \remarks Exits the application if the specified values are invalid or cover normalization is not supported.
+ */
+CoverNormalizationSettings CoverNormalizationSettings::fromArgs(const Argument &maxSizeArg, const Argument &formatArg, const Argument &qualityArg)
+{
+    auto settings = CoverNormalizationSettings();
+    if (maxSizeArg.isPresent() && !maxSizeArg.values().empty()) {
+        const auto *const value = maxSizeArg.values().front();
+        const auto parts = splitStringSimple<std::vector<std::string_view>>(value, "x", 2);
+        try {
+            if (parts.size() != 2) {
+                throw ConversionException("width and height must be separated by \"x\"");
+            }
+            settings.maxWidth = stringToNumber<unsigned int>(parts[0]);
+            settings.maxHeight = stringToNumber<unsigned int>(parts[1]);
+            if (!settings.maxWidth || !settings.maxHeight) {
+                throw ConversionException("width and height must not be zero");
+            }
+        } catch (const ConversionException &e) {
+            cerr << Phrases::Error << "The specified maximum cover size \"" << value << "\" is invalid: " << e.what() << Phrases::End
+                 << "note: Specify the size as \"<width>x<height>\", e.g. \"1000x1000\"." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (formatArg.isPresent() && !formatArg.values().empty()) {
+        settings.format = normalizedFormatName(formatArg.values().front());
+    }
+    if (qualityArg.isPresent() && !qualityArg.values().empty()) {
+        try {
+            settings.quality = stringToNumber<int>(qualityArg.values().front());
+            if (settings.quality < 0 || settings.quality > 100) {
+                throw ConversionException("the quality must be within 0 and 100");
+            }
+        } catch (const ConversionException &e) {
+            cerr << Phrases::Error << "The specified cover quality \"" << qualityArg.values().front() << "\" is invalid: " << e.what()
+                 << Phrases::EndFlush;
+            exit(EXIT_FAILURE);
+        }
+        if (!settings.isEnabled()) {
+            cerr << Phrases::Warning << "The specified cover quality has no effect without --cover-max-size or --cover-format." << Phrases::EndFlush;
+        }
+    }
+    if (!settings.isEnabled()) {
+        return settings;
+    }
+    if (!CoverNormalizer::isSupported()) {
+        cerr << Phrases::Error << "Normalizing covers has been requested but support for this has been disabled at compile-time." << Phrases::End
+             << "note: The tag editor needs to be built with Qt GUI for this." << endl;
+        exit(EXIT_FAILURE);
+    }
+#if defined(TAGEDITOR_GUI_QTWIDGETS) || defined(TAGEDITOR_GUI_QTQUICK)
+    if (!settings.format.empty() && !QImageWriter::supportedImageFormats().contains(QByteArray(settings.format.data()))) {
+        cerr << Phrases::Error << "The specified cover format \"" << settings.format << "\" is not supported." << Phrases::End
+             << "note: Supported formats are:";
+        for (const auto &format : QImageWriter::supportedImageFormats()) {
+            cerr << ' ' << format.data();
+        }
+        cerr << endl;
+        exit(EXIT_FAILURE);
+    }
+#endif
+    return settings;
+}
+
+/*!
+ * \brief Constructs a new normalizer keeping converted pictures of at most \a maxBytes in total.
+ */
+CoverNormalizer::CoverNormalizer(const CoverNormalizationSettings &settings, std::size_t maxBytes)
+    : m_settings(settings)
+    , m_slotsByHash(maxBytes)
+    , m_conversions(0)
+{
+}
+
+/*!
+ * \brief Returns whether normalizing covers is supported by the current build.
+ */
+bool CoverNormalizer::isSupported()
+{
+#if defined(TAGEDITOR_GUI_QTWIDGETS) || defined(TAGEDITOR_GUI_QTQUICK)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*!
+ * \brief Normalizes the cover fields of the specified \a tag.
+ */
+template <class ConcreteTag> static void normalizeCoverFields(CoverNormalizer &normalizer, ConcreteTag *tag, CoverNormalizationStatistics &statistics)
+{
+    const auto range = tag->fields().equal_range(tag->fieldId(KnownField::Cover));
+    for (auto i = range.first; i != range.second; ++i) {
+        normalizer.normalize(i->second.value(), statistics);
+    }
+}
+
+/*!
+ * \brief Normalizes all covers of the specified \a tag (the ones already present as well as the ones which have just been set).
+ * \remarks Only ID3v2 tags, MP4 tags and Vorbis Comments are considered (other tag formats can not contain covers or store them
+ *          as attachments).
+ */
+void CoverNormalizer::normalize(Tag *tag, CoverNormalizationStatistics &statistics)
+{
+    switch (tag->type()) {
+    case TagType::Id3v2Tag:
+        normalizeCoverFields(*this, static_cast<Id3v2Tag *>(tag), statistics);
+        break;
+    case TagType::Mp4Tag:
+        normalizeCoverFields(*this, static_cast<Mp4Tag *>(tag), statistics);
+        break;
+    case TagType::VorbisComment:
+    case TagType::OggVorbisComment:
+        normalizeCoverFields(*this, static_cast<VorbisComment *>(tag), statistics);
+        break;
+    default:;
+    }
+}
+
+/*!
+ * \brief Normalizes the picture held by the specified \a value.
+ * \returns Returns whether the value has been altered.
+ */
+bool CoverNormalizer::normalize(TagValue &value, CoverNormalizationStatistics &statistics)
+{
+    const auto size = static_cast<std::size_t>(value.dataSize());
+    if (value.isEmpty() || !size) {
+        return false;
+    }
+
+    // convert the picture unless it has been converted before
+    // note: The size is mixed into the key and checked as well to make collisions of the (non-cryptographic) hash even less likely.
+    const auto *const data = value.dataPointer();
+    const auto key = computeContentHash(data, size) ^ (static_cast<std::uint64_t>(size) * 0x9e3779b97f4a7c15ull);
+    auto slot = std::shared_ptr<Slot>();
+    {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        slot = m_slotsByHash.slot(key);
+    }
+    std::call_once(slot->converted, [&] {
+        slot->originalSize = size;
+        slot->cover = convert(data, size);
+    });
+    {
+        // account the slot itself as well so the number of pictures which do not need to be converted is bounded as well
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        m_slotsByHash.markUsed(key, slot, sizeof(Slot) + (slot->cover ? slot->cover->size : 0), [](const Slot &) {});
+    }
+    const auto cover = slot->originalSize == size ? slot->cover : convert(data, size);
+    if (!cover) {
+        return false;
+    }
+
+    // replace the picture (keeping the description and the type info of the field)
+    statistics.covers += 1;
+    statistics.bytesBefore += size;
+    statistics.bytesAfter += cover->size;
+    value.assignData(cover->data.get(), cover->size, value.type(), value.dataEncoding());
+    value.setMimeType(cover->mimeType);
+    return true;
+}
+
+/*!
+ * \brief Returns how many pictures have actually been re-encoded.
+ */
+std::size_t CoverNormalizer::conversions() const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    return m_conversions;
+}
+
+/*!
+ * \brief Returns the max. total size of the converted pictures kept for re-use.
+ */
+std::size_t CoverNormalizer::maxBytes() const
+{
+    return m_slotsByHash.maxBytes();
+}
+
+/*!
+ * \brief Converts the specified picture according to the settings.
+ * \returns Returns the converted picture or nullptr if the picture does not need to be converted or can not be converted.
+ */
+std::shared_ptr<const CachedCover> CoverNormalizer::convert(const char *data, std::size_t size)
+{
+#if defined(TAGEDITOR_GUI_QTWIDGETS) || defined(TAGEDITOR_GUI_QTQUICK)
+    // determine the format and size of the picture without decoding it so compliant pictures are skipped quickly
+    auto input = QByteArray::fromRawData(data, static_cast<decltype(QByteArray().size())>(size));
+    auto inputBuffer = QBuffer(&input);
+    if (!inputBuffer.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    auto reader = QImageReader(&inputBuffer);
+    const auto sourceFormat = normalizedFormatName(reader.format().toStdString());
+    if (sourceFormat.empty()) {
+        return nullptr; // not a picture Qt can read
+    }
+    const auto &targetFormat = m_settings.format.empty() ? sourceFormat : m_settings.format;
+    const auto exceedsMaxSize = [this](const QSize &size) {
+        return m_settings.maxWidth && m_settings.maxHeight
+            && (static_cast<unsigned int>(size.width()) > m_settings.maxWidth || static_cast<unsigned int>(size.height()) > m_settings.maxHeight);
+    };
+    const auto sourceSize = reader.size();
+    if (sourceSize.isValid() && !exceedsMaxSize(sourceSize) && targetFormat == sourceFormat) {
+        return nullptr;
+    }
+
+    // decode, scale and encode the picture
+    auto image = reader.read();
+    if (image.isNull()) {
+        return nullptr;
+    }
+    const auto needsScaling = exceedsMaxSize(image.size());
+    if (!needsScaling && targetFormat == sourceFormat) {
+        return nullptr;
+    }
+    if (needsScaling) {
+        image = image.scaled(static_cast<int>(m_settings.maxWidth), static_cast<int>(m_settings.maxHeight), Qt::KeepAspectRatio,
+            Qt::SmoothTransformation);
+    }
+    auto output = QByteArray();
+    auto outputBuffer = QBuffer(&output);
+    if (!outputBuffer.open(QIODevice::WriteOnly)) {
+        return nullptr;
+    }
+    auto writer = QImageWriter(&outputBuffer, QByteArray(targetFormat.data()));
+    writer.setQuality(m_settings.quality);
+    if (!writer.write(image)) {
+        return nullptr;
+    }
+    {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        ++m_conversions;
+    }
+
+    auto cover = std::make_shared<CachedCover>();
+    cover->size = static_cast<std::size_t>(output.size());
+    cover->data = std::make_unique<char[]>(cover->size);
+    std::memcpy(cover->data.get(), output.data(), cover->size);
+    cover->mimeType = mimeTypeForFormat(targetFormat);
+    cover->hash = computeContentHash(cover->data.get(), cover->size);
+    return cover;
+#else
+    CPP_UTILITIES_UNUSED(data);
+    CPP_UTILITIES_UNUSED(size);
+    return nullptr;
+#endif
+}
+
+} // namespace Cli
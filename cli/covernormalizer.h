@@ -0,0 +1,122 @@
+#ifndef CLI_COVERNORMALIZER
+#define CLI_COVERNORMALIZER
+
+#include "./covercache.h"
+#include "./lrucache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace CppUtilities {
+class Argument;
+}
+
+namespace TagParser {
+class Tag;
+class TagValue;
+} // namespace TagParser
+
+namespace Cli {
+
+/*!
+ * \brief The CoverNormalizationSettings struct specifies how covers are supposed to be normalized.
+ */
+struct CoverNormalizationSettings {
+    static CoverNormalizationSettings fromArgs(
+        const CppUtilities::Argument &maxSizeArg, const CppUtilities::Argument &formatArg, const CppUtilities::Argument &qualityArg);
+    bool isEnabled() const;
+
+    unsigned int maxWidth = 0;
+    unsigned int maxHeight = 0;
+    std::string format;
+    int quality = -1;
+};
+
+/*!
+ * \brief Returns whether covers are supposed to be normalized at all.
+ * \remarks The quality is only taken into account when a cover needs to be re-encoded anyways.
+ */
+inline bool CoverNormalizationSettings::isEnabled() const
+{
+    return (maxWidth && maxHeight) || !format.empty();
+}
+
+/*!
+ * \brief The CoverNormalizationStatistics struct holds the number of normalized covers and their size before and after.
+ */
+struct CoverNormalizationStatistics {
+    void add(const CoverNormalizationStatistics &other);
+    std::uint64_t bytesSaved() const;
+
+    std::size_t covers = 0;
+    std::uint64_t bytesBefore = 0;
+    std::uint64_t bytesAfter = 0;
+};
+
+/*!
+ * \brief Adds the figures of \a other.
+ */
+inline void CoverNormalizationStatistics::add(const CoverNormalizationStatistics &other)
+{
+    covers += other.covers;
+    bytesBefore += other.bytesBefore;
+    bytesAfter += other.bytesAfter;
+}
+
+/*!
+ * \brief Returns the number of bytes saved (or zero if the covers have grown).
+ */
+inline std::uint64_t CoverNormalizationStatistics::bytesSaved() const
+{
+    return bytesBefore > bytesAfter ? bytesBefore - bytesAfter : 0;
+}
+
+/*!
+ * \brief The CoverNormalizer class resizes and re-encodes covers according to the specified CoverNormalizationSettings.
+ *
+ * Covers which already comply with the settings (not exceeding the maximum size and already using the requested format) are
+ * left as-is, so normalizing covers again does not alter them (and therefore does not lead to rewriting files).
+ *
+ * Results are cached by the hash of the original picture so each distinct picture is only decoded and encoded once per run, no
+ * matter how many files it is embedded in (or set for). The cache is bounded by the total size of the converted pictures (see
+ * maxBytes()). When exceeded, the least recently encountered pictures are dropped from the cache and converted again if
+ * encountered again.
+ *
+ * \remarks
+ * - normalize() may be invoked from multiple threads. Only the thread encountering a picture first converts it; other threads
+ *   encountering the same picture wait for the result.
+ * - Requires Qt's image I/O so it is only supported if the tag editor has been built with Qt GUI.
+ */
+class CoverNormalizer {
+public:
+    static constexpr std::size_t defaultMaxBytes = 64 * 1024 * 1024;
+
+    explicit CoverNormalizer(const CoverNormalizationSettings &settings, std::size_t maxBytes = defaultMaxBytes);
+
+    static bool isSupported();
+    void normalize(TagParser::Tag *tag, CoverNormalizationStatistics &statistics);
+    bool normalize(TagParser::TagValue &value, CoverNormalizationStatistics &statistics);
+    std::size_t conversions() const;
+    std::size_t maxBytes() const;
+
+private:
+    struct Slot {
+        std::once_flag converted;
+        std::shared_ptr<const CachedCover> cover;
+        std::size_t originalSize = 0;
+    };
+
+    std::shared_ptr<const CachedCover> convert(const char *data, std::size_t size);
+
+    CoverNormalizationSettings m_settings;
+    LruCache<std::uint64_t, Slot> m_slotsByHash;
+    mutable std::mutex m_mutex;
+    std::size_t m_conversions;
+};
+
+} // namespace Cli
+
+#endif // CLI_COVERNORMALIZER
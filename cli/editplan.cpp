@@ -0,0 +1,199 @@
+#include "./editplan.h"
+
+#include <c++utilities/conversion/conversionexception.h>
+#include <c++utilities/conversion/stringconversion.h>
+
+#include <iterator>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+
+namespace Cli {
+
+/// \brief The tag types the fields are indexed for (the tag types the tag parser can write).
+static constexpr TagType indexedTagTypes[] = {
+    TagType::Id3v1Tag,
+    TagType::Id3v2Tag,
+    TagType::Mp4Tag,
+    TagType::MatroskaTag,
+    TagType::VorbisComment,
+    TagType::OggVorbisComment,
+};
+
+/// \brief The text encodings values are converted to upfront (indexed via their numeric value).
+static constexpr TagTextEncoding convertedEncodings[] = {
+    TagTextEncoding::Latin1,
+    TagTextEncoding::Utf8,
+    TagTextEncoding::Utf16LittleEndian,
+    TagTextEncoding::Utf16BigEndian,
+};
+
+/*!
+ * \brief Returns the text of the value for the file the value has been selected for.
+ * \remarks Applies the increment if the value has been denoted via "+=".
+ */
+std::string EditPlan::Value::text(unsigned int selectedFileIndex) const
+{
+    auto res = value;
+    if (type == DenotationType::Increment && !res.empty()) {
+        for (auto i = fileIndex, end = singleFile ? fileIndex : selectedFileIndex; i < end; ++i) {
+            res = incremented(res);
+        }
+    }
+    return res;
+}
+
+/*!
+ * \brief Returns the value for the file the value has been selected for as TagValue using the specified \a encoding.
+ * \remarks Throws ConversionException if the value can not be converted to the specified \a encoding.
+ */
+TagValue EditPlan::Value::toTagValue(unsigned int selectedFileIndex, TagTextEncoding encoding) const
+{
+    const auto encodingIndex = static_cast<std::size_t>(encoding);
+    if (encodingIndex < convertedValues.size() && convertedValues[encodingIndex].has_value()) {
+        return convertedValues[encodingIndex].value();
+    }
+    return TagValue(text(selectedFileIndex), TagTextEncoding::Utf8, encoding);
+}
+
+/*!
+ * \brief Compiles the plan for the specified \a fields.
+ * \remarks The values of \a overrides (e.g. the values of a manifest record) take precedence over the values of \a fields
+ *          with the same scope and are selected as if only a single file had been specified.
+ */
+EditPlan::EditPlan(const FieldDenotations &fields, std::string_view coverTypeDelimiter, const FieldDenotations *overrides)
+{
+    m_fields.reserve(fields.size() + (overrides ? overrides->size() : 0));
+    for (const auto &[scope, values] : fields) {
+        if (!overrides || overrides->find(scope) == overrides->end()) {
+            addField(scope, values, false, coverTypeDelimiter);
+        }
+    }
+    if (overrides) {
+        for (const auto &[scope, values] : *overrides) {
+            addField(scope, values, true, coverTypeDelimiter);
+        }
+    }
+
+    // index the fields by tag type
+    for (auto i = std::size_t(); i != m_fields.size(); ++i) {
+        const auto &scope = m_fields[i].scope;
+        if (scope.isTrack()) {
+            m_trackFields.emplace_back(i);
+            continue;
+        }
+        m_tagFields.emplace_back(i);
+        if (scope.tagType == TagType::Unspecified) {
+            m_untypedTagFields.emplace_back(i);
+        }
+    }
+    m_fieldsByTagType.reserve(std::size(indexedTagTypes));
+    for (const auto tagType : indexedTagTypes) {
+        auto &fieldsForTagType = m_fieldsByTagType.emplace_back(tagType, std::vector<std::size_t>()).second;
+        for (const auto i : m_tagFields) {
+            const auto denotedTagType = m_fields[i].scope.tagType;
+            if (denotedTagType == TagType::Unspecified || (denotedTagType & tagType)) {
+                fieldsForTagType.emplace_back(i);
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Returns the indexes of the fields which might be relevant for tags of the specified \a tagType.
+ * \remarks
+ * - The target of the tag still needs to be checked.
+ * - Only fields without tag type are returned for tag types which are not indexed. This is sufficient as field denotations
+ *   can only refer to the indexed tag types.
+ */
+const std::vector<std::size_t> &EditPlan::fieldsForTagType(TagType tagType) const
+{
+    for (const auto &[indexedTagType, fields] : m_fieldsByTagType) {
+        if (indexedTagType == tagType) {
+            return fields;
+        }
+    }
+    return m_untypedTagFields;
+}
+
+/*!
+ * \brief Selects the values relevant for the file with the specified \a fileIndex.
+ *
+ * The relevant values of a field are the ones denoted for the greatest file index less than or equal to \a fileIndex. So
+ * values which have been denoted without file index apply to all files unless values have been denoted specifically
+ * for the file.
+ */
+void EditPlan::select(unsigned int fileIndex, Selection &selection) const
+{
+    selection.resize(m_fields.size());
+    for (auto i = std::size_t(); i != m_fields.size(); ++i) {
+        const auto &field = m_fields[i];
+        const auto selectedFileIndex = field.singleFile ? 0u : fileIndex;
+        auto &relevantValues = selection[i];
+        auto currentFileIndex = 0u;
+        relevantValues.clear();
+        for (const auto &value : field.values) {
+            if (value.fileIndex <= selectedFileIndex && (relevantValues.empty() || value.fileIndex >= currentFileIndex)) {
+                if (currentFileIndex != value.fileIndex) {
+                    currentFileIndex = value.fileIndex;
+                    relevantValues.clear();
+                }
+                relevantValues.emplace_back(&value);
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Adds the field with the specified \a scope and \a values to the plan.
+ */
+void EditPlan::addField(const FieldScope &scope, const FieldValues &values, bool singleFile, std::string_view coverTypeDelimiter)
+{
+    auto &field = m_fields.emplace_back();
+    field.scope = scope;
+    field.singleFile = singleFile;
+    field.values.reserve(values.allValues.size());
+    for (const auto &denotedValue : values.allValues) {
+        auto &value = field.values.emplace_back();
+        value.type = denotedValue.type;
+        value.fileIndex = denotedValue.fileIndex;
+        value.singleFile = singleFile;
+        value.value = denotedValue.value;
+        if (value.value.empty()) {
+            continue;
+        }
+
+        // split the denotation of a file into path, cover type and description (taking a drive letter into account)
+        if (value.type == DenotationType::File) {
+            const auto firstPartIsDriveLetter = value.value.size() >= 2 && value.value[1] == ':' ? 1u : 0u;
+            const auto maxParts = std::size_t(3u + firstPartIsDriveLetter);
+            const auto parts
+                = splitStringSimple<std::vector<std::string_view>>(value.value, coverTypeDelimiter, static_cast<int>(maxParts));
+            if (!parts.empty()) {
+                value.path = firstPartIsDriveLetter ? std::string_view(value.value.data(), parts[0].size() + parts[1].size() + 1) : parts.front();
+            }
+            if (parts.size() > 1u + firstPartIsDriveLetter) {
+                value.coverType = parts[1 + firstPartIsDriveLetter];
+            }
+            if (parts.size() > 2u + firstPartIsDriveLetter) {
+                value.description = parts[2 + firstPartIsDriveLetter];
+            }
+            continue;
+        }
+
+        // convert text values to all encodings upfront unless they are incremented per file
+        // note: Conversion errors are not cached; they are reported when the value is actually used.
+        if (value.type == DenotationType::Increment) {
+            continue;
+        }
+        for (const auto encoding : convertedEncodings) {
+            try {
+                value.convertedValues[static_cast<std::size_t>(encoding)].emplace(value.value, TagTextEncoding::Utf8, encoding);
+            } catch (const ConversionException &) {
+            }
+        }
+    }
+}
+
+} // namespace Cli
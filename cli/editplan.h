@@ -0,0 +1,88 @@
+#ifndef CLI_EDITPLAN
+#define CLI_EDITPLAN
+
+#include "./helper.h"
+
+#include <tagparser/tagvalue.h>
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Cli {
+
+/*!
+ * \brief The EditPlan class holds the field denotations of the set operation in a form which can be applied to many files cheaply.
+ *
+ * The plan is compiled once per run (and once per manifest record specifying values itself):
+ * - Text values are converted to a TagValue for each text encoding upfront (except values which are incremented per file).
+ * - Denotations of files (e.g. "cover=/path/to/file:front-cover:description") are split into their parts upfront.
+ * - The fields are indexed by tag type so only the fields which might be relevant for a tag need to be considered for it.
+ *
+ * The values relevant for a certain file are determined via select() which fills a Selection without copying any values.
+ *
+ * \remarks The plan is not modified after its construction so it can be used by multiple jobs concurrently.
+ */
+class EditPlan {
+public:
+    struct Value {
+        std::string text(unsigned int selectedFileIndex) const;
+        TagParser::TagValue toTagValue(unsigned int selectedFileIndex, TagParser::TagTextEncoding encoding) const;
+
+        DenotationType type = DenotationType::Normal;
+        unsigned int fileIndex = 0;
+        bool singleFile = false;
+        std::string value;
+        std::string path;
+        std::optional<std::string> coverType;
+        std::optional<std::string> description;
+        std::array<std::optional<TagParser::TagValue>, 4> convertedValues;
+    };
+    struct Field {
+        FieldScope scope;
+        std::vector<Value> values;
+        bool singleFile = false;
+    };
+    /// \brief The relevant values of a file for each field (indexed like fields()).
+    using Selection = std::vector<std::vector<const Value *>>;
+
+    explicit EditPlan(const FieldDenotations &fields, std::string_view coverTypeDelimiter, const FieldDenotations *overrides = nullptr);
+
+    const std::vector<Field> &fields() const;
+    const std::vector<std::size_t> &fieldsForTagType(TagParser::TagType tagType) const;
+    const std::vector<std::size_t> &trackFields() const;
+    void select(unsigned int fileIndex, Selection &selection) const;
+
+private:
+    void addField(const FieldScope &scope, const FieldValues &values, bool singleFile, std::string_view coverTypeDelimiter);
+
+    std::vector<Field> m_fields;
+    std::vector<std::pair<TagParser::TagType, std::vector<std::size_t>>> m_fieldsByTagType;
+    std::vector<std::size_t> m_tagFields;
+    std::vector<std::size_t> m_untypedTagFields;
+    std::vector<std::size_t> m_trackFields;
+};
+
+/*!
+ * \brief Returns all fields of the plan.
+ */
+inline const std::vector<EditPlan::Field> &EditPlan::fields() const
+{
+    return m_fields;
+}
+
+/*!
+ * \brief Returns the indexes of the fields which might be relevant for tracks.
+ */
+inline const std::vector<std::size_t> &EditPlan::trackFields() const
+{
+    return m_trackFields;
+}
+
+} // namespace Cli
+
+#endif // CLI_EDITPLAN
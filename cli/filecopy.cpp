@@ -0,0 +1,239 @@
+#include "./filecopy.h"
+
+#include <c++utilities/application/global.h>
+#include <c++utilities/conversion/stringbuilder.h>
+
+#if defined(PLATFORM_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(PLATFORM_LINUX)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ios>
+#include <limits>
+#include <memory>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+#if defined(PLATFORM_UNIX)
+/*!
+ * \brief The FileDescriptor class closes the wrapped file descriptor when being destroyed.
+ */
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd, bool owned = true)
+        : m_fd(fd)
+        , m_owned(owned)
+    {
+    }
+    ~FileDescriptor()
+    {
+        if (m_owned && m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+    FileDescriptor(const FileDescriptor &) = delete;
+    operator int() const
+    {
+        return m_fd;
+    }
+
+private:
+    int m_fd;
+    bool m_owned;
+};
+
+/*!
+ * \brief Throws an std::ios_base::failure for the last error prefixed with the specified \a message.
+ */
+[[noreturn]] static void throwLastError(const char *message, const char *path)
+{
+    const auto error = errno;
+    throw std::ios_base::failure(argsToString(message, " \"", path, "\": ", std::strerror(error)));
+}
+
+/*!
+ * \brief Writes \a size bytes from \a buffer to \a fd handling partial writes.
+ */
+static void writeAll(int fd, const char *buffer, std::size_t size, const char *targetPath)
+{
+    while (size) {
+        const auto written = ::write(fd, buffer, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwLastError("Unable to write to", targetPath);
+        }
+        buffer += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+#endif
+
+/*!
+ * \brief Copies \a size bytes starting at \a offset from the file at \a sourcePath to the file at \a targetPath.
+ *
+ * The data is copied by the kernel (via copy_file_range() or sendfile()) if possible so it does not have to pass user space
+ * at all. Otherwise it is copied in chunks via a small buffer. So the memory usage does not depend on \a size.
+ *
+ * \remarks
+ * - The target file is created or truncated. If \a targetPath is nullptr the data is written to stdout instead; stdout may be
+ *   a pipe in this case. The caller is responsible for flushing std::cout before.
+ * - Returns false if not supported on the current platform so the caller can fall back to copying via iostreams. In this case
+ *   neither file has been touched.
+ * - Throws std::ios_base::failure if an IO error occurs or if the source file ends before \a size bytes have been copied.
+ */
+bool copyFileRange(const char *sourcePath, std::uint64_t offset, std::uint64_t size, const char *targetPath)
+{
+#if defined(PLATFORM_UNIX)
+    const auto targetName = targetPath ? targetPath : "stdout";
+    if (offset > static_cast<std::uint64_t>(std::numeric_limits<off_t>::max())) {
+        throw std::ios_base::failure(argsToString("Offset of data within \"", sourcePath, "\" exceeds the supported range"));
+    }
+    const auto source = FileDescriptor(::open(sourcePath, O_RDONLY | O_CLOEXEC));
+    if (source < 0) {
+        throwLastError("Unable to open", sourcePath);
+    }
+    const auto target = targetPath ? FileDescriptor(::open(targetPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666))
+                                   : FileDescriptor(STDOUT_FILENO, false);
+    if (target < 0) {
+        throwLastError("Unable to open", targetName);
+    }
+
+    constexpr auto maxChunkSize = std::uint64_t(0x40000000);
+    auto sourceOffset = static_cast<off_t>(offset);
+    auto remaining = size;
+#if defined(PLATFORM_LINUX)
+    // copy_file_range() only works between regular files (and across file systems only as of Linux 5.3) and sendfile() does
+    // not support all combinations of file types either; just fall back to the next method when the kernel refuses or copies
+    // nothing (the buffered copy will report if the source file is actually too short)
+    for (auto useCopyFileRange = true; remaining && useCopyFileRange;) {
+        const auto copied = ::copy_file_range(source, &sourceOffset, target, nullptr, static_cast<std::size_t>(std::min(remaining, maxChunkSize)), 0);
+        if (copied > 0) {
+            remaining -= static_cast<std::uint64_t>(copied);
+        } else if (!copied) {
+            useCopyFileRange = false;
+        } else if (errno != EINTR) {
+            if (errno != EXDEV && errno != EINVAL && errno != ENOSYS && errno != EOPNOTSUPP && errno != EBADF) {
+                throwLastError("Unable to copy data to", targetName);
+            }
+            useCopyFileRange = false;
+        }
+    }
+    for (auto useSendfile = true; remaining && useSendfile;) {
+        const auto copied = ::sendfile(target, source, &sourceOffset, static_cast<std::size_t>(std::min(remaining, maxChunkSize)));
+        if (copied > 0) {
+            remaining -= static_cast<std::uint64_t>(copied);
+        } else if (!copied) {
+            useSendfile = false;
+        } else if (errno != EINTR) {
+            if (errno != EINVAL && errno != ENOSYS) {
+                throwLastError("Unable to copy data to", targetName);
+            }
+            useSendfile = false;
+        }
+    }
+#endif
+    if (!remaining) {
+        return true;
+    }
+    constexpr auto bufferSize = std::size_t(0x10000);
+    const auto buffer = std::make_unique<char[]>(bufferSize);
+    while (remaining) {
+        const auto bytesRead = ::pread(source, buffer.get(), static_cast<std::size_t>(std::min<std::uint64_t>(remaining, bufferSize)), sourceOffset);
+        if (bytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwLastError("Unable to read", sourcePath);
+        } else if (!bytesRead) {
+            throw std::ios_base::failure(argsToString("Unexpected end of file \"", sourcePath, '\"'));
+        }
+        writeAll(target, buffer.get(), static_cast<std::size_t>(bytesRead), targetName);
+        sourceOffset += bytesRead;
+        remaining -= static_cast<std::uint64_t>(bytesRead);
+    }
+    return true;
+#else
+    CPP_UTILITIES_UNUSED(sourcePath);
+    CPP_UTILITIES_UNUSED(offset);
+    CPP_UTILITIES_UNUSED(size);
+    CPP_UTILITIES_UNUSED(targetPath);
+    return false;
+#endif
+}
+
+/*!
+ * \brief Clones the file at \a sourcePath to \a targetPath sharing the data of both files until one of them is modified.
+ *
+ * This only works on file systems supporting reflinks (e.g. Btrfs and XFS) and takes constant time regardless of the file size
+ * because no data is copied at all. So the clone can be updated in-place afterwards to write a modified version of the source
+ * file with I/O proportional to the size of the modifications.
+ *
+ * \remarks
+ * - Returns false if cloning is not supported by the platform or file system (or if both files are on different file systems).
+ *   In this case the target file has not been created (or has been removed again). An existing target file might have been
+ *   truncated, though.
+ * - The target file is replaced if it already exists unless it is the source file itself.
+ * - Throws std::ios_base::failure if an IO error occurs.
+ */
+bool cloneFile(const char *sourcePath, const char *targetPath)
+{
+#if defined(PLATFORM_LINUX) && defined(FICLONE)
+    const auto source = FileDescriptor(::open(sourcePath, O_RDONLY | O_CLOEXEC));
+    if (source < 0) {
+        throwLastError("Unable to open", sourcePath);
+    }
+    // open the target file without truncating it (in case it is the source file itself)
+    auto created = true;
+    auto targetFd = ::open(targetPath, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    if (targetFd < 0 && errno == EEXIST) {
+        created = false;
+        targetFd = ::open(targetPath, O_WRONLY | O_CLOEXEC);
+    }
+    const auto target = FileDescriptor(targetFd);
+    if (target < 0) {
+        throwLastError("Unable to open", targetPath);
+    }
+    struct stat sourceStat, targetStat;
+    if (::fstat(source, &sourceStat) || ::fstat(target, &targetStat)) {
+        throwLastError("Unable to determine status of", targetPath);
+    }
+    if (sourceStat.st_dev == targetStat.st_dev && sourceStat.st_ino == targetStat.st_ino) {
+        return false;
+    }
+    if (::ftruncate(target, 0)) {
+        throwLastError("Unable to truncate", targetPath);
+    }
+    if (!::ioctl(target, FICLONE, static_cast<int>(source))) {
+        return true;
+    }
+    const auto error = errno;
+    if (created) {
+        ::unlink(targetPath);
+    }
+    if (error != EOPNOTSUPP && error != ENOTTY && error != EXDEV && error != EINVAL && error != ENOSYS && error != EPERM) {
+        errno = error;
+        throwLastError("Unable to clone file to", targetPath);
+    }
+    return false;
+#else
+    CPP_UTILITIES_UNUSED(sourcePath);
+    CPP_UTILITIES_UNUSED(targetPath);
+    return false;
+#endif
+}
+
+} // namespace Cli
@@ -0,0 +1,13 @@
+#ifndef CLI_FILECOPY
+#define CLI_FILECOPY
+
+#include <cstdint>
+
+namespace Cli {
+
+bool copyFileRange(const char *sourcePath, std::uint64_t offset, std::uint64_t size, const char *targetPath);
+bool cloneFile(const char *sourcePath, const char *targetPath);
+
+} // namespace Cli
+
+#endif // CLI_FILECOPY
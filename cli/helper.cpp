@@ -19,9 +19,11 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <csignal>
 #include <cstring>
 #include <iostream>
+#include <thread>
 
 using namespace std;
 using namespace std::placeholders;
@@ -514,6 +516,32 @@ std::uint64_t parseUInt64(const Argument &arg, std::uint64_t defaultValue)
     return defaultValue;
 }
 
+/*!
+ * \brief Returns the number of files to be processed in parallel as specified via \a jobsArg.
+ * \remarks Returns 1 if \a jobsArg is not present and the number of hardware threads if "0" or "auto" has been specified.
+ */
+std::size_t parseJobCount(const Argument &jobsArg)
+{
+    if (!jobsArg.isPresent() || jobsArg.values().empty()) {
+        return 1;
+    }
+    const auto *const value = jobsArg.values().front();
+    auto jobs = std::size_t();
+    if (strcmp(value, "auto")) {
+        try {
+            jobs = stringToNumber<std::size_t>(value);
+        } catch (const ConversionException &) {
+            cerr << Phrases::Error << "The specified number of jobs \"" << value << "\" is no valid unsigned integer." << Phrases::End
+                 << "note: Use \"auto\" or 0 to use one job per hardware thread." << endl;
+            exit(-1);
+        }
+    }
+    if (!jobs) {
+        jobs = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return jobs;
+}
+
 TagTarget::IdContainerType parseIds(std::string_view concatenatedIds)
 {
     const auto splittedIds = splitStringSimple(concatenatedIds, ",");
@@ -526,9 +554,7 @@ TagTarget::IdContainerType parseIds(std::string_view concatenatedIds)
         try {
             convertedIds.push_back(stringToNumber<TagTarget::IdType>(id));
         } catch (const ConversionException &) {
-            cerr << Phrases::Error << "The specified ID \"" << id << "\" is invalid." << Phrases::End << "note: IDs must be unsigned integers."
-                 << endl;
-            exit(-1);
+            throw InvalidDenotationException(argsToString("The specified ID \"", id, "\" is invalid."), "IDs must be unsigned integers.");
         }
     }
     return convertedIds;
@@ -541,9 +567,8 @@ bool applyTargetConfiguration(TagTarget &target, std::string_view configStr)
             try {
                 target.setLevel(stringToNumber<std::uint64_t>(configStr.substr(13)));
             } catch (const ConversionException &) {
-                cerr << Phrases::Error << "The specified target level \"" << configStr.substr(13) << "\" is invalid." << Phrases::End
-                     << "note: The target level must be an unsigned integer." << endl;
-                exit(-1);
+                throw InvalidDenotationException(argsToString("The specified target level \"", configStr.substr(13), "\" is invalid."),
+                    "The target level must be an unsigned integer.");
             }
         } else if (configStr.compare(0, 17, "target-levelname=") == 0) {
             target.setLevelName(std::string(configStr.substr(17)));
@@ -556,9 +581,8 @@ bool applyTargetConfiguration(TagTarget &target, std::string_view configStr)
         } else if (configStr.compare(0, 19, "target-attachments=") == 0) {
             target.attachments() = parseIds(configStr.substr(19));
         } else if (configStr.compare(0, 13, "target-reset=") == 0) {
-            if (*(configStr.data() + 13)) {
-                cerr << Phrases::Error << "Invalid assignment " << (configStr.data() + 13) << " for target-reset." << Phrases::EndFlush;
-                exit(-1);
+            if (configStr.size() > 13) {
+                throw InvalidDenotationException(argsToString("Invalid assignment ", configStr.substr(13), " for target-reset."));
             }
             target.clear();
         } else if (configStr == "target-reset") {
@@ -572,14 +596,39 @@ bool applyTargetConfiguration(TagTarget &target, std::string_view configStr)
     }
 }
 
+/*!
+ * \brief Prints the specified \a error and exits.
+ */
+void exitDueToInvalidDenotation(const InvalidDenotationException &error)
+{
+    cerr << Phrases::Error << error.what() << Phrases::End;
+    if (!error.note().empty()) {
+        cerr << "note: " << error.note() << '\n';
+    }
+    cerr.flush();
+    std::exit(-1);
+}
+
+/*!
+ * \brief Parses the field denotations specified via \a fieldsArg; exits if they are invalid.
+ */
 FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
 {
-    auto fields = FieldDenotations();
-    if (!fieldsArg.isPresent()) {
-        return fields;
+    try {
+        return fieldsArg.isPresent() ? parseFieldDenotations(fieldsArg.values(), readOnly) : FieldDenotations();
+    } catch (const InvalidDenotationException &e) {
+        exitDueToInvalidDenotation(e);
     }
+}
 
-    const std::vector<const char *> &fieldDenotations = fieldsArg.values();
+/*!
+ * \brief Parses the specified \a fieldDenotations (e.g. the values of the "set"-operation or a record of a manifest).
+ * \remarks Throws InvalidDenotationException if a denotation is invalid (instead of exiting as it might be invoked while
+ *          other files are being modified, e.g. when reading a manifest).
+ */
+FieldDenotations parseFieldDenotations(const std::vector<const char *> &fieldDenotations, bool readOnly)
+{
+    auto fields = FieldDenotations();
     auto scope = FieldScope();
 
     for (std::string_view fieldDenotationString : fieldDenotations) {
@@ -587,9 +636,8 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
         if (startsWith(fieldDenotationString, "tag=")) {
             const auto tagTypeString = fieldDenotationString.substr(4);
             if (tagTypeString.empty()) {
-                cerr << Phrases::Error << "The \"tag\"-specifier has been used with no value(s)." << Phrases::End
-                     << "note: Possible values are id3,id3v1,id3v2,itunes,vorbis,matroska and all." << endl;
-                std::exit(-1);
+                throw InvalidDenotationException("The \"tag\"-specifier has been used with no value(s).",
+                    "Possible values are id3,id3v1,id3v2,itunes,vorbis,matroska and all.");
             }
             auto tagType = TagType::Unspecified;
             for (const auto &part : splitStringSimple<std::vector<std::string_view>>(tagTypeString, ",")) {
@@ -612,9 +660,8 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
                     tagType = TagType::Unspecified;
                     break;
                 } else {
-                    cerr << Phrases::Error << "The value \"" << part << " for the \"tag\"-specifier is invalid." << Phrases::End
-                         << "note: Possible values are id3,id3v1,id3v2,itunes,vorbis,matroska and all." << endl;
-                    std::exit(-1);
+                    throw InvalidDenotationException(argsToString("The value \"", part, " for the \"tag\"-specifier is invalid."),
+                        "Possible values are id3,id3v1,id3v2,itunes,vorbis,matroska and all.");
                 }
             }
             scope.tagType = tagType;
@@ -645,9 +692,8 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
                 try {
                     trackIds.emplace_back(stringToNumber<std::uint64_t>(part));
                 } catch (const ConversionException &) {
-                    cerr << Phrases::Error << "The value provided with the \"track\"-specifier is invalid." << Phrases::End
-                         << "note: It must be a comma-separated list of track IDs." << endl;
-                    std::exit(-1);
+                    throw InvalidDenotationException(
+                        "The value provided with the \"track\"-specifier is invalid.", "It must be a comma-separated list of track IDs.");
                 }
             }
             scope.allTracks = allTracks;
@@ -686,8 +732,7 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
             fileIndex += static_cast<unsigned int>(fieldDenotationString[digitPos] - '0') * mult;
         }
         if (!fieldNameLen) {
-            cerr << Phrases::Error << "The field denotation \"" << fieldDenotationString << "\" has no field name." << Phrases::EndFlush;
-            exit(-1);
+            throw InvalidDenotationException(argsToString("The field denotation \"", fieldDenotationString, "\" has no field name."));
         }
 
         // parse the denoted field ID
@@ -699,9 +744,7 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
                 scope.field = FieldId::fromTagDenotation(fieldName);
             }
         } catch (const ConversionException &e) {
-            // unable to parse field ID denotation -> discard the field denotation
-            cerr << Phrases::Error << "The field denotation \"" << fieldName << "\" could not be parsed: " << e.what() << Phrases::EndFlush;
-            std::exit(-1);
+            throw InvalidDenotationException(argsToString("The field denotation \"", fieldName, "\" could not be parsed: ", e.what()));
         }
 
         // read cover always from file
@@ -714,9 +757,8 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
         // add value to the scope (if present)
         if (equationPos != std::string_view::npos) {
             if (readOnly) {
-                cerr << Phrases::Error << "A value has been specified for \"" << fieldName << "\"." << Phrases::End
-                     << "note: This is only possible when the \"set\"-operation is used." << endl;
-                std::exit(-1);
+                throw InvalidDenotationException(argsToString("A value has been specified for \"", fieldName, "\"."),
+                    "This is only possible when the \"set\"-operation is used.");
             } else {
                 // file index might have been specified explicitly
                 // if not (mult == 1) use the index of the last value and increase it by one if the value is not an additional one
@@ -727,9 +769,8 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
             }
         }
         if (additionalValue && readOnly) {
-            cerr << Phrases::Error << "Indication of an additional value for \"" << fieldName << "\" is invalid." << Phrases::End
-                 << "note: This is only possible when the \"set\"-operation is used." << endl;
-            std::exit(-1);
+            throw InvalidDenotationException(argsToString("Indication of an additional value for \"", fieldName, "\" is invalid."),
+                "This is only possible when the \"set\"-operation is used.");
         }
     }
     return fields;
@@ -15,6 +15,8 @@
 #include <c++utilities/misc/traits.h>
 
 #include <functional>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <type_traits>
 #include <unordered_map>
@@ -174,6 +176,30 @@ inline FieldValue::FieldValue(DenotationType type, unsigned int fileIndex, std::
 {
 }
 
+/*!
+ * \brief The InvalidDenotationException class is thrown when a denotation (e.g. a field denotation) is invalid.
+ * \remarks The note provides further information about valid denotations and might be empty.
+ */
+class InvalidDenotationException : public std::runtime_error {
+public:
+    explicit InvalidDenotationException(const std::string &message, std::string_view note = std::string_view());
+    const std::string &note() const;
+
+private:
+    std::string m_note;
+};
+
+inline InvalidDenotationException::InvalidDenotationException(const std::string &message, std::string_view note)
+    : std::runtime_error(message)
+    , m_note(note)
+{
+}
+
+inline const std::string &InvalidDenotationException::note() const
+{
+    return m_note;
+}
+
 class InterruptHandler {
 public:
     explicit InterruptHandler(std::function<void()> &&handler);
@@ -256,7 +282,6 @@ namespace Cli {
 
 struct FieldValues {
     std::vector<FieldValue> allValues;
-    std::vector<FieldValue *> relevantValues;
 };
 using FieldDenotations = std::unordered_map<FieldScope, FieldValues>;
 
@@ -310,9 +335,12 @@ TagUsage parseUsageDenotation(const CppUtilities::Argument &usageArg, TagUsage d
 TagTextEncoding parseEncodingDenotation(const CppUtilities::Argument &encodingArg, TagTextEncoding defaultEncoding);
 ElementPosition parsePositionDenotation(const CppUtilities::Argument &posArg, const CppUtilities::Argument &valueArg, ElementPosition defaultPos);
 std::uint64_t parseUInt64(const CppUtilities::Argument &arg, std::uint64_t defaultValue);
+std::size_t parseJobCount(const CppUtilities::Argument &jobsArg);
 TagTarget::IdContainerType parseIds(std::string_view concatenatedIds);
 bool applyTargetConfiguration(TagTarget &target, std::string_view configStr);
+[[noreturn]] void exitDueToInvalidDenotation(const InvalidDenotationException &error);
 FieldDenotations parseFieldDenotations(const CppUtilities::Argument &fieldsArg, bool readOnly);
+FieldDenotations parseFieldDenotations(const std::vector<const char *> &fieldDenotations, bool readOnly);
 std::string tagName(const Tag *tag);
 bool stringToBool(const std::string &str);
 extern bool logLineFinalized;
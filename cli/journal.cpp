@@ -0,0 +1,359 @@
+#include "./journal.h"
+#include "./cache.h"
+#include "./mainfeatures.h"
+
+#include <tagparser/diagnostics.h>
+#include <tagparser/matroska/matroskacontainer.h>
+#include <tagparser/matroska/matroskaid.h>
+#include <tagparser/mediafileinfo.h>
+#include <tagparser/mp4/mp4container.h>
+#include <tagparser/mp4/mp4ids.h>
+#include <tagparser/signature.h>
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+#include <c++utilities/io/binaryreader.h>
+#include <c++utilities/io/binarywriter.h>
+#include <c++utilities/io/nativefilestream.h>
+#include <c++utilities/io/path.h>
+
+#if defined(PLATFORM_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+using namespace TagParser;
+
+namespace Cli {
+
+/// \brief The magic bytes at the beginning of a journal file.
+static constexpr auto journalMagic = std::string_view("TAGEDITOR-JOURNAL");
+/// \brief The version of the journal file format; increment when changing the format.
+static constexpr auto journalFormatVersion = std::uint32_t(1);
+/// \brief The extension of journal files.
+static constexpr auto journalExtension = std::string_view(".journal");
+/// \brief The size of the buffer used to copy regions from/to journal files.
+static constexpr auto copyBufferSize = std::size_t(0x10000);
+
+/*!
+ * \brief Flushes the file or directory at the specified \a path to disk.
+ * \remarks Only supported under UNIX; does nothing on other platforms.
+ */
+static void syncToDisk(const std::string &path, bool directory = false)
+{
+#if defined(PLATFORM_UNIX)
+    const auto fd = ::open(path.data(), (directory ? O_RDONLY | O_DIRECTORY : O_RDONLY) | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::ios_base::failure(argsToString("unable to open \"", path, "\" for flushing it: ", std::strerror(errno)));
+    }
+    const auto res = ::fsync(fd);
+    const auto error = errno;
+    ::close(fd);
+    if (res) {
+        throw std::ios_base::failure(argsToString("unable to flush \"", path, "\": ", std::strerror(error)));
+    }
+#else
+    CPP_UTILITIES_UNUSED(path);
+    CPP_UTILITIES_UNUSED(directory);
+#endif
+}
+
+/*!
+ * \brief Throws std::ios_base::failure if \a error is set so file system errors are handled like other IO errors.
+ */
+static void throwIfFailed(const std::error_code &error, std::string_view action, std::string_view path)
+{
+    if (error) {
+        throw std::ios_base::failure(argsToString("unable to ", action, " \"", path, "\": ", error.message()));
+    }
+}
+
+/*!
+ * \brief Copies \a size bytes from \a input to \a output.
+ */
+static void copyBytes(std::istream &input, std::ostream &output, std::uint64_t size)
+{
+    const auto buffer = std::make_unique<char[]>(copyBufferSize);
+    while (size) {
+        const auto chunkSize = static_cast<std::size_t>(std::min<std::uint64_t>(size, copyBufferSize));
+        input.read(buffer.get(), static_cast<std::streamsize>(chunkSize));
+        output.write(buffer.get(), static_cast<std::streamsize>(chunkSize));
+        size -= chunkSize;
+    }
+}
+
+/*!
+ * \brief Creates the journal directory if it does not exist yet.
+ * \remarks Exits the app if the directory can not be created.
+ */
+WriteJournal::WriteJournal(std::string_view directory)
+    : m_directory(directory)
+{
+    auto error = std::error_code();
+    std::filesystem::create_directories(makeNativePath(m_directory), error);
+    if (error) {
+        cerr << Phrases::Error << "Unable to create the journal directory \"" << m_directory << "\": " << error.message() << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/*!
+ * \brief Restores all files from journals left behind by a previous invocation (e.g. due to a crash).
+ * \remarks
+ * - Incomplete journals are just removed because the corresponding files have not been modified yet.
+ * - Journals of files which have been replaced in the meantime are removed with a warning (see restore()).
+ */
+void WriteJournal::recoverPending()
+{
+    auto error = std::error_code();
+    auto journals = std::vector<std::string>();
+    for (const auto &entry : std::filesystem::directory_iterator(makeNativePath(m_directory), error)) {
+        const auto path = entry.path().string();
+        if (endsWith(path, journalExtension.data())) {
+            journals.emplace_back(path);
+        } else if (endsWith(path, ".journal.tmp")) {
+            auto removalError = std::error_code();
+            std::filesystem::remove(entry.path(), removalError);
+        }
+    }
+    if (error) {
+        cerr << Phrases::Warning << "Unable to read the journal directory \"" << m_directory << "\": " << error.message() << Phrases::EndFlush;
+    }
+    for (const auto &journal : journals) {
+        try {
+            auto file = std::string();
+            if (restore(journal, file)) {
+                cout << "Changes to \"" << file << "\" which have not been completed have been rolled back via the journal." << endl;
+            } else {
+                cerr << Phrases::Warning << "The file \"" << file << "\" does not exist anymore or has been replaced since the journal \""
+                     << journal << "\" has been written." << Phrases::End << "note: The journal has been discarded as it can not be applied anymore."
+                     << endl;
+            }
+        } catch (const std::ios_base::failure &e) {
+            cerr << Phrases::Error << "Unable to restore the file from the journal \"" << journal << "\": " << e.what() << Phrases::End
+                 << "note: The journal is kept so it can be restored later." << endl;
+            exitCode = EXIT_IO_FAILURE;
+        }
+    }
+}
+
+/*!
+ * \brief Saves the specified \a regions of \a file to a journal and returns the path of the journal.
+ * \remarks Throws std::ios_base::failure if an IO error occurs; the file must not be modified in this case.
+ */
+std::string WriteJournal::begin(const char *file, const std::vector<JournalRegion> &regions)
+{
+    const auto status = FileStatus::fromPath(file);
+    if (!status.valid) {
+        throw std::ios_base::failure(argsToString("unable to determine the status of \"", file, '\"'));
+    }
+    const auto journalPath = pathFor(status.absolutePath);
+    const auto tempPath = journalPath + ".tmp";
+    auto input = NativeFileStream();
+    auto output = NativeFileStream();
+    input.exceptions(ios_base::failbit | ios_base::badbit);
+    output.exceptions(ios_base::failbit | ios_base::badbit);
+    input.open(file, ios_base::in | ios_base::binary);
+    output.open(tempPath, ios_base::out | ios_base::trunc | ios_base::binary);
+    auto writer = BinaryWriter(&output);
+    writer.write(journalMagic.data(), static_cast<std::streamsize>(journalMagic.size()));
+    writer.writeUInt32LE(journalFormatVersion);
+    writer.writeUInt64LE(status.absolutePath.size());
+    writer.write(status.absolutePath.data(), static_cast<std::streamsize>(status.absolutePath.size()));
+    writer.writeUInt64LE(status.size);
+    writer.writeUInt64LE(status.device);
+    writer.writeUInt64LE(status.inode);
+    writer.writeUInt64LE(regions.size());
+    for (const auto &region : regions) {
+        writer.writeUInt64LE(region.offset);
+        writer.writeUInt64LE(region.size);
+        input.seekg(static_cast<std::streamoff>(region.offset));
+        copyBytes(input, output, region.size);
+    }
+    output.flush();
+    output.close();
+    syncToDisk(tempPath);
+    auto error = std::error_code();
+    std::filesystem::rename(makeNativePath(tempPath), makeNativePath(journalPath), error);
+    throwIfFailed(error, "rename journal", tempPath);
+    syncToDisk(m_directory, true);
+    return journalPath;
+}
+
+/*!
+ * \brief Flushes \a file to disk and removes the journal at \a journalPath afterwards.
+ */
+void WriteJournal::commit(const std::string &journalPath, const char *file)
+{
+    syncToDisk(file);
+    auto error = std::error_code();
+    std::filesystem::remove(makeNativePath(journalPath), error);
+    throwIfFailed(error, "remove journal", journalPath);
+}
+
+/*!
+ * \brief Restores the file from the journal at \a journalPath and removes the journal.
+ * \remarks
+ * - The journal is just removed if the file has been replaced in the meantime because then the file has been rewritten
+ *   completely after all and the tag parser takes care of restoring the backup file.
+ * - Throws std::ios_base::failure if an IO error occurs.
+ */
+void WriteJournal::rollBack(const std::string &journalPath)
+{
+    auto file = std::string();
+    restore(journalPath, file);
+}
+
+/*!
+ * \brief Returns the path of the journal for the file with the specified \a absolutePath.
+ */
+std::string WriteJournal::pathFor(std::string_view absolutePath) const
+{
+    return argsToString(m_directory, '/', numberToString(std::hash<std::string_view>()(absolutePath), 16), journalExtension);
+}
+
+/*!
+ * \brief Restores the file from the journal at \a journalPath and removes the journal.
+ * \returns Returns whether the file has been restored. If the file does not exist anymore or has been replaced in the
+ *          meantime, the journal is just removed as it can not be applied anymore and false is returned.
+ * \remarks
+ * - Sets \a file to the path of the file the journal has been written for.
+ * - Throws std::ios_base::failure if an IO error occurs.
+ */
+bool WriteJournal::restore(const std::string &journalPath, std::string &file)
+{
+    auto input = NativeFileStream();
+    input.exceptions(ios_base::failbit | ios_base::badbit);
+    input.open(journalPath, ios_base::in | ios_base::binary);
+    auto reader = BinaryReader(&input);
+    if (reader.readString(journalMagic.size()) != journalMagic || reader.readUInt32LE() != journalFormatVersion) {
+        throw std::ios_base::failure("not a journal or journal of incompatible version");
+    }
+    auto error = std::error_code();
+    const auto journalSize = std::filesystem::file_size(makeNativePath(journalPath), error);
+    throwIfFailed(error, "determine size of journal", journalPath);
+    const auto pathSize = reader.readUInt64LE();
+    if (pathSize > journalSize) {
+        throw std::ios_base::failure("path size exceeds journal size");
+    }
+    file = reader.readString(static_cast<std::size_t>(pathSize));
+    const auto &path = file;
+    const auto size = reader.readUInt64LE();
+    const auto device = reader.readUInt64LE();
+    const auto inode = reader.readUInt64LE();
+    const auto status = FileStatus::fromPath(path.data());
+    if (!status.valid || status.device != device || status.inode != inode) {
+        input.close();
+        std::filesystem::remove(makeNativePath(journalPath), error);
+        throwIfFailed(error, "remove journal", journalPath);
+        return false;
+    }
+
+    // write the saved regions back and truncate the file to its original size
+    auto output = NativeFileStream();
+    output.exceptions(ios_base::failbit | ios_base::badbit);
+    output.open(path, ios_base::in | ios_base::out | ios_base::binary);
+    for (auto count = reader.readUInt64LE(); count; --count) {
+        const auto offset = reader.readUInt64LE();
+        const auto regionSize = reader.readUInt64LE();
+        if (regionSize > journalSize || offset + regionSize > size) {
+            throw std::ios_base::failure("region exceeds journal or file size");
+        }
+        output.seekp(static_cast<std::streamoff>(offset));
+        copyBytes(input, output, regionSize);
+    }
+    output.flush();
+    output.close();
+    std::filesystem::resize_file(makeNativePath(path), size, error);
+    throwIfFailed(error, "truncate", path);
+    syncToDisk(path);
+    input.close();
+    std::filesystem::remove(makeNativePath(journalPath), error);
+    throwIfFailed(error, "remove journal", journalPath);
+    return true;
+}
+
+/*!
+ * \brief Extends the range [\a start, \a end) by the element if it has the specified \a id.
+ */
+template <typename ElementType, typename IdType>
+static void extendRangeByElements(ElementType *element, IdType id, Diagnostics &diag, std::uint64_t &start, std::uint64_t &end)
+{
+    for (; element; element = element->nextSibling()) {
+        element->parse(diag);
+        if (element->id() == id) {
+            start = std::min(start, element->startOffset());
+            end = std::max(end, element->startOffset() + element->totalSize());
+        }
+    }
+}
+
+/*!
+ * \brief Determines the regions of the file which might be overwritten when updating \a fileInfo in-place.
+ *
+ * That is everything in front of and after the media data (e.g. the ID3 tags around the MPEG frames, the atoms around the
+ * "mdat"-atoms of an MP4 file or the elements around the clusters of a Matroska segment).
+ *
+ * \returns Returns whether the regions could be determined. That is not the case for unsupported formats (e.g. FLAC) and
+ *          Matroska files with multiple segments.
+ * \remarks Must be invoked before applying changes.
+ */
+bool determineRegionsToJournal(MediaFileInfo &fileInfo, Diagnostics &diag, std::vector<JournalRegion> &regions)
+{
+    regions.clear();
+    const auto fileSize = fileInfo.size();
+    auto start = std::numeric_limits<std::uint64_t>::max(), end = std::uint64_t();
+    auto *const container = fileInfo.container();
+    switch (fileInfo.containerFormat()) {
+    case ContainerFormat::MpegAudioFrames:
+        start = fileInfo.containerOffset();
+        end = fileSize - (fileInfo.id3v1Tag() ? 128 : 0);
+        break;
+    case ContainerFormat::Mp4:
+    case ContainerFormat::QuickTime:
+        if (container) {
+            extendRangeByElements(static_cast<Mp4Container *>(container)->firstElement(), Mp4AtomIds::MediaData, diag, start, end);
+        }
+        break;
+    case ContainerFormat::Matroska:
+    case ContainerFormat::Webm:
+        if (container) {
+            auto segmentCount = std::size_t();
+            for (auto *element = static_cast<MatroskaContainer *>(container)->firstElement(); element; element = element->nextSibling()) {
+                element->parse(diag);
+                if (element->id() == MatroskaIds::Segment) {
+                    ++segmentCount;
+                    extendRangeByElements(element->firstChild(), MatroskaIds::Cluster, diag, start, end);
+                }
+            }
+            if (segmentCount != 1) {
+                return false;
+            }
+        }
+        break;
+    default:
+        return false;
+    }
+    if (start > end || end > fileSize) {
+        return false;
+    }
+    regions.emplace_back(JournalRegion{ 0, start });
+    regions.emplace_back(JournalRegion{ end, fileSize - end });
+    return true;
+}
+
+} // namespace Cli
@@ -0,0 +1,59 @@
+#ifndef CLI_JOURNAL
+#define CLI_JOURNAL
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TagParser {
+class MediaFileInfo;
+class Diagnostics;
+} // namespace TagParser
+
+namespace Cli {
+
+/*!
+ * \brief The JournalRegion struct specifies a range of bytes within a file which is saved to the journal.
+ */
+struct JournalRegion {
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+};
+
+/*!
+ * \brief The WriteJournal class allows updating files in-place in a crash-safe way (see --journal).
+ *
+ * Before a file is updated in-place, begin() saves the regions of the file which might be overwritten (everything except
+ * the media data) and the file size to a journal within the journal directory. After the changes have been applied,
+ * commit() flushes the file to disk and removes the journal. If applying the changes fails, rollBack() restores the file
+ * from the journal. Journals left behind by a crash are restored via recoverPending() when the journal is used the next time.
+ *
+ * \remarks
+ * - A journal is only written completely (written to a temporary file first and renamed after flushing it to disk) so a
+ *   journal is never restored partially.
+ * - A journal is not restored but discarded if the file has been replaced in the meantime (e.g. because it has been
+ *   rewritten completely after all), as detected via the inode under UNIX.
+ * - The member functions may be invoked from multiple threads as long as different files are concerned.
+ */
+class WriteJournal {
+public:
+    explicit WriteJournal(std::string_view directory);
+
+    void recoverPending();
+    std::string begin(const char *file, const std::vector<JournalRegion> &regions);
+    void commit(const std::string &journalPath, const char *file);
+    void rollBack(const std::string &journalPath);
+
+private:
+    std::string pathFor(std::string_view absolutePath) const;
+    static bool restore(const std::string &journalPath, std::string &file);
+
+    std::string m_directory;
+};
+
+bool determineRegionsToJournal(TagParser::MediaFileInfo &fileInfo, TagParser::Diagnostics &diag, std::vector<JournalRegion> &regions);
+
+} // namespace Cli
+
+#endif // CLI_JOURNAL
@@ -114,15 +114,16 @@ TargetInfo::TargetInfo(const TagTarget &tagTarget, RAPIDJSON_NAMESPACE::Document
 
 /*!
  * \brief Copies relevant information from TagParser::Tag for serialization (especially the fields).
+ * \remarks Only the specified \a fieldsToExport are copied; all fields are copied if none are specified.
  */
-TagInfo::TagInfo(const Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator)
+TagInfo::TagInfo(const Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator, const std::vector<KnownField> &fieldsToExport)
     : format(tag.typeName())
     , target(tag.target(), allocator)
 {
-    for (auto field = firstKnownField; field != KnownField::Invalid; field = nextKnownField(field)) {
+    const auto addField = [&](KnownField field) {
         const auto &tagValues(tag.values(field));
         if (tagValues.empty()) {
-            continue;
+            return;
         }
         std::vector<TagValue> valueObjects;
         valueObjects.reserve(tagValues.size());
@@ -134,22 +135,36 @@ TagInfo::TagInfo(const Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &a
             c = static_cast<std::string::value_type>(CaseInsensitiveCharComparer::toLower(static_cast<unsigned char>(c)));
         }
         fields.insert(std::make_pair(std::move(key), std::move(valueObjects)));
+    };
+    if (fieldsToExport.empty()) {
+        for (auto field = firstKnownField; field != KnownField::Invalid; field = nextKnownField(field)) {
+            addField(field);
+        }
+    } else {
+        for (const auto field : fieldsToExport) {
+            addField(field);
+        }
     }
 }
 
 /*!
  * \brief Copies relevant information from TagParser::MediaFileInfo for serialization.
- * \remarks The \a mediaFileInfo must have been parsed before.
+ * \remarks The \a mediaFileInfo must have been parsed before. Only the specified \a fieldsToExport are copied from
+ *          the tags; all fields are copied if none are specified. The track-dependent information is left empty if the
+ *          tracks have not been parsed.
  */
-FileInfo::FileInfo(const TagParser::MediaFileInfo &mediaFileInfo, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator)
+FileInfo::FileInfo(const TagParser::MediaFileInfo &mediaFileInfo, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator,
+    const std::vector<KnownField> &fieldsToExport)
     : fileName(mediaFileInfo.fileName())
     , size(mediaFileInfo.size())
-    , mimeType(mediaFileInfo.mimeType())
-    , formatSummary(mediaFileInfo.technicalSummary())
-    , duration(mediaFileInfo.duration())
 {
+    if (mediaFileInfo.tracksParsingStatus() != ParsingStatus::NotParsedYet) {
+        mimeType = mediaFileInfo.mimeType();
+        formatSummary = mediaFileInfo.technicalSummary();
+        duration = mediaFileInfo.duration();
+    }
     for (const Tag *tag : mediaFileInfo.tags()) {
-        tags.emplace_back(*tag, allocator);
+        tags.emplace_back(*tag, allocator, fieldsToExport);
     }
 }
 
@@ -8,11 +8,13 @@
 #include <c++utilities/chrono/timespan.h>
 
 #include <unordered_map>
+#include <vector>
 
 namespace TagParser {
 class MediaFileInfo;
 class Tag;
 class TagValue;
+enum class KnownField : unsigned int;
 }
 
 namespace Cli {
@@ -40,7 +42,8 @@ struct TargetInfo : ReflectiveRapidJSON::JsonSerializable<TargetInfo> {
 };
 
 struct TagInfo : ReflectiveRapidJSON::JsonSerializable<TagInfo> {
-    TagInfo(const TagParser::Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator);
+    TagInfo(const TagParser::Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator,
+        const std::vector<TagParser::KnownField> &fieldsToExport = std::vector<TagParser::KnownField>());
 
     std::string_view format;
     TargetInfo target;
@@ -48,7 +51,8 @@ struct TagInfo : ReflectiveRapidJSON::JsonSerializable<TagInfo> {
 };
 
 struct FileInfo : ReflectiveRapidJSON::JsonSerializable<FileInfo> {
-    FileInfo(const TagParser::MediaFileInfo &mediaFileInfo, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator);
+    FileInfo(const TagParser::MediaFileInfo &mediaFileInfo, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator,
+        const std::vector<TagParser::KnownField> &fieldsToExport = std::vector<TagParser::KnownField>());
 
     std::string fileName;
     std::size_t size;
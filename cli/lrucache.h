@@ -0,0 +1,120 @@
+#ifndef CLI_LRU_CACHE
+#define CLI_LRU_CACHE
+
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+namespace Cli {
+
+/*!
+ * \brief The LruCache class holds slots by key and drops the least recently used slots when their total size exceeds a limit.
+ *
+ * A slot is created via slot() before its value is loaded (so threads requesting the same key can wait for the same slot).
+ * Once loaded, the slot is accounted via markUsed() with its size. Only slots which have been accounted are dropped.
+ *
+ * \remarks
+ * - The class is not thread-safe; the owner is supposed to lock a mutex when invoking any of the member functions.
+ * - Slots which have been dropped remain valid as long as they are referenced elsewhere (e.g. by a thread still waiting for
+ *   the slot). Marking such a slot as used has no effect so it is not cached again.
+ */
+template <typename Key, typename Slot> class LruCache {
+public:
+    explicit LruCache(std::size_t maxBytes);
+
+    std::shared_ptr<Slot> slot(const Key &key);
+    template <typename EvictionHandler>
+    void markUsed(const Key &key, const std::shared_ptr<Slot> &slot, std::size_t bytes, EvictionHandler &&evicted);
+    std::size_t maxBytes() const;
+    std::size_t bytes() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<Slot> slot;
+        typename std::list<Key>::iterator lruEntry;
+        std::size_t bytes = 0;
+        bool accounted = false;
+    };
+
+    std::unordered_map<Key, Entry> m_entries;
+    std::list<Key> m_lru;
+    std::size_t m_maxBytes;
+    std::size_t m_bytes = 0;
+};
+
+/*!
+ * \brief Constructs a new cache keeping slots of at most \a maxBytes in total.
+ * \remarks A slot bigger than \a maxBytes is still cached until the next slot is marked as used.
+ */
+template <typename Key, typename Slot>
+inline LruCache<Key, Slot>::LruCache(std::size_t maxBytes)
+    : m_maxBytes(maxBytes)
+{
+}
+
+/*!
+ * \brief Returns the slot for the specified \a key creating a new one if there is none yet.
+ */
+template <typename Key, typename Slot> std::shared_ptr<Slot> LruCache<Key, Slot>::slot(const Key &key)
+{
+    auto &entry = m_entries[key];
+    if (!entry.slot) {
+        entry.slot = std::make_shared<Slot>();
+    }
+    return entry.slot;
+}
+
+/*!
+ * \brief Marks the \a slot for the specified \a key as most recently used, accounting it with the specified size in \a bytes
+ *        if not done so before.
+ * \remarks Drops the least recently used slots if the limit is exceeded, passing each of them to \a evicted.
+ */
+template <typename Key, typename Slot>
+template <typename EvictionHandler>
+void LruCache<Key, Slot>::markUsed(const Key &key, const std::shared_ptr<Slot> &slot, std::size_t bytes, EvictionHandler &&evicted)
+{
+    const auto i = m_entries.find(key);
+    if (i == m_entries.end() || i->second.slot != slot) {
+        return;
+    }
+    auto &entry = i->second;
+    if (entry.accounted) {
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruEntry);
+        return;
+    }
+    entry.accounted = true;
+    entry.bytes = bytes;
+    entry.lruEntry = m_lru.emplace(m_lru.begin(), key);
+    m_bytes += bytes;
+    while (m_bytes > m_maxBytes && m_lru.size() > 1) {
+        const auto evictedEntry = m_entries.find(m_lru.back());
+        const auto evictedSlot = std::move(evictedEntry->second.slot);
+        m_bytes -= evictedEntry->second.bytes;
+        m_entries.erase(evictedEntry);
+        m_lru.pop_back();
+        evicted(*evictedSlot);
+    }
+}
+
+/*!
+ * \brief Returns the max. total size of the cached slots.
+ */
+template <typename Key, typename Slot> inline std::size_t LruCache<Key, Slot>::maxBytes() const
+{
+    return m_maxBytes;
+}
+
+/*!
+ * \brief Returns the total size of the slots currently cached.
+ */
+template <typename Key, typename Slot> inline std::size_t LruCache<Key, Slot>::bytes() const
+{
+    return m_bytes;
+}
+
+} // namespace Cli
+
+#endif // CLI_LRU_CACHE
@@ -1,6 +1,20 @@
 #include "./mainfeatures.h"
 #include "./attachmentinfo.h"
+#include "./cache.h"
+#include "./changedetection.h"
+#include "./covercache.h"
+#include "./covernormalizer.h"
+#include "./editplan.h"
+#include "./fieldmapping.h"
+#include "./filecopy.h"
 #include "./helper.h"
+#include "./journal.h"
+#include "./manifest.h"
+#include "./outputpath.h"
+#include "./paddingpolicy.h"
+#include "./profiler.h"
+#include "./workerpool.h"
+#include "./writeplan.h"
 #ifdef TAGEDITOR_JSON_EXPORT
 #include "./json.h"
 #endif
@@ -10,6 +24,8 @@
 // includes for JavaScript support of set operation
 #ifdef TAGEDITOR_USE_JSENGINE
 #include "./scriptapi.h"
+
+#include "../misc/networkaccessmanager.h"
 #endif
 
 // includes for generating HTML info
@@ -51,6 +67,7 @@
 #include <QCoreApplication>
 #include <QFile>
 #include <QJSValue>
+#include <QNetworkAccessManager>
 #include <QQmlEngine>
 #include <QTextStream>
 #endif
@@ -64,18 +81,24 @@
 #ifdef TAGEDITOR_JSON_EXPORT
 #include <rapidjson/ostreamwrapper.h>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #endif
 
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <string_view>
+#include <thread>
 
 using namespace std;
 using namespace CppUtilities;
@@ -181,8 +204,39 @@ void generateFileInfo(const ArgumentOccurrence &, const Argument &inputFileArg,
 #endif
 }
 
-void displayFileInfo(
-    const ArgumentOccurrence &, const Argument &filesArg, const Argument &verboseArg, const Argument &pedanticArg, const Argument &validateArg)
+/*!
+ * \brief The ReadingJob struct holds the state for reading a single file within the read-only operations.
+ * \remarks
+ * - Files are parsed by worker threads (if --jobs has been specified) and the results are printed on the main thread in the
+ *   order the files have been specified. So the output is the same as when processing files one after another.
+ * - Errors occurring when parsing are stored in \a parsingError and re-thrown when printing the results.
+ */
+struct ReadingJob {
+    MediaFileInfo fileInfo;
+    Diagnostics diag;
+    std::exception_ptr parsingError;
+    FileStatus fileStatus;
+    std::optional<std::string> cachedResult;
+    FileProfile profile;
+};
+
+/*!
+ * \brief Looks up the result for the specified \a file in the specified \a cache.
+ * \returns Returns whether a valid result has been found (and assigned to \a job) so parsing the file can be skipped.
+ */
+static bool lookupCachedResult(ResultCache *cache, std::string_view variant, const char *file, ReadingJob &job)
+{
+    job.cachedResult.reset();
+    if (!cache) {
+        return false;
+    }
+    job.fileStatus = FileStatus::fromPath(file);
+    job.cachedResult = cache->find(variant, job.fileStatus);
+    return job.cachedResult.has_value();
+}
+
+void displayFileInfo(const ArgumentOccurrence &, const Argument &filesArg, const Argument &verboseArg, const Argument &pedanticArg,
+    const Argument &validateArg, const Argument &jobsArg, const Argument &profileArg)
 {
     // check whether files have been specified
     if (!filesArg.isPresent() || filesArg.values().empty()) {
@@ -190,19 +244,39 @@ void displayFileInfo(
         std::exit(EXIT_FAILURE);
     }
 
-    MediaFileInfo fileInfo;
-    for (const char *file : filesArg.values()) {
-        Diagnostics diag;
-        AbortableProgressFeedback progress; // FIXME: actually use the progress object
+    const auto &files = filesArg.values();
+    const auto jobCount = parseJobCount(jobsArg);
+    auto jobs = std::deque<ReadingJob>(slotCountFor(jobCount, files.size()));
+    for (auto &job : jobs) {
+        job.fileInfo.setForceFullParse(validateArg.isPresent());
+    }
+    auto profiler = Profiler(profileArg);
+    const auto parseFile = [&files, &profiler](std::size_t fileIndex, ReadingJob &job) {
+        auto progress = AbortableProgressFeedback(); // FIXME: actually use the progress object
+        auto timer = ProfileTimer(profiler.profile(job.profile), files[fileIndex]);
+        job.diag.clear();
+        job.parsingError = nullptr;
+        try {
+            job.fileInfo.setPath(std::string(files[fileIndex]));
+            job.fileInfo.open(true);
+            timer.mark(ProfilePhase::Open);
+            job.fileInfo.parseContainerFormat(job.diag, progress);
+            timer.mark(ProfilePhase::ParseContainerFormat);
+            job.fileInfo.parseEverything(job.diag, progress);
+            timer.mark(ProfilePhase::ParseRemaining);
+        } catch (...) {
+            job.parsingError = std::current_exception();
+        }
+    };
+    const auto printFileInfo = [&](std::size_t fileIndex, ReadingJob &job) {
+        const char *const file = files[fileIndex];
+        auto &fileInfo = job.fileInfo;
+        auto &diag = job.diag;
+        profiler.add(job.profile);
         try {
-            // parse tags
-            if (validateArg.isPresent()) {
-                fileInfo.setForceFullParse(true);
+            if (job.parsingError) {
+                std::rethrow_exception(job.parsingError);
             }
-            fileInfo.setPath(std::string(file));
-            fileInfo.open(true);
-            fileInfo.parseContainerFormat(diag, progress);
-            fileInfo.parseEverything(diag, progress);
 
             // print general/container-related info
             cout << "Technical information for \"" << file << "\":\n";
@@ -369,11 +443,14 @@ void displayFileInfo(
 
         printDiagMessages(diag, "Diagnostic messages:", verboseArg.isPresent(), &pedanticArg);
         cout << endl;
-    }
+        return true;
+    };
+    processInOrder(files.size(), jobs, jobCount, parseFile, printFileInfo);
+    profiler.finish();
 }
 
-void displayTagInfo(
-    const Argument &fieldsArg, const Argument &showUnsupportedArg, const Argument &filesArg, const Argument &verboseArg, const Argument &pedanticArg)
+void displayTagInfo(const Argument &fieldsArg, const Argument &showUnsupportedArg, const Argument &filesArg, const Argument &verboseArg,
+    const Argument &pedanticArg, const Argument &jobsArg, const Argument &cacheArg, const Argument &profileArg)
 {
     // check whether files have been specified
     if (!filesArg.isPresent() || filesArg.values().empty()) {
@@ -384,22 +461,59 @@ void displayTagInfo(
     // parse specified fields
     const auto fields = parseFieldDenotations(fieldsArg, true);
 
-    auto fileInfo = MediaFileInfo();
-    fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::ConvertTotalFields);
-    for (const char *file : filesArg.values()) {
-        Diagnostics diag;
-        AbortableProgressFeedback progress; // FIXME: actually use the progress object
+    // load cache if specified; the variant covers everything the printed output depends on
+    auto cache = std::optional<ResultCache>();
+    auto cacheVariant = std::string();
+    if (cacheArg.isPresent()) {
+        cache.emplace(cacheArg.values().front());
+        cacheVariant = argsToString("get:", showUnsupportedArg.isPresent() ? '1' : '0', ':', static_cast<int>(timeSpanOutputFormat), ':',
+            EscapeCodes::enabled ? '1' : '0');
+        for (const char *const fieldDenotation : fieldsArg.values()) {
+            cacheVariant += ':';
+            cacheVariant += fieldDenotation;
+        }
+    }
+    auto *const cachePtr = cache.has_value() ? &cache.value() : nullptr;
+
+    const auto &files = filesArg.values();
+    const auto jobCount = parseJobCount(jobsArg);
+    auto jobs = std::deque<ReadingJob>(slotCountFor(jobCount, files.size()));
+    for (auto &job : jobs) {
+        job.fileInfo.setFileHandlingFlags(job.fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::ConvertTotalFields);
+    }
+    auto profiler = Profiler(profileArg);
+    const auto parseFile = [&files, &cacheVariant, cachePtr, &profiler](std::size_t fileIndex, ReadingJob &job) {
+        auto progress = AbortableProgressFeedback(); // FIXME: actually use the progress object
+        job.diag.clear();
+        job.parsingError = nullptr;
+        if (lookupCachedResult(cachePtr, cacheVariant, files[fileIndex], job)) {
+            return;
+        }
+        auto timer = ProfileTimer(profiler.profile(job.profile), files[fileIndex]);
+        try {
+            job.fileInfo.setPath(std::string(files[fileIndex]));
+            job.fileInfo.open(true);
+            timer.mark(ProfilePhase::Open);
+            job.fileInfo.parseContainerFormat(job.diag, progress);
+            timer.mark(ProfilePhase::ParseContainerFormat);
+            job.fileInfo.parseTags(job.diag, progress);
+            timer.mark(ProfilePhase::ParseTags);
+        } catch (...) {
+            job.parsingError = std::current_exception();
+        }
+    };
+    const auto printTagInfo = [&](std::size_t fileIndex, ReadingJob &job) {
+        const char *const file = files[fileIndex];
+        auto &diag = job.diag;
         try {
-            // parse tags
-            fileInfo.setPath(std::string(file));
-            fileInfo.open(true);
-            fileInfo.parseContainerFormat(diag, progress);
-            fileInfo.parseTags(diag, progress);
+            if (job.parsingError) {
+                std::rethrow_exception(job.parsingError);
+            }
             cout << "Tag information for \"" << file << "\":\n";
-            const auto tags = fileInfo.tags();
+            const auto tags = job.fileInfo.tags();
             if (tags.empty()) {
                 cout << " - File has no (supported) tag information.\n";
-                continue;
+                return true;
             }
             // iterate through all tags
             for (const auto *tag : tags) {
@@ -433,7 +547,31 @@ void displayTagInfo(
         }
         printDiagMessages(diag, "Diagnostic messages:", verboseArg.isPresent(), &pedanticArg);
         cout << endl;
+        return true;
+    };
+    const auto printCachedTagInfo = [&](std::size_t fileIndex, ReadingJob &job) {
+        profiler.add(job.profile);
+        if (job.cachedResult) {
+            cout << *job.cachedResult << flush;
+            return true;
+        }
+        if (!cachePtr || job.parsingError) {
+            return printTagInfo(fileIndex, job);
+        }
+        // capture the output to store it in the cache unless there's anything else to be printed than the plain tag information
+        const auto errorCapture = OutputCapture(cerr);
+        const auto outputCapture = OutputCapture(cout);
+        const auto res = printTagInfo(fileIndex, job);
+        if (job.diag.empty() && errorCapture.str().empty()) {
+            cachePtr->store(cacheVariant, job.fileStatus, outputCapture.str());
+        }
+        return res;
+    };
+    processInOrder(files.size(), jobs, jobCount, parseFile, printCachedTagInfo);
+    if (cache) {
+        cache->save();
     }
+    profiler.finish();
 }
 
 struct Id3v2Cover {
@@ -461,7 +599,7 @@ template <class TagType> static void setId3v2CoverValues(TagType *tag, std::vect
         if (pair != range.second) {
             // there is already a tag value with the current type and description
             // -> update this value
-            pair->second.setValue(tagValue);
+            pair->second.setValue(std::move(tagValue));
             // check whether there are more values with the current type and description
             while ((pair = std::find_if(++pair, range.second, std::bind(&fieldPredicate<TagType>, coverType, description, placeholders::_1)))
                 != range.second) {
@@ -470,7 +608,7 @@ template <class TagType> static void setId3v2CoverValues(TagType *tag, std::vect
             }
         } else if (!tagValue.isEmpty()) {
             using FieldType = typename TagType::FieldType;
-            auto newField = FieldType(id, tagValue);
+            auto newField = FieldType(id, std::move(tagValue));
             newField.setTypeInfo(static_cast<typename FieldType::TypeInfoType>(coverType));
             fields.insert(std::pair(id, std::move(newField)));
         }
@@ -478,37 +616,77 @@ template <class TagType> static void setId3v2CoverValues(TagType *tag, std::vect
 }
 
 #ifdef TAGEDITOR_USE_JSENGINE
-class JavaScriptProcessor {
+/*!
+ * \brief The JavaScriptEngine class holds a JavaScript engine with the specified JavaScript file loaded as module.
+ * \remarks
+ * - The module is loaded (and thus compiled) only once per engine; its main() function is then called for each file.
+ * - Instances live in the thread they have been created in as they are QObject-based.
+ */
+class JavaScriptEngine {
 public:
-    explicit JavaScriptProcessor(const SetTagInfoArgs &args);
-    JavaScriptProcessor(const JavaScriptProcessor &) = delete;
+    explicit JavaScriptEngine(const SetTagInfoArgs &args, bool workerThread = false);
+    JavaScriptEngine(const JavaScriptEngine &) = delete;
+    ~JavaScriptEngine();
 
-    QJSValue callMain(MediaFileInfo &mediaFileInfo, Diagnostics &diag);
+    bool load(Diagnostics &diag);
+    QJSValue callMain(MediaFileInfo &mediaFileInfo, Diagnostics &diag, std::ostream &out);
 
 private:
     static void addWarnings(Diagnostics &diag, const std::string &context, const QList<QQmlError> &warnings);
 
     const SetTagInfoArgs &args;
-    int argc;
-    QCoreApplication app;
-    Diagnostics diag;
     QQmlEngine engine; // not using QJSEngine as otherwise XMLHttpRequest is not available
     QJSValue module, main;
     UtilityObject *utility;
+    std::unique_ptr<QNetworkAccessManager> networkAccessManager;
 };
 
+/*!
+ * \brief The JavaScriptProcessor class manages the JavaScript engines for processing files via the specified JavaScript.
+ *
+ * Each thread processing files uses its own JavaScriptEngine so files can be processed in parallel via --jobs. The engine
+ * of the main thread is loaded when constructing the processor; the engines of worker threads are loaded lazily when the
+ * thread processes its first file and destroyed when the thread exits.
+ *
+ * \remarks
+ * Nothing is shared between the engines: each engine has its own "settings" and "utility" globals (initialized the same way)
+ * and its own instance of the module. Hence state kept by the module (e.g. in module-level variables) is only visible
+ * to files processed by the same thread and is not carried over from one file to the next in any predictable way when
+ * processing files in parallel.
+ */
+class JavaScriptProcessor {
+public:
+    explicit JavaScriptProcessor(const SetTagInfoArgs &args);
+    JavaScriptProcessor(const JavaScriptProcessor &) = delete;
+
+    QJSValue callMain(MediaFileInfo &mediaFileInfo, Diagnostics &diag, std::ostream &out);
+
+private:
+    const SetTagInfoArgs &args;
+    int argc;
+    QCoreApplication app;
+    std::thread::id mainThread;
+    JavaScriptEngine mainEngine;
+    static thread_local std::unique_ptr<JavaScriptEngine> workerEngine;
+    static thread_local bool workerEngineLoaded;
+};
+
+thread_local std::unique_ptr<JavaScriptEngine> JavaScriptProcessor::workerEngine;
+thread_local bool JavaScriptProcessor::workerEngineLoaded = false;
+
 /*!
  * \brief Initializes JavaScript processing for the specified \a args.
  * \remarks
  * - Comes with its own QCoreApplication. Only for use within the CLI parts of the app!
- * - Exits the app on fatal errors.
+ * - Exits the app on fatal errors when loading the JavaScript file.
  * - Logs status/problems directly in accordance with other parts of the CLI.
  */
 JavaScriptProcessor::JavaScriptProcessor(const SetTagInfoArgs &args)
     : args(args)
     , argc(0)
     , app(argc, nullptr)
-    , utility(new UtilityObject(&engine))
+    , mainThread(std::this_thread::get_id())
+    , mainEngine(args)
 {
     // print status message
     const auto jsPath = args.jsArg.firstValue();
@@ -519,24 +697,100 @@ JavaScriptProcessor::JavaScriptProcessor(const SetTagInfoArgs &args)
         std::cout << TextAttribute::Bold << "Loading JavaScript file \"" << jsPath << "\" ..." << Phrases::EndFlush;
     }
 
-    // print warnings later via the usual helper function for consistent formatting
+    // load the JavaScript file within the main thread's engine to check whether it is usable at all before processing any files
+    auto diag = Diagnostics();
+    if (!mainEngine.load(diag)) {
+        std::cerr << Phrases::Error << "Unable to load the specified JavaScript file \"" << jsPath << "\":" << Phrases::End;
+        for (const auto &message : diag) {
+            if (message.level() >= DiagLevel::Critical) {
+                std::cerr << message.message() << '\n';
+            }
+        }
+        std::exit(EXIT_FAILURE);
+    }
+
+    // print warnings
+    printDiagMessages(diag, "Diagnostic messages:", args.verboseArg.isPresent(), &args.pedanticArg);
+}
+
+/*!
+ * \brief Calls the JavaScript's main() function for the specified \a mediaFileInfo using the engine of the current thread.
+ * \remarks
+ * - Loads the engine of the current thread first if not done yet. Problems when doing so are added to \a diag.
+ * - Messages logged by the JavaScript are written to \a out.
+ */
+QJSValue JavaScriptProcessor::callMain(MediaFileInfo &mediaFileInfo, Diagnostics &diag, std::ostream &out)
+{
+    if (std::this_thread::get_id() == mainThread) {
+        return mainEngine.callMain(mediaFileInfo, diag, out);
+    }
+    if (!workerEngine) {
+        workerEngine = std::make_unique<JavaScriptEngine>(args, true);
+        workerEngineLoaded = workerEngine->load(diag);
+    }
+    if (!workerEngineLoaded) {
+        diag.emplace_back(DiagLevel::Fatal, "Unable to load the specified JavaScript file.", "loading JavaScript");
+        return QJSValue();
+    }
+    return workerEngine->callMain(mediaFileInfo, diag, out);
+}
+
+/*!
+ * \brief Initializes a new engine for the specified \a args; call load() before using it.
+ * \remarks An engine for a \a workerThread comes with its own network access manager for the utility functions querying
+ *          meta-data as the global one must only be used from the main thread.
+ */
+JavaScriptEngine::JavaScriptEngine(const SetTagInfoArgs &args, bool workerThread)
+    : args(args)
+    , utility(new UtilityObject(&engine))
+{
+    if (workerThread) {
+        networkAccessManager = std::make_unique<QNetworkAccessManager>();
+        Utility::setNetworkAccessManagerForCurrentThread(networkAccessManager.get());
+    }
+}
+
+/*!
+ * \brief Destroys the engine (and its network access manager if it has one).
+ */
+JavaScriptEngine::~JavaScriptEngine()
+{
+    if (networkAccessManager) {
+        Utility::setNetworkAccessManagerForCurrentThread(nullptr);
+    }
+}
+
+/*!
+ * \brief Loads the JavaScript file specified via \a args populating \a diag.
+ * \returns Returns whether the JavaScript file could be loaded and exports a main() function.
+ */
+bool JavaScriptEngine::load(Diagnostics &diag)
+{
+    const auto jsPath = args.jsArg.firstValue();
+    const auto context = std::string("loading JavaScript");
+    if (!jsPath) {
+        return false;
+    }
+
+    // add warnings to diag for consistent formatting
     engine.setOutputWarningsToStandardError(false);
-    QObject::connect(&engine, &QQmlEngine::warnings, &engine,
-        [this, context = std::string("loading JavaScript")](const auto &warnings) { addWarnings(diag, context, warnings); });
+    const auto connection = QObject::connect(
+        &engine, &QQmlEngine::warnings, &engine, [&diag, &context](const auto &warnings) { addWarnings(diag, context, warnings); });
 
     // assign utility object and load specified JavaScript file as module
     engine.globalObject().setProperty(QStringLiteral("utility"), engine.newQObject(utility));
     module = engine.importModule(QString::fromUtf8(jsPath));
+    QObject::disconnect(connection);
     if (module.isError()) {
-        std::cerr << Phrases::Error << "Unable to load the specified JavaScript file \"" << jsPath << "\":" << Phrases::End;
-        std::cerr << "Uncaught exception at line " << module.property(QStringLiteral("lineNumber")).toInt() << ':' << ' '
-                  << module.toString().toStdString() << '\n';
-        std::exit(EXIT_FAILURE);
+        diag.emplace_back(DiagLevel::Fatal,
+            argsToString("Uncaught exception at line ", module.property(QStringLiteral("lineNumber")).toInt(), ": ", module.toString().toStdString()),
+            context);
+        return false;
     }
     main = module.property(QStringLiteral("main"));
     if (!main.isCallable()) {
-        std::cerr << Phrases::Error << "The specified JavaScript file \"" << jsPath << "\" does not export a main() function." << Phrases::End;
-        std::exit(EXIT_FAILURE);
+        diag.emplace_back(DiagLevel::Fatal, "The JavaScript file does not export a main() function.", context);
+        return false;
     }
 
     // assign settings specified via CLI argument
@@ -552,22 +806,21 @@ JavaScriptProcessor::JavaScriptProcessor(const SetTagInfoArgs &args)
         }
     }
     engine.globalObject().setProperty(QStringLiteral("settings"), settings);
-
-    // print warnings
-    printDiagMessages(diag, "Diagnostic messages:", args.verboseArg.isPresent(), &args.pedanticArg);
-    diag.clear();
+    return true;
 }
 
 /*!
  * \brief Calls the JavaScript's main() function for the specified \a mediaFileInfo populating \a diag.
  * \returns Returns what the main() function has returned.
  */
-QJSValue JavaScriptProcessor::callMain(MediaFileInfo &mediaFileInfo, Diagnostics &diag)
+QJSValue JavaScriptEngine::callMain(MediaFileInfo &mediaFileInfo, Diagnostics &diag, std::ostream &out)
 {
     auto fileInfoObject = MediaFileInfoObject(mediaFileInfo, diag, &engine, args.quietArg.isPresent());
+    fileInfoObject.setOutput(&out);
     auto fileInfoObjectValue = engine.newQObject(&fileInfoObject);
     auto context = argsToString("executing JavaScript for ", mediaFileInfo.fileName());
     utility->setDiag(&context, &diag);
+    utility->setOutput(&out);
     QObject::connect(
         &engine, &QQmlEngine::warnings, &fileInfoObject, [&diag, &context](const auto &warnings) { addWarnings(diag, context, warnings); });
     diag.emplace_back(DiagLevel::Information, "entering main() function", context);
@@ -580,27 +833,171 @@ QJSValue JavaScriptProcessor::callMain(MediaFileInfo &mediaFileInfo, Diagnostics
     } else {
         diag.emplace_back(DiagLevel::Debug, "done without return value", context);
     }
+    utility->setOutput(&std::cout);
+    utility->setDiag(nullptr, nullptr);
     return res;
 }
 
 /*!
  * \brief Adds the \a warnings to the specified \a diag object with the specified \a context.
  */
-void JavaScriptProcessor::addWarnings(Diagnostics &diag, const string &context, const QList<QQmlError> &warnings)
+void JavaScriptEngine::addWarnings(Diagnostics &diag, const string &context, const QList<QQmlError> &warnings)
 {
     for (const auto &warning : warnings) {
         diag.emplace_back(DiagLevel::Warning, warning.toString().toStdString(), context);
     }
 }
+
+/// \brief Whether the JavaScript processor is kept alive after setTagInfo() returns (see keepJavaScriptEnginesAlive()).
+static auto keepingJavaScriptEnginesAlive = false;
+
+/*!
+ * \brief Returns a key identifying the script and settings specified via \a args (including the script's modification time
+ *        so a kept JavaScript processor is not used anymore after the script has been changed).
+ */
+static std::string javaScriptKey(const SetTagInfoArgs &args)
+{
+    const auto *const jsPath = args.jsArg.firstValue();
+    auto error = std::error_code();
+    auto key = argsToString(jsPath, '\0',
+        std::filesystem::last_write_time(std::filesystem::path(makeNativePath(jsPath)), error).time_since_epoch().count());
+    if (args.jsSettingsArg.isPresent()) {
+        for (const auto *const setting : args.jsSettingsArg.values()) {
+            key += '\0';
+            key += setting;
+        }
+    }
+    return key;
+}
+
+/*!
+ * \brief Returns the JavaScript processor to use for the specified \a args.
+ * \remarks
+ * - Creates a new processor owned by \a processor unless JavaScript engines are kept alive.
+ * - Otherwise the processor created by a previous invocation is re-used if the script and settings have not changed. It is
+ *   intentionally never destroyed as Qt's global state might already be gone when static objects are destroyed on exit.
+ */
+static JavaScriptProcessor *javaScriptProcessorFor(const SetTagInfoArgs &args, std::unique_ptr<JavaScriptProcessor> &processor)
+{
+    if (!keepingJavaScriptEnginesAlive) {
+        processor = std::make_unique<JavaScriptProcessor>(args);
+        return processor.get();
+    }
+    static auto *keptProcessor = static_cast<JavaScriptProcessor *>(nullptr);
+    static auto keptKey = std::string();
+    if (auto key = javaScriptKey(args); !keptProcessor || key != keptKey) {
+        delete keptProcessor; // only one QCoreApplication may exist at a time
+        keptProcessor = nullptr;
+        keptProcessor = new JavaScriptProcessor(args);
+        keptKey = std::move(key);
+    }
+    return keptProcessor;
+}
 #endif
 
+/*!
+ * \brief Keeps the JavaScript engine of the calling thread (with the script loaded) alive when setTagInfo() returns.
+ * \remarks
+ * - Subsequent invocations of setTagInfo() within the same process using the same script and settings use the already
+ *   loaded engine. This is used when serving requests so the script does not need to be loaded for each request.
+ * - State kept by the script (e.g. in module-level variables) is carried over to subsequent invocations.
+ */
+void keepJavaScriptEnginesAlive()
+{
+#ifdef TAGEDITOR_USE_JSENGINE
+    keepingJavaScriptEnginesAlive = true;
+#endif
+}
+
+/*!
+ * \brief The SetTagInfoJob struct holds the state for processing a single file within setTagInfo().
+ * \remarks
+ * - Instances are re-used for subsequent files.
+ * - When processing files in parallel, each worker thread operates on its own instance and the output is buffered
+ *   until the file is emitted so the output of different files is not interleaved.
+ */
+struct SetTagInfoJob {
+    explicit SetTagInfoJob(bool bufferOutput, bool showProgress);
+    void flushOutput();
+
+    MediaFileInfo fileInfo;
+    Diagnostics diag;
+    AbortableProgressFeedback applyProgress;
+    EditPlan::Selection selection;
+    std::optional<EditPlan> recordPlan;
+    ManifestRecord record;
+    std::vector<Tag *> tags;
+    std::ostringstream outBuffer, errBuffer;
+    std::ostream &out, &err;
+    FileProfile profile;
+    WritePlan plan;
+    CoverNormalizationStatistics coverStatistics;
+    int exitCode;
+    bool aborted;
+    bool unchanged;
+};
+
+SetTagInfoJob::SetTagInfoJob(bool bufferOutput, bool showProgress)
+    : applyProgress(showProgress ? AbortableProgressFeedback(logNextStep, logStepPercentage) : AbortableProgressFeedback())
+    , out(bufferOutput ? outBuffer : std::cout)
+    , err(bufferOutput ? errBuffer : std::cerr)
+    , exitCode(EXIT_SUCCESS)
+    , aborted(false)
+    , unchanged(false)
+{
+}
+
+/*!
+ * \brief Writes the buffered output (if any) to stdout/stderr.
+ */
+void SetTagInfoJob::flushOutput()
+{
+    if (const auto output = outBuffer.str(); !output.empty()) {
+        std::cout << output << std::flush;
+        outBuffer.str(std::string());
+    }
+    if (const auto output = errBuffer.str(); !output.empty()) {
+        std::cerr << output << std::flush;
+        errBuffer.str(std::string());
+    }
+}
+
+/*!
+ * \brief Removes the backup file the tag parser has created when rewriting the clone of an input file.
+ * \remarks The backup is just the unmodified clone so keeping it is pointless. It is only removed if it is actually the clone
+ *          (identified via \a cloneStatus) and not a copy (the backup directory is on a different file system) or an unrelated
+ *          file (the tag parser has chosen a different name).
+ */
+static void removeBackupOfClone(const MediaFileInfo &fileInfo, const FileStatus &cloneStatus)
+{
+    const auto clonePath = std::filesystem::path(makeNativePath(fileInfo.path()));
+    auto backupPath = clonePath;
+    if (const auto &backupDir = fileInfo.backupDirectory(); !backupDir.empty()) {
+        const auto dir = std::filesystem::path(makeNativePath(backupDir));
+        backupPath = (dir.is_absolute() ? dir : clonePath.parent_path() / dir) / clonePath.filename();
+    }
+    backupPath += ".bak";
+    const auto backupStatus = FileStatus::fromPath(backupPath.string().data());
+    if (backupStatus.valid && backupStatus.device == cloneStatus.device && backupStatus.inode == cloneStatus.inode) {
+        auto error = std::error_code();
+        std::filesystem::remove(backupPath, error);
+    }
+}
+
 /*!
  * \brief Implements the "set"-operation of the CLI.
  */
 void setTagInfo(const SetTagInfoArgs &args)
 {
-    // check whether files have been specified
-    if (!args.filesArg.isPresent() || args.filesArg.values().empty()) {
+    // check whether files have been specified (either directly or via a manifest)
+    const auto useManifest = args.manifestArg.isPresent();
+    if (useManifest) {
+        if (args.filesArg.isPresent() || args.outputFilesArg.isPresent()) {
+            std::cerr << Phrases::Error << "Files have been specified via --files/--output-files and --manifest." << Phrases::End
+                      << "note: Specify the input and output files within the manifest instead." << endl;
+            std::exit(EXIT_FAILURE);
+        }
+    } else if (!args.filesArg.isPresent() || args.filesArg.values().empty()) {
         std::cerr << Phrases::Error << "No files have been specified." << Phrases::EndFlush;
         std::exit(EXIT_FAILURE);
     }
@@ -609,18 +1006,19 @@ void setTagInfo(const SetTagInfoArgs &args)
         std::exit(EXIT_FAILURE);
     }
 
-    // get output files
+    // get input and output files
+    const auto &files = useManifest ? vector<const char *>() : args.filesArg.values();
     auto &outputFiles = args.outputFilesArg.isPresent() ? args.outputFilesArg.values() : vector<const char *>();
-    auto currentOutputFile = outputFiles.cbegin(), noMoreOutputFiles = outputFiles.cend();
 
     // parse field denotations and check whether there's an operation to be done (changing fields or some other settings)
-    auto fields = parseFieldDenotations(args.valuesArg, false);
-    if (fields.empty() && (!args.removeTargetArg.isPresent() || args.removeTargetArg.values().empty())
+    const auto fieldDenotations = parseFieldDenotations(args.valuesArg, false);
+    if (fieldDenotations.empty() && (!args.removeTargetArg.isPresent() || args.removeTargetArg.values().empty())
         && (!args.addAttachmentArg.isPresent() || args.addAttachmentArg.values().empty())
         && (!args.updateAttachmentArg.isPresent() || args.updateAttachmentArg.values().empty())
         && (!args.removeAttachmentArg.isPresent() || args.removeAttachmentArg.values().empty())
         && (!args.docTitleArg.isPresent() || args.docTitleArg.values().empty()) && !args.id3v1UsageArg.isPresent() && !args.id3v2UsageArg.isPresent()
-        && !args.id3v2VersionArg.isPresent() && !args.jsArg.isPresent()) {
+        && !args.id3v2VersionArg.isPresent() && !args.jsArg.isPresent() && !args.coverMaxSizeArg.isPresent() && !args.coverFormatArg.isPresent()
+        && !useManifest) {
         if (!args.layoutOnlyArg.isPresent()) {
             std::cerr << Phrases::Error << "No fields/attachments have been specified." << Phrases::End
                       << "note: This is usually a mistake. Use --layout-only to prevent this error and apply file layout options only." << endl;
@@ -632,6 +1030,14 @@ void setTagInfo(const SetTagInfoArgs &args)
         std::exit(EXIT_FAILURE);
     }
 
+    // compile the field denotations once so only the values relevant for the current file need to be selected per file
+    const auto coverTypeDelimiter = std::string_view(args.coverTypeDelimiterArg.firstValueOr(":"));
+    const auto editPlan = EditPlan(fieldDenotations, coverTypeDelimiter);
+    auto coverCache = CoverCache();
+    const auto coverNormalization = CoverNormalizationSettings::fromArgs(args.coverMaxSizeArg, args.coverFormatArg, args.coverQualityArg);
+    auto coverNormalizer
+        = coverNormalization.isEnabled() ? std::make_unique<CoverNormalizer>(coverNormalization) : std::unique_ptr<CoverNormalizer>();
+
     auto settings = TagCreationSettings();
     settings.flags = TagCreationFlags::None;
 
@@ -640,10 +1046,15 @@ void setTagInfo(const SetTagInfoArgs &args)
     for (size_t i = 0, max = args.removeTargetArg.occurrences(); i != max; ++i) {
         auto &target = targetsToRemove.emplace_back();
         for (const auto &targetDenotation : args.removeTargetArg.values(i)) {
-            if (!applyTargetConfiguration(target, targetDenotation)) {
-                std::cerr << Phrases::Error << "The given target specification \"" << targetDenotation << "\" is invalid." << Phrases::EndFlush;
-                std::exit(EXIT_FAILURE);
+            try {
+                if (applyTargetConfiguration(target, targetDenotation)) {
+                    continue;
+                }
+            } catch (const InvalidDenotationException &e) {
+                exitDueToInvalidDenotation(e);
             }
+            std::cerr << Phrases::Error << "The given target specification \"" << targetDenotation << "\" is invalid." << Phrases::EndFlush;
+            std::exit(EXIT_FAILURE);
         }
     }
 
@@ -684,36 +1095,10 @@ void setTagInfo(const SetTagInfoArgs &args)
     settings.id3v1usage = parseUsageDenotation(args.id3v1UsageArg, TagUsage::KeepExisting);
     settings.id3v2usage = parseUsageDenotation(args.id3v2UsageArg, TagUsage::Always);
 
-    // setup media file info
-    auto fileInfo = MediaFileInfo();
-    auto tags = std::vector<Tag *>();
-    fileInfo.setMinPadding(parseUInt64(args.minPaddingArg, 0));
-    fileInfo.setMaxPadding(parseUInt64(args.maxPaddingArg, 0));
-    fileInfo.setPreferredPadding(parseUInt64(args.prefPaddingArg, 0));
-    fileInfo.setTagPosition(parsePositionDenotation(args.tagPosArg, args.tagPosValueArg, ElementPosition::BeforeData));
-    fileInfo.setForceTagPosition(args.forceTagPosArg.isPresent());
-    fileInfo.setIndexPosition(parsePositionDenotation(args.indexPosArg, args.indexPosValueArg, ElementPosition::BeforeData));
-    fileInfo.setForceIndexPosition(args.forceIndexPosArg.isPresent());
-    fileInfo.setForceRewrite(args.forceRewriteArg.isPresent());
-    fileInfo.setWritingApplication(APP_NAME " v" APP_VERSION);
-    if (args.preserveMuxingAppArg.isPresent()) {
-        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::PreserveMuxingApplication);
-    }
-    if (args.preserveWritingAppArg.isPresent()) {
-        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::PreserveWritingApplication);
-    }
-    if (!args.preserveTotalFieldsArg.isPresent()) {
-        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::ConvertTotalFields);
-    }
-
-    // set backup path
-    if (args.backupDirArg.isPresent()) {
-        fileInfo.setBackupDirectory(std::string(args.backupDirArg.values().front()));
-    }
-
     // initialize JavaScript processing if --java-script argument is present
 #ifdef TAGEDITOR_USE_JSENGINE
-    auto js = args.jsArg.isPresent() ? std::make_unique<JavaScriptProcessor>(args) : std::unique_ptr<JavaScriptProcessor>();
+    auto ownJs = std::unique_ptr<JavaScriptProcessor>();
+    auto *const js = args.jsArg.isPresent() ? javaScriptProcessorFor(args, ownJs) : nullptr;
 #else
     if (args.jsArg.isPresent()) {
         std::cerr << Phrases::Error << "A JavaScript has been specified but support for this has been disabled at compile-time." << Phrases::EndFlush;
@@ -721,30 +1106,170 @@ void setTagInfo(const SetTagInfoArgs &args)
     }
 #endif
 
-    // iterate through all specified files
+    // parse file layout settings
+    auto layout = WritePlanSettings();
+    layout.minPadding = parseUInt64(args.minPaddingArg, 0);
+    layout.maxPadding = parseUInt64(args.maxPaddingArg, 0);
+    layout.preferredPadding = parseUInt64(args.prefPaddingArg, 0);
+    layout.tagPosition = parsePositionDenotation(args.tagPosArg, args.tagPosValueArg, ElementPosition::BeforeData);
+    layout.forceTagPosition = args.forceTagPosArg.isPresent();
+    layout.indexPosition = parsePositionDenotation(args.indexPosArg, args.indexPosValueArg, ElementPosition::BeforeData);
+    layout.forceIndexPosition = args.forceIndexPosArg.isPresent();
+    layout.forceRewrite = args.forceRewriteArg.isPresent();
+    const auto planning = args.planArg.isPresent();
+    // note: Files are always written if only the layout is supposed to be changed or attachments are altered (as attachments
+    //       are not covered by the fingerprint).
+    const auto detectUnchangedFiles = !args.layoutOnlyArg.isPresent() && !layout.forceTagPosition && !layout.forceIndexPosition
+        && !args.addAttachmentArg.isPresent() && !args.updateAttachmentArg.isPresent() && !args.removeAttachmentArg.isPresent()
+        && !args.removeExistingAttachmentsArg.isPresent();
+    // note: Input files are not cloned when using a JavaScript as it might rely on the path of the file being the input file.
+    const auto cloneInputFiles = !args.noCloneArg.isPresent() && !args.jsArg.isPresent() && !planning && !layout.forceRewrite;
+
+    // parse padding policy and load the edit history if specified
+    auto adaptivePadding = false;
+    if (args.paddingPolicyArg.isPresent()) {
+        const auto policy = std::string_view(args.paddingPolicyArg.values().front());
+        if (policy == "adaptive") {
+            adaptivePadding = true;
+        } else if (policy != "fixed") {
+            std::cerr << Phrases::Error << "The specified padding policy \"" << policy << "\" is invalid." << Phrases::End
+                      << "note: Valid policies are fixed and adaptive." << endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    auto editHistory = std::optional<EditHistory>();
+    if (args.paddingHistoryArg.isPresent()) {
+        if (!adaptivePadding) {
+            std::cerr << Phrases::Error << "An edit history has been specified but the padding policy is not adaptive." << Phrases::End
+                      << "note: Add --padding-policy adaptive to use the edit history." << endl;
+            std::exit(EXIT_FAILURE);
+        }
+        editHistory.emplace(args.paddingHistoryArg.values().front());
+    }
+
+    // restore files from pending journals before modifying any files if a journal has been specified
+    auto journal = std::optional<WriteJournal>();
+    if (args.journalArg.isPresent() && !planning) {
+        journal.emplace(args.journalArg.values().front());
+        journal->recoverPending();
+    }
+
+    // determine how many files to process in parallel
+    const auto jobCount = parseJobCount(args.jobsArg);
     const auto quiet = args.quietArg.isPresent();
-    auto fileIndex = 0u;
-    static auto context = std::string("setting tags");
-    const auto continueWithNextFile = [&](Diagnostics &diag) {
-        printDiagMessages(diag, "Diagnostic messages:", args.verboseArg.isPresent(), &args.pedanticArg);
-        ++fileIndex;
-        if (currentOutputFile != noMoreOutputFiles) {
-            ++currentOutputFile;
+    const auto parallel = jobCount > 1 && (useManifest || files.size() > 1);
+
+    // setup media file info for each job
+    // note: Records of a manifest are read into the job processing them so the manifest does not need to be loaded completely.
+    auto jobs = std::deque<SetTagInfoJob>();
+    for (auto i = slotCountFor(jobCount, useManifest ? std::numeric_limits<std::size_t>::max() : files.size()); i; --i) {
+        auto &fileInfo = jobs.emplace_back(parallel, !quiet && !parallel).fileInfo;
+        fileInfo.setMinPadding(layout.minPadding);
+        fileInfo.setMaxPadding(layout.maxPadding);
+        fileInfo.setPreferredPadding(layout.preferredPadding);
+        fileInfo.setTagPosition(layout.tagPosition);
+        fileInfo.setForceTagPosition(layout.forceTagPosition);
+        fileInfo.setIndexPosition(layout.indexPosition);
+        fileInfo.setForceIndexPosition(layout.forceIndexPosition);
+        fileInfo.setForceRewrite(layout.forceRewrite);
+        fileInfo.setWritingApplication(APP_NAME " v" APP_VERSION);
+        if (args.preserveMuxingAppArg.isPresent()) {
+            fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::PreserveMuxingApplication);
         }
-    };
-    for (const char *file : args.filesArg.values()) {
-        auto diag = Diagnostics();
+        if (args.preserveWritingAppArg.isPresent()) {
+            fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::PreserveWritingApplication);
+        }
+        if (!args.preserveTotalFieldsArg.isPresent()) {
+            fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::ConvertTotalFields);
+        }
+
+        // set backup path
+        if (args.backupDirArg.isPresent()) {
+            fileInfo.setBackupDirectory(std::string(args.backupDirArg.values().front()));
+        }
+    }
+
+    // allow aborting all ongoing jobs at once when processing files in parallel
+    auto parallelInterruptHandler = std::optional<InterruptHandler>();
+    if (parallel) {
+        parallelInterruptHandler.emplace([&jobs] {
+            for (auto &job : jobs) {
+                job.applyProgress.tryToAbort();
+            }
+        });
+    }
+
+    // iterate through all specified files
+    auto profiler = Profiler(args.profileArg);
+    auto planSummary = WritePlanSummary();
+    static auto context = std::string("setting tags");
+    const auto processFile = [&](std::size_t fileIndex, const char *file, const char *outputFile, ManifestRecord *record, SetTagInfoJob &job) {
+        auto &fileInfo = job.fileInfo;
+        auto &diag = job.diag;
+        auto &selection = job.selection;
+        auto &tags = job.tags;
+        auto &out = job.out, &err = job.err;
+        auto fileSettings = settings;
         auto parsingProgress = AbortableProgressFeedback(); // FIXME: actually use the progress object
+        diag.clear();
+        job.exitCode = EXIT_SUCCESS;
+        job.aborted = false;
+        job.unchanged = false;
+        job.plan.clear();
+        job.coverStatistics = CoverNormalizationStatistics();
+        auto timer = ProfileTimer(profiler.profile(job.profile), file);
+        auto cloned = false;
+        auto inputFile = file, saveFile = outputFile;
+        auto journalPath = std::string();
+        const auto rollBackJournal = [&] {
+            if (journalPath.empty()) {
+                return;
+            }
+            try {
+                journal->rollBack(journalPath);
+                err << " - Changes have been rolled back via the journal." << endl;
+            } catch (const std::ios_base::failure &e) {
+                err << " - " << Phrases::Error << "Unable to roll back changes via the journal \"" << journalPath << "\": " << e.what()
+                    << Phrases::EndFlush;
+                job.exitCode = EXIT_IO_FAILURE;
+            }
+            journalPath.clear();
+        };
+        const auto discardClone = [&] {
+            if (cloned) {
+                auto error = std::error_code();
+                std::filesystem::remove(makeNativePath(outputFile), error);
+                cloned = false;
+            }
+        };
         try {
             // parse tags and tracks (tracks are relevant because track meta-data such as language can be changed as well)
-            if (!quiet) {
-                cout << TextAttribute::Bold << "Setting tag information for \"" << file << "\" ..." << Phrases::EndFlush;
+            if (!quiet || planning) {
+                out << TextAttribute::Bold << "Setting tag information for \"" << file << "\" ..." << Phrases::EndFlush;
             }
-            fileInfo.setPath(std::string(file));
+            // clone the file to the output file if supported by the file system and update the clone in-place
+            // note: This way only the modified regions need to be written (unless the changes do not fit into the padding).
+            cloned = outputFile && cloneInputFiles && cloneFile(file, outputFile);
+            inputFile = cloned ? outputFile : file;
+            saveFile = cloned ? nullptr : outputFile;
+            // note: Tracks and attachments can not be skipped even if no track/attachment denotations have been specified
+            //       because applying changes requires parsed tracks and attachments are rewritten when writing Matroska files.
+            fileInfo.setPath(std::string(inputFile));
             fileInfo.parseContainerFormat(diag, parsingProgress);
+            timer.mark(ProfilePhase::ParseContainerFormat);
             fileInfo.parseTags(diag, parsingProgress);
+            timer.mark(ProfilePhase::ParseTags);
             fileInfo.parseTracks(diag, parsingProgress);
+            timer.mark(ProfilePhase::ParseTracks);
             fileInfo.parseAttachments(diag, parsingProgress);
+            timer.mark(ProfilePhase::ParseAttachments);
+            if (planning) {
+                job.plan.currentMetaDataSize = computeMetaDataSize(fileInfo);
+                timer.skip();
+            }
+            const auto originalFingerprint = detectUnchangedFiles && (!record || record->attachments.empty())
+                ? computeMetaDataFingerprint(fileInfo)
+                : std::optional<std::uint64_t>();
 
             // remove tags with the specified targets
             if (!targetsToRemove.empty()) {
@@ -758,47 +1283,39 @@ void setTagInfo(const SetTagInfoArgs &args)
             }
 
             // select the relevant values for the current file index
-            for (auto &fieldDenotation : fields) {
-                FieldValues &denotedValues = fieldDenotation.second;
-                std::vector<FieldValue *> &relevantDenotedValues = denotedValues.relevantValues;
-                relevantDenotedValues.clear();
-                unsigned int currentFileIndex = 0;
-                for (FieldValue &denotatedValue : denotedValues.allValues) {
-                    if ((denotatedValue.fileIndex <= fileIndex)
-                        && (relevantDenotedValues.empty() || (denotatedValue.fileIndex >= currentFileIndex))) {
-                        if (currentFileIndex != denotatedValue.fileIndex) {
-                            currentFileIndex = denotatedValue.fileIndex;
-                            relevantDenotedValues.clear();
-                        }
-                        relevantDenotedValues.push_back(&denotatedValue);
-                    }
-                }
+            // note: Values specified via the manifest take precedence; they are compiled into a plan of their own (and are selected
+            //       as if only a single file was specified).
+            job.recordPlan.reset();
+            if (record && !record->fields.empty()) {
+                job.recordPlan.emplace(fieldDenotations, coverTypeDelimiter, &record->fields);
             }
+            const auto &fileEditPlan = job.recordPlan.has_value() ? job.recordPlan.value() : editPlan;
+            const auto &planFields = fileEditPlan.fields();
+            fileEditPlan.select(static_cast<unsigned int>(fileIndex), selection);
 
             // determine required targets
-            settings.requiredTargets.clear();
-            for (const auto &fieldDenotation : fields) {
-                const FieldScope &scope = fieldDenotation.first;
+            for (auto fieldIndex = std::size_t(); fieldIndex != planFields.size(); ++fieldIndex) {
+                const FieldScope &scope = planFields[fieldIndex].scope;
                 if (scope.isTrack() || !scope.exactTargetMatching) {
                     continue;
                 }
-                const std::vector<FieldValue *> &relevantDenotedValues = fieldDenotation.second.relevantValues;
                 auto hasNonEmptyValues = false;
-                for (const auto &value : relevantDenotedValues) {
+                for (const auto *const value : selection[fieldIndex]) {
                     if (!value->value.empty()) {
                         hasNonEmptyValues = true;
                         break;
                     }
                 }
                 if (hasNonEmptyValues
-                    && std::find(settings.requiredTargets.cbegin(), settings.requiredTargets.cend(), scope.tagTarget)
-                        == settings.requiredTargets.cend()) {
-                    settings.requiredTargets.emplace_back(scope.tagTarget);
+                    && std::find(fileSettings.requiredTargets.cbegin(), fileSettings.requiredTargets.cend(), scope.tagTarget)
+                        == fileSettings.requiredTargets.cend()) {
+                    fileSettings.requiredTargets.emplace_back(scope.tagTarget);
                 }
             }
 
             // create new tags according to settings
-            fileInfo.createAppropriateTags(settings);
+            fileInfo.createAppropriateTags(fileSettings);
+            timer.mark(ProfilePhase::CreateTags);
             auto container = fileInfo.container();
             if (args.docTitleArg.isPresent() && !args.docTitleArg.values().empty()) {
                 if (container && container->supportsTitle()) {
@@ -822,20 +1339,20 @@ void setTagInfo(const SetTagInfoArgs &args)
             // process tag fields via the specified JavaScript
 #ifdef TAGEDITOR_USE_JSENGINE
             if (js) {
-                const auto res = js->callMain(fileInfo, diag);
+                timer.mark(ProfilePhase::ModifyTags);
+                const auto res = js->callMain(fileInfo, diag, out);
+                timer.mark(ProfilePhase::Script);
                 if (res.isError() || diag.has(DiagLevel::Fatal)) {
                     if (!quiet) {
-                        std::cout << " - Skipping file due to fatal error when executing JavaScript.\n";
+                        out << " - Skipping file due to fatal error when executing JavaScript.\n";
                     }
-                    continueWithNextFile(diag);
-                    continue;
+                    return;
                 }
                 if (!res.isUndefined() && !res.toBool()) {
                     if (!quiet) {
-                        std::cout << " - Skipping file because JavaScript returned a falsy value other than undefined.\n";
+                        out << " - Skipping file because JavaScript returned a falsy value other than undefined.\n";
                     }
-                    continueWithNextFile(diag);
-                    continue;
+                    return;
                 }
             }
 #endif
@@ -868,12 +1385,11 @@ void setTagInfo(const SetTagInfoArgs &args)
                                 context);
                         }
                     }
-                    // iterate through all denoted field values
-                    for (const auto &fieldDenotation : fields) {
-                        const FieldScope &denotedScope = fieldDenotation.first;
+                    // iterate through all denoted field values which might be relevant for the tag type
+                    for (const auto fieldIndex : fileEditPlan.fieldsForTagType(tagType)) {
+                        const FieldScope &denotedScope = planFields[fieldIndex].scope;
                         // skip values which scope does not match the current tag
-                        if (denotedScope.isTrack() || !(denotedScope.tagType == TagType::Unspecified || (denotedScope.tagType & tagType))
-                            || !(!targetSupported || (tagType == TagType::OggVorbisComment && denotedScope.tagTarget.isEmpty())
+                        if (!(!targetSupported || (tagType == TagType::OggVorbisComment && denotedScope.tagTarget.isEmpty())
                                 || (denotedScope.exactTargetMatching ? denotedScope.tagTarget == tagTarget
                                                                      : denotedScope.tagTarget.matches(tagTarget)))) {
                             continue;
@@ -881,16 +1397,17 @@ void setTagInfo(const SetTagInfoArgs &args)
                         // convert the values to TagValue
                         auto convertedValues = std::vector<TagValue>();
                         auto convertedId3v2CoverValues = std::vector<Id3v2Cover>();
-                        for (const FieldValue *relevantDenotedValue : fieldDenotation.second.relevantValues) {
+                        for (const EditPlan::Value *relevantDenotedValue : selection[fieldIndex]) {
                             // assign an empty TagValue to remove the field if denoted value is empty
                             if (relevantDenotedValue->value.empty()) {
                                 convertedValues.emplace_back();
                                 continue;
                             }
-                            // add text value
+                            // add text value (usually converted to the used encoding already when compiling the plan)
                             if (relevantDenotedValue->type != DenotationType::File) {
                                 try {
-                                    convertedValues.emplace_back(relevantDenotedValue->value, TagTextEncoding::Utf8, usedEncoding);
+                                    convertedValues.emplace_back(
+                                        relevantDenotedValue->toTagValue(static_cast<unsigned int>(fileIndex), usedEncoding));
                                 } catch (const ConversionException &e) {
                                     diag.emplace_back(DiagLevel::Critical,
                                         argsToString("Unable to parse value specified for field \"", denotedScope.field.name(), "\": ", e.what()),
@@ -899,40 +1416,23 @@ void setTagInfo(const SetTagInfoArgs &args)
                                 continue;
                             }
                             // add value from file
-                            const auto denotedValue = relevantDenotedValue->value;
-                            const auto firstPartIsDriveLetter = denotedValue.size() >= 2 && denotedValue[1] == ':' ? 1u : 0u;
-                            const auto maxParts = std::size_t(3u + firstPartIsDriveLetter);
-                            const auto parts = splitStringSimple<std::vector<std::string_view>>(
-                                denotedValue, args.coverTypeDelimiterArg.firstValueOr(":"), static_cast<int>(maxParts));
-                            const auto path = parts.empty()
-                                ? std::string_view()
-                                : (firstPartIsDriveLetter ? std::string_view(denotedValue.data(), parts[0].size() + parts[1].size() + 1)
-                                                          : parts.front());
+                            const auto &path = relevantDenotedValue->path;
                             const auto fieldType = denotedScope.field.knownFieldForTag(tag, tagType);
                             const auto dataType = fieldType == KnownField::Cover ? TagDataType::Picture : TagDataType::Text;
                             try {
                                 // assume the file refers to a picture
                                 auto value = TagValue();
                                 if (!path.empty()) {
-                                    auto coverFileInfo = MediaFileInfo(path);
-                                    auto coverDiag = Diagnostics();
-                                    auto coverProgress = AbortableProgressFeedback(); // FIXME: actually use the progress object
-                                    coverFileInfo.open(true);
-                                    coverFileInfo.parseContainerFormat(coverDiag, coverProgress);
-                                    auto buff = make_unique<char[]>(coverFileInfo.size());
-                                    coverFileInfo.stream().seekg(static_cast<streamoff>(0));
-                                    coverFileInfo.stream().read(buff.get(), static_cast<streamoff>(coverFileInfo.size()));
-                                    value = TagValue(std::move(buff), coverFileInfo.size(), dataType, TagTextEncoding::Utf8);
-                                    value.setMimeType(coverFileInfo.mimeType());
+                                    value = coverCache.get(path)->toTagValue(dataType);
                                 }
                                 auto description = std::optional<std::string_view>();
-                                if (parts.size() > 2u + firstPartIsDriveLetter) {
-                                    description = parts[2 + firstPartIsDriveLetter];
+                                if (relevantDenotedValue->description.has_value()) {
+                                    description = relevantDenotedValue->description.value();
                                     value.setDescription(description.value(), TagTextEncoding::Utf8);
                                 }
-                                if (parts.size() > 1u + firstPartIsDriveLetter && fieldType == KnownField::Cover
+                                if (relevantDenotedValue->coverType.has_value() && fieldType == KnownField::Cover
                                     && (tagType == TagType::Id3v2Tag || tagType == TagType::VorbisComment || tagType == TagType::OggVorbisComment)) {
-                                    const auto typeSpec = parts[1 + firstPartIsDriveLetter];
+                                    const auto &typeSpec = relevantDenotedValue->coverType.value();
                                     const auto coverType = id3v2CoverType(typeSpec);
                                     if (coverType == invalidCoverType) {
                                         diag.emplace_back(DiagLevel::Warning,
@@ -942,10 +1442,11 @@ void setTagInfo(const SetTagInfoArgs &args)
                                         convertedId3v2CoverValues.emplace_back(std::move(value), coverType, description);
                                     }
                                 } else {
-                                    if (parts.size() > 1u + firstPartIsDriveLetter) {
+                                    if (relevantDenotedValue->coverType.has_value()) {
                                         diag.emplace_back(
                                             tag->type() == TagType::Id3v1Tag && fileInfo.hasId3v2Tag() ? DiagLevel::Information : DiagLevel::Warning,
-                                            argsToString("Ignoring cover type \"", parts[1 + firstPartIsDriveLetter], "\" for ", tag->typeName(),
+                                            argsToString("Ignoring cover type \"", relevantDenotedValue->coverType.value(), "\" for ",
+                                                tag->typeName(),
                                                 ". It is only supported by the cover field and the tag formats ID3v2 and Vorbis Comment."),
                                             context);
                                     }
@@ -993,24 +1494,35 @@ void setTagInfo(const SetTagInfoArgs &args)
                 }
             }
 
+            // normalize covers (the ones which have just been set as well as the ones which were already present)
+            if (coverNormalizer) {
+                for (auto *const tag : tags) {
+                    coverNormalizer->normalize(tag, job.coverStatistics);
+                }
+                if (job.coverStatistics.covers && !quiet) {
+                    out << " - Normalized " << job.coverStatistics.covers << " cover(s) from "
+                        << dataSizeToString(job.coverStatistics.bytesBefore) << " to " << dataSizeToString(job.coverStatistics.bytesAfter) << '\n';
+                }
+            }
+
             // alter tracks
             for (AbstractTrack *const track : fileInfo.tracks()) {
-                for (const auto &fieldDenotation : fields) {
+                for (const auto fieldIndex : fileEditPlan.trackFields()) {
                     // skip empty values
-                    const auto &values = fieldDenotation.second.relevantValues;
+                    const auto &values = selection[fieldIndex];
                     if (values.empty()) {
                         continue;
                     }
 
                     // skip values which scope does not match the current track
-                    const FieldScope &denotedScope = fieldDenotation.first;
+                    const FieldScope &denotedScope = planFields[fieldIndex].scope;
                     if (!denotedScope.allTracks
                         && find(denotedScope.trackIds.cbegin(), denotedScope.trackIds.cend(), track->id()) == denotedScope.trackIds.cend()) {
                         continue;
                     }
 
                     const FieldId &field = denotedScope.field;
-                    const string &value = values.front()->value;
+                    const auto value = values.front()->text(static_cast<unsigned int>(fileIndex));
                     try {
                         if (field.denotes("name")) {
                             track->setName(value);
@@ -1037,18 +1549,9 @@ void setTagInfo(const SetTagInfoArgs &args)
                 }
             }
 
-            // increment relevant values
-            for (auto &fieldDenotation : fields) {
-                for (FieldValue *relevantDenotedValue : fieldDenotation.second.relevantValues) {
-                    if (!relevantDenotedValue->value.empty() && relevantDenotedValue->type == DenotationType::Increment) {
-                        relevantDenotedValue->value = incremented(relevantDenotedValue->value);
-                    }
-                }
-            }
-
             // alter attachments
             if (args.addAttachmentArg.isPresent() || args.updateAttachmentArg.isPresent() || args.removeAttachmentArg.isPresent()
-                || args.removeExistingAttachmentsArg.isPresent()) {
+                || args.removeExistingAttachmentsArg.isPresent() || (record && !record->attachments.empty())) {
                 static const string attachmentsContext("setting attachments");
                 fileInfo.parseAttachments(diag, parsingProgress);
                 if (fileInfo.attachmentsParsingStatus() == ParsingStatus::Ok && container) {
@@ -1081,6 +1584,15 @@ void setTagInfo(const SetTagInfoArgs &args)
                         }
                         currentInfo.next(container, diag);
                     }
+                    if (record) {
+                        for (const auto &attachment : record->attachments) {
+                            currentInfo.action = attachment.action;
+                            for (const auto &value : attachment.denotations) {
+                                currentInfo.parseDenotation(value.data());
+                            }
+                            currentInfo.next(container, diag);
+                        }
+                    }
                 } else if (fileInfo.attachmentsParsingStatus() == ParsingStatus::NotSupported) {
                     diag.emplace_back(
                         DiagLevel::Critical, "Unable to assign attachments because that is not supported for the file's format.", attachmentsContext);
@@ -1090,36 +1602,105 @@ void setTagInfo(const SetTagInfoArgs &args)
                 }
             }
 
-            // apply changes
+            // determine the padding for the file if the adaptive padding policy is used
+            auto fileLayout = layout;
+            if (adaptivePadding) {
+                const auto padding
+                    = computeAdaptivePadding(fileInfo, editHistory ? editHistory->editCount(file) : 0, layout, args.maxPaddingArg.isPresent());
+                fileInfo.setPreferredPadding(fileLayout.preferredPadding = padding.preferred);
+                fileInfo.setMaxPadding(fileLayout.maxPadding = padding.max);
+            }
+
+            // skip the file if applying the changes would not alter its meta-data
+            // note: Output files need to be written anyways unless the file has been cloned to the output file.
+            timer.mark(ProfilePhase::ModifyTags);
+            if (originalFingerprint && (!outputFile || cloned) && computeMetaDataFingerprint(fileInfo) == originalFingerprint) {
+                timer.skip();
+                job.unchanged = job.plan.unchanged = job.profile.unchanged = true;
+                if (planning) {
+                    job.plan.valid = true;
+                    printWritePlan(out, job.plan);
+                } else if (!quiet) {
+                    out << " - Unchanged; the file has not been written." << endl;
+                }
+                return;
+            }
+
+            // apply changes (or just determine how they would be applied if only a plan has been requested)
+            if (planning) {
+                planWrite(job.plan, fileInfo, fileLayout, saveFile, diag);
+                printWritePlan(out, job.plan);
+                return;
+            }
             auto modificationDateError = std::error_code();
             auto modificationDate = std::filesystem::file_time_type();
             auto modifiedFilePath = std::filesystem::path();
-            fileInfo.setSaveFilePath(currentOutputFile != noMoreOutputFiles ? string(*currentOutputFile) : string());
+            fileInfo.setSaveFilePath(saveFile ? string(saveFile) : string());
             if (args.preserveModificationTimeArg.isPresent()) {
                 modifiedFilePath = makeNativePath(fileInfo.saveFilePath().empty() ? fileInfo.path() : fileInfo.saveFilePath());
                 modificationDate = std::filesystem::last_write_time(modifiedFilePath, modificationDateError);
             }
+            // save the regions which might be overwritten when updating the file in-place to the journal
+            // note: The journal is written regardless of whether the file will be rewritten completely as only the tag parser knows
+            //       for sure. It is cheap as the media data is not saved and it is discarded when recovering if the file has been
+            //       replaced by a rewritten one.
+            if (journal && !outputFile) {
+                auto regions = std::vector<JournalRegion>();
+                if (determineRegionsToJournal(fileInfo, diag, regions)) {
+                    journalPath = journal->begin(file, regions);
+                } else {
+                    diag.emplace_back(DiagLevel::Warning,
+                        "Unable to determine the regions to journal for this format; the file is updated without journal.", context);
+                }
+            }
+            // note: When the file is rewritten completely it is replaced by a new file so the inode changes (only detected under UNIX).
+            const auto statusBeforeApplying = (profiler.isEnabled() || cloned) && !saveFile ? FileStatus::fromPath(inputFile) : FileStatus();
             try {
-                // create handler for progress updates and aborting
-                auto applyProgress = quiet ? AbortableProgressFeedback() : AbortableProgressFeedback(logNextStep, logStepPercentage);
-                const auto handler = InterruptHandler(std::bind(&AbortableProgressFeedback::tryToAbort, std::ref(applyProgress)));
+                // apply changes (registering a handler for aborting unless one has been registered for all jobs)
+                if (parallel) {
+                    fileInfo.applyChanges(diag, job.applyProgress);
+                } else {
+                    const auto handler = InterruptHandler(std::bind(&AbortableProgressFeedback::tryToAbort, std::ref(job.applyProgress)));
+                    fileInfo.applyChanges(diag, job.applyProgress);
+                }
+                timer.mark(ProfilePhase::ApplyChanges);
+                if (profiler.isEnabled() || cloned) {
+                    const auto statusAfterApplying = saveFile ? FileStatus() : FileStatus::fromPath(inputFile);
+                    const auto rewritten = saveFile || statusBeforeApplying.inode != statusAfterApplying.inode
+                        || statusBeforeApplying.device != statusAfterApplying.device;
+                    if (cloned && rewritten) {
+                        removeBackupOfClone(fileInfo, statusBeforeApplying);
+                    }
+                    job.profile.rewritten = rewritten;
+                    job.profile.cloned = cloned;
+                }
 
-                // apply changes
-                fileInfo.applyChanges(diag, applyProgress);
+                if (!journalPath.empty()) {
+                    journal->commit(journalPath, file);
+                    journalPath.clear();
+                }
+                if (editHistory) {
+                    editHistory->recordEdit(outputFile ? outputFile : file);
+                }
 
                 // notify about completion
                 finalizeLog();
                 if (!quiet) {
-                    cout << " - Changes have been applied." << endl;
+                    out << " - Changes have been applied." << endl;
                 }
             } catch (const TagParser::OperationAbortedException &) {
                 finalizeLog();
-                cerr << Phrases::Warning << "The operation has been aborted." << Phrases::EndFlush;
+                err << Phrases::Warning << "The operation has been aborted." << Phrases::EndFlush;
+                rollBackJournal();
+                discardClone();
+                job.aborted = true;
                 return;
             } catch (const TagParser::Failure &) {
                 finalizeLog();
-                cerr << " - " << Phrases::Error << "Failed to apply changes." << Phrases::EndFlush;
-                exitCode = EXIT_PARSING_FAILURE;
+                err << " - " << Phrases::Error << "Failed to apply changes." << Phrases::EndFlush;
+                rollBackJournal();
+                discardClone();
+                job.exitCode = EXIT_PARSING_FAILURE;
             }
             if (args.preserveModificationTimeArg.isPresent()) {
                 if (!modificationDateError) {
@@ -1131,20 +1712,96 @@ void setTagInfo(const SetTagInfoArgs &args)
             }
         } catch (const TagParser::Failure &) {
             finalizeLog();
-            cerr << " - " << Phrases::Error << "A parsing failure occurred when reading/writing the file \"" << file << "\"." << Phrases::EndFlush;
-            exitCode = EXIT_PARSING_FAILURE;
+            err << " - " << Phrases::Error << "A parsing failure occurred when reading/writing the file \"" << file << "\"." << Phrases::EndFlush;
+            job.exitCode = EXIT_PARSING_FAILURE;
+            rollBackJournal();
+            discardClone();
         } catch (const std::ios_base::failure &e) {
             finalizeLog();
-            cerr << " - " << Phrases::Error << "An IO error occurred when reading/writing the file \"" << file << "\": " << e.what()
-                 << Phrases::EndFlush;
-            exitCode = EXIT_IO_FAILURE;
+            err << " - " << Phrases::Error << "An IO error occurred when reading/writing the file \"" << file << "\": " << e.what()
+                << Phrases::EndFlush;
+            job.exitCode = EXIT_IO_FAILURE;
+            rollBackJournal();
+            discardClone();
+        }
+    };
+
+    // print the output of each file in the order the files have been specified
+    auto processedFiles = std::size_t(), unchangedFiles = std::size_t();
+    auto coverStatistics = CoverNormalizationStatistics();
+    const auto emitFile = [&](std::size_t, SetTagInfoJob &job) {
+        job.flushOutput();
+        profiler.add(job.profile);
+        planSummary.add(job.plan);
+        ++processedFiles;
+        unchangedFiles += job.unchanged;
+        coverStatistics.add(job.coverStatistics);
+        if (job.exitCode != EXIT_SUCCESS) {
+            exitCode = job.exitCode;
+        }
+        if (job.aborted) {
+            return false;
+        }
+        printDiagMessages(job.diag, "Diagnostic messages:", args.verboseArg.isPresent(), &args.pedanticArg);
+        return true;
+    };
+
+    // print the summary of all files and save the state which is kept across runs
+    const auto finishRun = [&] {
+        if (planning) {
+            planSummary.print(cout);
+        } else if (unchangedFiles && !quiet) {
+            cout << "Unchanged: " << unchangedFiles << " of " << processedFiles << " files have been left as-is (nothing to write)." << endl;
+        }
+        if (coverStatistics.covers && !quiet) {
+            cout << "Covers: " << coverStatistics.covers << " normalized (" << coverNormalizer->conversions() << " distinct pictures re-encoded), "
+                 << dataSizeToString(coverStatistics.bytesSaved()) << " saved (" << dataSizeToString(coverStatistics.bytesBefore) << " before, "
+                 << dataSizeToString(coverStatistics.bytesAfter) << " after)." << endl;
+        }
+        if (editHistory) {
+            editHistory->save();
         }
-        continueWithNextFile(diag);
+        profiler.addCoverFiles(coverCache.requests(), coverCache.filesRead());
+        profiler.finish();
+    };
+    if (!useManifest) {
+        const auto processSpecifiedFile = [&](std::size_t fileIndex, SetTagInfoJob &job) {
+            processFile(fileIndex, files[fileIndex], fileIndex < outputFiles.size() ? outputFiles[fileIndex] : nullptr, nullptr, job);
+        };
+        processInOrder(files.size(), jobs, jobCount, processSpecifiedFile, emitFile);
+        finishRun();
+        return;
+    }
+
+    // process the records of the manifest (values specified via --values are selected according to the index of the record)
+    // note: The records are streamed to the worker threads which are kept running until the whole manifest has been processed
+    //       (so there's no barrier between batches of records and thread-local state like script engines is preserved).
+    auto manifest = ManifestReader(args.manifestArg.values().front());
+    const auto readRecord = [&manifest](std::size_t, SetTagInfoJob &job) { return manifest.read(job.record); };
+    const auto processRecord = [&](std::size_t recordIndex, SetTagInfoJob &job) {
+        auto &record = job.record;
+        processFile(recordIndex, record.file.data(), record.outputFile.empty() ? nullptr : record.outputFile.data(), &record, job);
+    };
+    processFetchedInOrder(jobs, jobCount, readRecord, processRecord, emitFile);
+    finishRun();
+    if (manifest.hasFailed()) {
+        exitCode = EXIT_FAILURE;
     }
 }
 
+/*!
+ * \brief The ExtractionJob struct holds the state for extracting a field/attachment from a single file within extractField().
+ * \remarks The values/attachments are written when the file is emitted and before the job is re-used for another file so
+ *          they can be referenced directly (without copying them) and only a constant number of files is held in memory.
+ */
+struct ExtractionJob {
+    MediaFileInfo fileInfo;
+    Diagnostics diag;
+    std::exception_ptr parsingError;
+};
+
 void extractField(const Argument &fieldArg, const Argument &attachmentArg, const Argument &inputFilesArg, const Argument &outputFileArg,
-    const Argument &indexArg, const Argument &verboseArg)
+    const Argument &indexArg, const Argument &verboseArg, const Argument &jobsArg)
 {
     // parse specified field and attachment
     const auto fieldDenotations = parseFieldDenotations(fieldArg, true);
@@ -1175,27 +1832,134 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
         }
     }
 
-    // read values/attachments
-    auto inputFileInfo = MediaFileInfo();
-    auto values = std::vector<std::pair<const TagValue *, std::string>>();
-    auto attachments = std::vector<std::pair<const AbstractAttachment *, std::string>>();
-    auto diag = Diagnostics();
-    for (const char *file : inputFilesArg.values()) {
+    // parse output path which might contain placeholders
+    const char *const outputPath = outputFileArg.isPresent() ? outputFileArg.values().front() : nullptr;
+    auto outputPathTemplate = OutputPathTemplate();
+    if (auto error = std::string(); outputPath && !outputPathTemplate.parse(outputPath, error)) {
+        std::cerr << Phrases::Error << "The specified output path is invalid: " << error << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+
+    // parse files (in parallel if --jobs has been specified)
+    const auto &files = inputFilesArg.values();
+    const auto extractAttachment = fieldDenotations.empty();
+    const auto jobCount = parseJobCount(jobsArg);
+    auto jobs = std::deque<ExtractionJob>(slotCountFor(jobCount, files.size()));
+    const auto parseFile = [&files, extractAttachment](std::size_t fileIndex, ExtractionJob &job) {
         auto progress = AbortableProgressFeedback(); // FIXME: actually use the progress object
+        job.diag.clear();
+        job.parsingError = nullptr;
         try {
-            // setup media file info
-            inputFileInfo.setPath(std::string_view(file));
-            inputFileInfo.open(true);
-
-            // extract either tag field or attachment
-            if (!fieldDenotations.empty()) {
-                // extract tag field
-                (outputFileArg.isPresent() ? cout : cerr) << "Extracting field " << fieldArg.values().front() << " of \"" << file << "\" ..." << endl;
-                inputFileInfo.parseContainerFormat(diag, progress);
-                inputFileInfo.parseTags(diag, progress);
-                auto tags = inputFileInfo.tags();
+            job.fileInfo.setPath(std::string_view(files[fileIndex]));
+            job.fileInfo.open(true);
+            job.fileInfo.parseContainerFormat(job.diag, progress);
+            if (extractAttachment) {
+                job.fileInfo.parseAttachments(job.diag, progress);
+            } else {
+                job.fileInfo.parseTags(job.diag, progress);
+            }
+        } catch (...) {
+            job.parsingError = std::current_exception();
+        }
+    };
+
+    // write values/attachments as soon as the file they are contained in has been parsed
+    // note: Without placeholders in the output path, the first value is written to the output path as-is. When a second value
+    //       is encountered, the first value is renamed so all values get a suffix (like "-ID3v2 tag-0") like before extracting
+    //       was streamed.
+    auto &logStream = outputPath ? cout : cerr;
+    auto valueCount = std::size_t();
+    auto firstValuePath = std::string(), firstValueSuffixedPath = std::string();
+    const auto legacyNaming = outputPath && !outputPathTemplate.hasVariables();
+    const auto outputPathWithoutExtension = legacyNaming ? BasicFileInfo::pathWithoutExtension(outputPath) : std::string();
+    const auto outputExtension = legacyNaming ? BasicFileInfo::extension(outputPath) : std::string();
+    // note: sourceData is the data block of an attachment if it is a range of the source file; the range is copied directly from
+    //       file to file then (via copy_file_range()/sendfile() where supported) instead of being buffered via iostreams
+    const auto writeValue = [&](const char *file, std::size_t indexInFile, std::string_view suffix, std::string_view extension,
+                                const auto &writeData, const StreamDataBlock *sourceData) {
+        const auto valueIndex = valueCount++;
+        if (index != noIndex && valueIndex != index) {
+            return;
+        }
+        if (!outputPath) {
+            try {
+                cout.flush();
+                if (!sourceData || !copyFileRange(file, sourceData->startOffset(), sourceData->size(), nullptr)) {
+                    writeData(cout);
+                }
+            } catch (const std::ios_base::failure &e) {
+                cerr << Phrases::Error << "An IO error occurred when writing the value to stdout: " << e.what() << Phrases::End;
+                exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
+            }
+            return;
+        }
+        auto path = std::string();
+        if (!legacyNaming) {
+            path = outputPathTemplate.expand(file, indexInFile, valueIndex, extension);
+            if (const auto directory = std::filesystem::path(makeNativePath(path)).parent_path(); !directory.empty()) {
+                auto ec = std::error_code();
+                std::filesystem::create_directories(directory, ec);
+            }
+        } else if (index != noIndex || !valueIndex) {
+            path = outputPath;
+        } else {
+            if (valueIndex == 1 && !firstValuePath.empty()) {
+                auto ec = std::error_code();
+                std::filesystem::rename(makeNativePath(firstValuePath), makeNativePath(firstValueSuffixedPath), ec);
+                if (ec) {
+                    cerr << Phrases::Error << "Unable to rename \"" << firstValuePath << "\" to \"" << firstValueSuffixedPath
+                         << "\": " << ec.message() << Phrases::End;
+                    exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
+                } else {
+                    cout << "Value has been saved to \"" << firstValueSuffixedPath << "\"." << endl;
+                }
+                firstValuePath.clear();
+            }
+            path = argsToString(outputPathWithoutExtension, '-', suffix, outputExtension);
+        }
+        try {
+            if (!sourceData || !copyFileRange(file, sourceData->startOffset(), sourceData->size(), path.data())) {
+                auto outputFileStream = NativeFileStream();
+                outputFileStream.exceptions(ios_base::failbit | ios_base::badbit);
+                outputFileStream.open(path, ios_base::out | ios_base::binary);
+                writeData(outputFileStream);
+                outputFileStream.flush();
+            }
+        } catch (const std::ios_base::failure &e) {
+            cerr << Phrases::Error << "An IO error occurred when writing the file \"" << path << "\": " << e.what() << Phrases::End;
+            exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
+            return;
+        }
+        if (legacyNaming && index == noIndex && !valueIndex) {
+            // defer the message as the value will be renamed if there are further values
+            firstValuePath = path;
+            firstValueSuffixedPath = argsToString(outputPathWithoutExtension, '-', suffix, outputExtension);
+            return;
+        }
+        cout << "Value has been saved to \"" << path << "\"." << endl;
+    };
+    const auto emitFile = [&](std::size_t fileIndex, ExtractionJob &job) {
+        const char *const file = files[fileIndex];
+        auto &diag = job.diag;
+        auto indexInFile = std::size_t();
+        if (!extractAttachment) {
+            logStream << "Extracting field " << fieldArg.values().front() << " of \"" << file << "\" ..." << endl;
+        } else {
+            logStream << "Extracting attachment with ";
+            if (attachmentInfo.hasId) {
+                logStream << "ID " << attachmentInfo.id;
+            } else {
+                logStream << "name \"" << attachmentInfo.name << '\"';
+            }
+            logStream << " of \"" << file << "\" ..." << endl;
+        }
+        try {
+            if (job.parsingError) {
+                std::rethrow_exception(job.parsingError);
+            }
+            if (!extractAttachment) {
                 // iterate through all tags
-                for (const Tag *tag : tags) {
+                for (const Tag *tag : job.fileInfo.tags()) {
                     const TagType tagType = tag->type();
                     for (const auto &fieldDenotation : fieldDenotations) {
                         try {
@@ -1205,7 +1969,15 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
                                 continue;
                             }
                             for (const TagValue *value : valuesForField.first) {
-                                values.emplace_back(value, joinStrings({ std::string(tag->typeName()), numberToString(values.size()) }, "-", true));
+                                const auto mimeType = value->mimeType().empty() && value->type() == TagDataType::Text
+                                    ? std::string_view("text/plain")
+                                    : std::string_view(value->mimeType());
+                                writeValue(file, indexInFile++, joinStrings({ std::string(tag->typeName()), numberToString(valueCount) }, "-", true),
+                                    OutputPathTemplate::extensionFor(mimeType),
+                                    [value](std::ostream &output) {
+                                        output.write(value->dataPointer(), static_cast<std::streamsize>(value->dataSize()));
+                                    },
+                                    nullptr);
                             }
                         } catch (const ConversionException &e) {
                             diag.emplace_back(DiagLevel::Critical,
@@ -1215,23 +1987,15 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
                     }
                 }
             } else {
-                // extract attachment
-                auto &logStream = (outputFileArg.isPresent() ? cout : cerr);
-                logStream << "Extracting attachment with ";
-                if (attachmentInfo.hasId) {
-                    logStream << "ID " << attachmentInfo.id;
-                } else {
-                    logStream << "name \"" << attachmentInfo.name << '\"';
-                }
-                logStream << " of \"" << file << "\" ..." << endl;
-
-                inputFileInfo.parseContainerFormat(diag, progress);
-                inputFileInfo.parseAttachments(diag, progress);
-
                 // iterate through all attachments
-                for (const AbstractAttachment *attachment : inputFileInfo.attachments()) {
+                for (const AbstractAttachment *attachment : job.fileInfo.attachments()) {
                     if ((attachmentInfo.hasId && attachment->id() == attachmentInfo.id) || (attachment->name() == attachmentInfo.name)) {
-                        attachments.emplace_back(attachment, joinStrings({ attachment->name(), numberToString(attachments.size()) }, "-", true));
+                        const auto *const data = attachment->data();
+                        const auto isRangeOfFile
+                            = data && !data->buffer() && &data->stream() == &static_cast<std::istream &>(job.fileInfo.stream());
+                        writeValue(file, indexInFile++, joinStrings({ attachment->name(), numberToString(valueCount) }, "-", true),
+                            OutputPathTemplate::extensionFor(attachment->mimeType(), attachment->name()),
+                            [data](std::ostream &output) { data->copyTo(output); }, isRangeOfFile ? data : nullptr);
                     }
                 }
             }
@@ -1242,96 +2006,60 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
             cerr << Phrases::Error << "An IO error occurred when reading the file \"" << file << "\": " << e.what() << Phrases::End;
             exitCode = EXIT_IO_FAILURE;
         }
+        printDiagMessages(diag, "Diagnostic messages:", verboseArg.isPresent());
+        // stop once the value with the specified index has been written
+        return index == noIndex || valueCount <= index;
+    };
+    processInOrder(files.size(), jobs, jobCount, parseFile, emitFile);
+    if (!firstValuePath.empty()) {
+        cout << "Value has been saved to \"" << firstValuePath << "\"." << endl;
     }
 
-    // write values/attachments
-    if (!fieldDenotations.empty()) {
-        if (values.empty()) {
+    // print an error if nothing has been extracted
+    if (!valueCount) {
+        if (!extractAttachment) {
             cerr << Phrases::Error << "None of the specified files has a (supported) " << fieldArg.values().front() << " field." << Phrases::End;
-            exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
-        } else if (index != noIndex && index >= values.size()) {
-            cerr << Phrases::Error << "The specified index is out of range as the specified files/fields have only " << values.size() << " values."
-                 << Phrases::End;
-            exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
-        } else if (outputFileArg.isPresent()) {
-            if (index != noIndex) {
-                if (index) {
-                    values[index].swap(values.front());
-                }
-                values.resize(1);
-            }
-            auto outputFilePathWithoutExtension = std::string(), outputFileExtension = std::string();
-            if (values.size() > 1) {
-                outputFilePathWithoutExtension = BasicFileInfo::pathWithoutExtension(outputFileArg.values().front());
-                outputFileExtension = BasicFileInfo::extension(outputFileArg.values().front());
-            }
-            for (const auto &value : values) {
-                auto outputFileStream = NativeFileStream();
-                outputFileStream.exceptions(ios_base::failbit | ios_base::badbit);
-                auto path = values.size() > 1 ? joinStrings({ outputFilePathWithoutExtension, "-", value.second, outputFileExtension })
-                                              : outputFileArg.values().front();
-                try {
-                    outputFileStream.open(path, ios_base::out | ios_base::binary);
-                    outputFileStream.write(value.first->dataPointer(), static_cast<std::streamsize>(value.first->dataSize()));
-                    outputFileStream.flush();
-                    cout << "Value has been saved to \"" << path << "\"." << endl;
-                } catch (const std::ios_base::failure &e) {
-                    cerr << Phrases::Error << "An IO error occurred when writing the file \"" << path << "\": " << e.what() << Phrases::End;
-                    exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
-                }
-            }
         } else {
-            // write data to stdout if no output file has been specified
-            for (const auto &value : values) {
-                cout.write(value.first->dataPointer(), static_cast<std::streamsize>(value.first->dataSize()));
-            }
-        }
-    } else {
-        if (attachments.empty()) {
             cerr << Phrases::Error << "None of the specified files has a (supported) attachment with the specified ID/name." << Phrases::End;
-            exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
-        } else if (index != noIndex && index >= values.size()) {
-            cerr << Phrases::Error << "The specified index is out of range as the specified files have only " << attachments.size() << " attachments."
-                 << Phrases::End;
-            exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
-        } else if (outputFileArg.isPresent()) {
-            if (index != noIndex) {
-                if (index) {
-                    attachments[index].swap(attachments.front());
-                }
-                attachments.resize(1);
-            }
-            auto outputFilePathWithoutExtension = std::string(), outputFileExtension = std::string();
-            if (attachments.size() > 1) {
-                outputFilePathWithoutExtension = BasicFileInfo::pathWithoutExtension(outputFileArg.values().front());
-                outputFileExtension = BasicFileInfo::extension(outputFileArg.values().front());
-            }
-            for (const auto &attachment : attachments) {
-                auto outputFileStream = NativeFileStream();
-                outputFileStream.exceptions(ios_base::failbit | ios_base::badbit);
-                auto path = attachments.size() > 1 ? joinStrings({ outputFilePathWithoutExtension, "-", attachment.second, outputFileExtension })
-                                                   : outputFileArg.values().front();
-                try {
-                    outputFileStream.open(path, ios_base::out | ios_base::binary);
-                    attachment.first->data()->copyTo(outputFileStream);
-                    outputFileStream.flush();
-                    cout << "Value has been saved to \"" << path << "\"." << endl;
-                } catch (const std::ios_base::failure &e) {
-                    cerr << Phrases::Error << "An IO error occurred when writing the file \"" << path << "\": " << e.what() << Phrases::EndFlush;
-                    exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
-                }
-            }
-        } else {
-            for (const auto &attachment : attachments) {
-                attachment.first->data()->copyTo(cout);
-            }
         }
+        exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
+    } else if (index != noIndex && index >= valueCount) {
+        cerr << Phrases::Error << "The specified index is out of range as the specified files" << (extractAttachment ? "" : "/fields")
+             << " have only " << valueCount << (extractAttachment ? " attachments." : " values.") << Phrases::End;
+        exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
     }
+}
 
-    printDiagMessages(diag, "Diagnostic messages:", verboseArg.isPresent());
+#ifdef TAGEDITOR_JSON_EXPORT
+/*!
+ * \brief The JsonExportJob struct holds the state for exporting a single file within exportToJson().
+ * \remarks When streaming NDJSON or using the cache, the JSON object for the file is serialized into \a line by the
+ *          worker thread using the arena \a allocator which is cleared again before the next file is processed.
+ */
+struct JsonExportJob : public ReadingJob {
+    RAPIDJSON_NAMESPACE::Document::AllocatorType allocator;
+    RAPIDJSON_NAMESPACE::StringBuffer line;
+};
+
+/*!
+ * \brief Serializes the specified \a fileInfo into \a value.
+ * \remarks The members which can only be determined by parsing the tracks are omitted if the tracks have not been parsed
+ *          so they are not emitted with bogus values.
+ */
+static void pushFileInfo(const Json::FileInfo &fileInfo, bool tracksParsed, RAPIDJSON_NAMESPACE::Value &value,
+    RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator)
+{
+    ReflectiveRapidJSON::JsonReflector::push(fileInfo, value, allocator);
+    if (!tracksParsed) {
+        for (const char *const member : { "mimeType", "formatSummary", "duration" }) {
+            value.RemoveMember(member);
+        }
+    }
 }
+#endif
 
-void exportToJson(const ArgumentOccurrence &, const Argument &filesArg, const Argument &prettyArg)
+void exportToJson(const ArgumentOccurrence &, const Argument &fieldsArg, const Argument &filesArg, const Argument &prettyArg,
+    const Argument &ndjsonArg, const Argument &jobsArg, const Argument &cacheArg, const Argument &profileArg)
 {
 #ifdef TAGEDITOR_JSON_EXPORT
     // check whether files have been specified
@@ -1339,23 +2067,113 @@ void exportToJson(const ArgumentOccurrence &, const Argument &filesArg, const Ar
         std::cerr << Phrases::Error << "No files have been specified." << Phrases::End;
         std::exit(EXIT_FAILURE);
     }
+    const auto ndjson = ndjsonArg.isPresent();
+    if (ndjson && prettyArg.isPresent()) {
+        std::cerr << Phrases::Error << "--pretty can not be combined with --ndjson." << Phrases::End
+                  << "note: NDJSON requires each JSON object to be on a single line." << endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    // determine the tag fields to export (all fields if none specified)
+    auto fieldsToExport = std::vector<KnownField>();
+    auto cacheVariant = std::string("export");
+    if (fieldsArg.isPresent()) {
+        for (const char *const fieldDenotation : fieldsArg.values()) {
+            const auto field = FieldMapping::knownField(fieldDenotation, std::strlen(fieldDenotation));
+            if (field == KnownField::Invalid) {
+                std::cerr << Phrases::Error << "The field name \"" << fieldDenotation << "\" is unknown." << Phrases::End
+                          << "note: Only generic field names can be specified when exporting. Use --print-field-names to list them." << endl;
+                std::exit(EXIT_FAILURE);
+            }
+            fieldsToExport.emplace_back(field);
+            cacheVariant += ':';
+            cacheVariant += fieldDenotation;
+        }
+    }
+    // skip parsing tracks when only certain fields are requested (the track-dependent members are omitted then)
+    const auto parseTracks = fieldsToExport.empty();
+
+    // load cache if specified
+    auto cache = std::optional<ResultCache>();
+    if (cacheArg.isPresent()) {
+        cache.emplace(cacheArg.values().front());
+    }
+    auto *const cachePtr = cache.has_value() ? &cache.value() : nullptr;
 
     RAPIDJSON_NAMESPACE::Document document(RAPIDJSON_NAMESPACE::kArrayType);
-    std::vector<Json::FileInfo> jsonData;
-    MediaFileInfo fileInfo;
 
-    // gather tags for each file
-    Diagnostics diag; // FIXME: actually use diag object
-    AbortableProgressFeedback progress; // FIXME: actually use the progress object
-    for (const char *file : filesArg.values()) {
+    // gather tags for each file (parsing happens in parallel if --jobs has been specified but the JSON objects are created
+    // on the main thread as the allocator of the document is not thread-safe; when streaming NDJSON or using the cache each
+    // file is serialized by the worker thread on its own using the allocator of the job so nothing is accumulated)
+    const auto &files = filesArg.values();
+    const auto jobCount = parseJobCount(jobsArg);
+    const auto serialize = ndjson || cachePtr;
+    auto jobs = std::deque<JsonExportJob>(slotCountFor(jobCount, files.size()));
+    auto profiler = Profiler(profileArg);
+    const auto parseFile = [&files, &fieldsToExport, &cacheVariant, cachePtr, &profiler, serialize, parseTracks](
+                               std::size_t fileIndex, JsonExportJob &job) {
+        auto progress = AbortableProgressFeedback(); // FIXME: actually use the progress object
+        job.diag.clear(); // FIXME: actually use diag object
+        job.parsingError = nullptr;
+        job.line.Clear();
+        if (lookupCachedResult(cachePtr, cacheVariant, files[fileIndex], job)) {
+            return;
+        }
+        auto timer = ProfileTimer(profiler.profile(job.profile), files[fileIndex]);
         try {
-            // parse tags
-            fileInfo.setPath(std::string(file));
-            fileInfo.open(true);
-            fileInfo.parseContainerFormat(diag, progress);
-            fileInfo.parseTags(diag, progress);
-            fileInfo.parseTracks(diag, progress);
-            jsonData.emplace_back(fileInfo, document.GetAllocator());
+            job.fileInfo.setPath(std::string(files[fileIndex]));
+            job.fileInfo.open(true);
+            timer.mark(ProfilePhase::Open);
+            job.fileInfo.parseContainerFormat(job.diag, progress);
+            timer.mark(ProfilePhase::ParseContainerFormat);
+            job.fileInfo.parseTags(job.diag, progress);
+            timer.mark(ProfilePhase::ParseTags);
+            if (parseTracks) {
+                job.fileInfo.parseTracks(job.diag, progress);
+                timer.mark(ProfilePhase::ParseTracks);
+            }
+            if (serialize) {
+                {
+                    auto fileInfo = Json::FileInfo(job.fileInfo, job.allocator, fieldsToExport);
+                    auto fileDocument = RAPIDJSON_NAMESPACE::Document(&job.allocator);
+                    pushFileInfo(fileInfo, parseTracks, fileDocument, job.allocator);
+                    auto writer = RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::StringBuffer>(job.line);
+                    fileDocument.Accept(writer);
+                }
+                job.allocator.Clear();
+                timer.mark(ProfilePhase::Serialize);
+            }
+        } catch (...) {
+            job.allocator.Clear();
+            job.parsingError = std::current_exception();
+        }
+    };
+    const auto addFileInfo = [&](std::size_t fileIndex, JsonExportJob &job) {
+        const char *const file = files[fileIndex];
+        profiler.add(job.profile);
+        try {
+            if (job.parsingError) {
+                std::rethrow_exception(job.parsingError);
+            }
+            if (!serialize) {
+                auto value = RAPIDJSON_NAMESPACE::Value();
+                pushFileInfo(Json::FileInfo(job.fileInfo, document.GetAllocator(), fieldsToExport), parseTracks, value, document.GetAllocator());
+                document.PushBack(value, document.GetAllocator());
+                return true;
+            }
+            const auto line = job.cachedResult ? std::string_view(job.cachedResult.value())
+                                               : std::string_view(job.line.GetString(), job.line.GetSize());
+            if (ndjson) {
+                cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+                cout << endl;
+            } else {
+                auto fileDocument = RAPIDJSON_NAMESPACE::Document(&document.GetAllocator());
+                fileDocument.Parse(line.data(), line.size());
+                document.PushBack(fileDocument.Move(), document.GetAllocator());
+            }
+            if (cachePtr && !job.cachedResult) {
+                cachePtr->store(cacheVariant, job.fileStatus, std::string(line));
+            }
         } catch (const TagParser::Failure &) {
             cerr << Phrases::Error << "A parsing failure occurred when reading the file \"" << file << "\"." << Phrases::EndFlush;
             exitCode = EXIT_PARSING_FAILURE;
@@ -1363,12 +2181,20 @@ void exportToJson(const ArgumentOccurrence &, const Argument &filesArg, const Ar
             cerr << Phrases::Error << "An IO error occurred when reading the file \"" << file << "\": " << e.what() << Phrases::EndFlush;
             exitCode = EXIT_IO_FAILURE;
         }
+        return true;
+    };
+    processInOrder(files.size(), jobs, jobCount, parseFile, addFileInfo);
+    if (cache) {
+        cache->save();
+    }
+    profiler.finish();
+    if (ndjson) {
+        return;
     }
 
     // TODO: serialize diag messages
 
     // print the gathered data as JSON document
-    ReflectiveRapidJSON::JsonReflector::push(jsonData, document, document.GetAllocator());
     RAPIDJSON_NAMESPACE::OStreamWrapper osw(cout);
     if (prettyArg.isPresent()) {
         RAPIDJSON_NAMESPACE::PrettyWriter<RAPIDJSON_NAMESPACE::OStreamWrapper> writer(osw);
@@ -1380,8 +2206,13 @@ void exportToJson(const ArgumentOccurrence &, const Argument &filesArg, const Ar
     cout << endl;
 
 #else
+    CPP_UTILITIES_UNUSED(fieldsArg);
     CPP_UTILITIES_UNUSED(filesArg);
     CPP_UTILITIES_UNUSED(prettyArg);
+    CPP_UTILITIES_UNUSED(ndjsonArg);
+    CPP_UTILITIES_UNUSED(jobsArg);
+    CPP_UTILITIES_UNUSED(cacheArg);
+    CPP_UTILITIES_UNUSED(profileArg);
     cerr << Phrases::Error << "JSON export has not been enabled when building the tag editor." << Phrases::EndFlush;
     exitCode = EXIT_FAILURE;
 #endif
@@ -13,10 +13,13 @@ class Argument;
 namespace Cli {
 
 struct SetTagInfoArgs {
-    SetTagInfoArgs(CppUtilities::Argument &filesArg, CppUtilities::Argument &verboseArg, CppUtilities::Argument &pedanticArg);
+    SetTagInfoArgs(CppUtilities::Argument &filesArg, CppUtilities::Argument &verboseArg, CppUtilities::Argument &pedanticArg,
+        CppUtilities::Argument &jobsArg, CppUtilities::Argument &profileArg);
     CppUtilities::Argument &filesArg;
     CppUtilities::Argument &verboseArg;
     CppUtilities::Argument &pedanticArg;
+    CppUtilities::Argument &jobsArg;
+    CppUtilities::Argument &profileArg;
     CppUtilities::ConfigValueArgument quietArg;
     CppUtilities::ConfigValueArgument docTitleArg;
     CppUtilities::ConfigValueArgument removeOtherFieldsArg;
@@ -36,6 +39,8 @@ struct SetTagInfoArgs {
     CppUtilities::ConfigValueArgument minPaddingArg;
     CppUtilities::ConfigValueArgument maxPaddingArg;
     CppUtilities::ConfigValueArgument prefPaddingArg;
+    CppUtilities::ConfigValueArgument paddingPolicyArg;
+    CppUtilities::ConfigValueArgument paddingHistoryArg;
     CppUtilities::ConfigValueArgument tagPosValueArg;
     CppUtilities::ConfigValueArgument forceTagPosArg;
     CppUtilities::ConfigValueArgument tagPosArg;
@@ -43,9 +48,13 @@ struct SetTagInfoArgs {
     CppUtilities::ConfigValueArgument forceIndexPosArg;
     CppUtilities::ConfigValueArgument indexPosArg;
     CppUtilities::ConfigValueArgument forceRewriteArg;
+    CppUtilities::ConfigValueArgument planArg;
     CppUtilities::ConfigValueArgument valuesArg;
     CppUtilities::ConfigValueArgument outputFilesArg;
+    CppUtilities::ConfigValueArgument noCloneArg;
+    CppUtilities::ConfigValueArgument manifestArg;
     CppUtilities::ConfigValueArgument backupDirArg;
+    CppUtilities::ConfigValueArgument journalArg;
     CppUtilities::ConfigValueArgument layoutOnlyArg;
     CppUtilities::ConfigValueArgument preserveModificationTimeArg;
     CppUtilities::ConfigValueArgument preserveMuxingAppArg;
@@ -54,6 +63,9 @@ struct SetTagInfoArgs {
     CppUtilities::ConfigValueArgument jsArg;
     CppUtilities::ConfigValueArgument jsSettingsArg;
     CppUtilities::ConfigValueArgument coverTypeDelimiterArg;
+    CppUtilities::ConfigValueArgument coverMaxSizeArg;
+    CppUtilities::ConfigValueArgument coverFormatArg;
+    CppUtilities::ConfigValueArgument coverQualityArg;
     CppUtilities::OperationArgument setTagInfoArg;
 };
 
@@ -63,15 +75,21 @@ extern int exitCode;
 void applyGeneralConfig(const CppUtilities::Argument &timeSapnFormatArg);
 void printFieldNames(const CppUtilities::ArgumentOccurrence &occurrence);
 void displayFileInfo(const CppUtilities::ArgumentOccurrence &, const CppUtilities::Argument &filesArg, const CppUtilities::Argument &verboseArg,
-    const CppUtilities::Argument &pedanticArg, const CppUtilities::Argument &validateArg);
+    const CppUtilities::Argument &pedanticArg, const CppUtilities::Argument &validateArg, const CppUtilities::Argument &jobsArg,
+    const CppUtilities::Argument &profileArg);
 void generateFileInfo(const CppUtilities::ArgumentOccurrence &, const CppUtilities::Argument &inputFileArg,
     const CppUtilities::Argument &outputFileArg, const CppUtilities::Argument &validateArg);
 void displayTagInfo(const CppUtilities::Argument &fieldsArg, const CppUtilities::Argument &showUnsupportedArg, const CppUtilities::Argument &filesArg,
-    const CppUtilities::Argument &verboseArg, const CppUtilities::Argument &pedanticArg);
+    const CppUtilities::Argument &verboseArg, const CppUtilities::Argument &pedanticArg, const CppUtilities::Argument &jobsArg,
+    const CppUtilities::Argument &cacheArg, const CppUtilities::Argument &profileArg);
 void setTagInfo(const Cli::SetTagInfoArgs &args);
+void keepJavaScriptEnginesAlive();
 void extractField(const CppUtilities::Argument &fieldArg, const CppUtilities::Argument &attachmentArg, const CppUtilities::Argument &inputFilesArg,
-    const CppUtilities::Argument &outputFileArg, const CppUtilities::Argument &indexArg, const CppUtilities::Argument &verboseArg);
-void exportToJson(const CppUtilities::ArgumentOccurrence &, const CppUtilities::Argument &filesArg, const CppUtilities::Argument &prettyArg);
+    const CppUtilities::Argument &outputFileArg, const CppUtilities::Argument &indexArg, const CppUtilities::Argument &verboseArg,
+    const CppUtilities::Argument &jobsArg);
+void exportToJson(const CppUtilities::ArgumentOccurrence &, const CppUtilities::Argument &fieldsArg, const CppUtilities::Argument &filesArg,
+    const CppUtilities::Argument &prettyArg, const CppUtilities::Argument &ndjsonArg, const CppUtilities::Argument &jobsArg,
+    const CppUtilities::Argument &cacheArg, const CppUtilities::Argument &profileArg);
 
 } // namespace Cli
 
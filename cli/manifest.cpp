@@ -0,0 +1,202 @@
+#include "./manifest.h"
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#ifdef TAGEDITOR_JSON_EXPORT
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#endif
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+
+namespace Cli {
+
+/*!
+ * \brief The InvalidRecordException class is thrown when a record of a manifest is invalid.
+ */
+class InvalidRecordException : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/*!
+ * \brief Parses the specified field \a denotations of a record.
+ * \remarks Throws InvalidRecordException if a denotation is invalid so reading stops at this record (instead of exiting
+ *          immediately while other files might still be modified).
+ */
+static FieldDenotations parseRecordFields(const std::vector<const char *> &denotations)
+{
+    try {
+        return parseFieldDenotations(denotations, false);
+    } catch (const InvalidDenotationException &e) {
+        throw InvalidRecordException(e.note().empty() ? std::string(e.what()) : argsToString(e.what(), " (", e.note(), ')'));
+    }
+}
+
+/*!
+ * \brief Opens the manifest at the specified \a path ("-" for reading tab-separated values from stdin).
+ */
+ManifestReader::ManifestReader(std::string_view path)
+    : m_path(path)
+    , m_stream(&std::cin)
+    , m_lineNumber(0)
+    , m_failed(false)
+    , m_json(endsWith(path, ".ndjson") || endsWith(path, ".jsonl"))
+{
+#ifndef TAGEDITOR_JSON_EXPORT
+    if (m_json) {
+        cerr << Phrases::Error << "The manifest \"" << m_path << "\" contains JSON but support for this has been disabled at compile-time."
+             << Phrases::End << "note: Use tab-separated values instead." << endl;
+        std::exit(EXIT_FAILURE);
+    }
+#endif
+    if (m_path == "-") {
+        return;
+    }
+    m_file.open(m_path, ios_base::in | ios_base::binary);
+    if (!m_file.is_open()) {
+        cerr << Phrases::Error << "Unable to open the manifest \"" << m_path << "\"." << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+    m_stream = &m_file;
+}
+
+/*!
+ * \brief Reads the next record into \a record.
+ * \returns Returns whether a record could be read; returns false if the end of the manifest has been reached or an invalid
+ *          record has been encountered (see hasFailed()).
+ */
+bool ManifestReader::read(ManifestRecord &record)
+{
+    while (!m_failed && std::getline(*m_stream, m_line)) {
+        ++m_lineNumber;
+        if (!m_line.empty() && m_line.back() == '\r') {
+            m_line.pop_back();
+        }
+        if (m_line.empty() || m_line.front() == '#') {
+            continue;
+        }
+        record = ManifestRecord();
+        record.lineNumber = m_lineNumber;
+        try {
+            if (m_json) {
+                parseJson(record);
+            } else {
+                parseTabSeparatedValues(record);
+            }
+            if (record.file.empty()) {
+                fail("no file has been specified");
+            }
+            return true;
+        } catch (const InvalidRecordException &e) {
+            cerr << Phrases::Error << "Line " << m_lineNumber << " of the manifest \"" << m_path << "\" is invalid: " << e.what() << Phrases::End
+                 << "note: This record and the records following it have not been processed." << endl;
+            m_failed = true;
+        }
+    }
+    if (!m_failed && m_stream->bad()) {
+        cerr << Phrases::Error << "An IO error occurred when reading the manifest \"" << m_path << "\"." << Phrases::EndFlush;
+        m_failed = true;
+    }
+    return false;
+}
+
+/*!
+ * \brief Parses the current line as tab-separated values: the file followed by field denotations.
+ */
+void ManifestReader::parseTabSeparatedValues(ManifestRecord &record)
+{
+    auto denotations = std::vector<const char *>();
+    for (auto begin = std::size_t(), end = std::size_t(); begin <= m_line.size(); begin = end + 1) {
+        if ((end = m_line.find('\t', begin)) == std::string::npos) {
+            end = m_line.size();
+        }
+        m_line[end] = '\0';
+        if (!begin) {
+            record.file.assign(m_line.data(), end);
+        } else if (end > begin) {
+            denotations.emplace_back(m_line.data() + begin);
+        }
+    }
+    record.fields = parseRecordFields(denotations);
+}
+
+/*!
+ * \brief Parses the current line as JSON object.
+ *
+ * The object may contain the members "file" (required), "output", "values" (an array of field denotations) and "add-attachment",
+ * "update-attachment" and "remove-attachment" (each an array of attachments where each attachment is an array of denotations).
+ */
+void ManifestReader::parseJson(ManifestRecord &record)
+{
+#ifdef TAGEDITOR_JSON_EXPORT
+    auto document = RAPIDJSON_NAMESPACE::Document();
+    document.Parse(m_line.data(), m_line.size());
+    if (document.HasParseError()) {
+        fail(argsToString(RAPIDJSON_NAMESPACE::GetParseError_En(document.GetParseError()), " (at offset ", document.GetErrorOffset(), ')'));
+    }
+    if (!document.IsObject()) {
+        fail("the record is not a JSON object");
+    }
+    const auto readStrings = [](const RAPIDJSON_NAMESPACE::Value &array, std::string_view member) {
+        if (!array.IsArray()) {
+            fail(argsToString("\"", member, "\" is not an array"));
+        }
+        auto strings = std::vector<const char *>();
+        strings.reserve(array.Size());
+        for (const auto &value : array.GetArray()) {
+            if (!value.IsString()) {
+                fail(argsToString("\"", member, "\" contains a value which is not a string"));
+            }
+            strings.emplace_back(value.GetString());
+        }
+        return strings;
+    };
+    for (const auto &member : document.GetObject()) {
+        const auto name = std::string_view(member.name.GetString(), member.name.GetStringLength());
+        if (name == "file" || name == "output") {
+            if (!member.value.IsString()) {
+                fail(argsToString("\"", name, "\" is not a string"));
+            }
+            (name == "file" ? record.file : record.outputFile).assign(member.value.GetString(), member.value.GetStringLength());
+        } else if (name == "values") {
+            record.fields = parseRecordFields(readStrings(member.value, name));
+        } else if (name == "add-attachment" || name == "update-attachment" || name == "remove-attachment") {
+            if (!member.value.IsArray()) {
+                fail(argsToString("\"", name, "\" is not an array"));
+            }
+            const auto action = name == "add-attachment" ? AttachmentAction::Add
+                                                         : (name == "update-attachment" ? AttachmentAction::Update : AttachmentAction::Remove);
+            for (const auto &denotations : member.value.GetArray()) {
+                auto &attachment = record.attachments.emplace_back();
+                attachment.action = action;
+                for (const auto *const denotation : readStrings(denotations, name)) {
+                    attachment.denotations.emplace_back(denotation);
+                }
+            }
+        } else {
+            fail(argsToString("the member \"", name, "\" is unknown"));
+        }
+    }
+#else
+    CPP_UTILITIES_UNUSED(record);
+#endif
+}
+
+/*!
+ * \brief Throws an InvalidRecordException for the current record with the specified \a message.
+ */
+void ManifestReader::fail(std::string_view message)
+{
+    throw InvalidRecordException(std::string(message));
+}
+
+} // namespace Cli
@@ -0,0 +1,79 @@
+#ifndef CLI_MANIFEST
+#define CLI_MANIFEST
+
+#include "./attachmentinfo.h"
+#include "./helper.h"
+
+#include <c++utilities/io/nativefilestream.h>
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Cli {
+
+/*!
+ * \brief The ManifestAttachment struct holds an attachment to be added, updated or removed as specified by a manifest record.
+ * \remarks The denotations are the same as for --add-attachment, --update-attachment and --remove-attachment.
+ */
+struct ManifestAttachment {
+    AttachmentAction action = AttachmentAction::Add;
+    std::vector<std::string> denotations;
+};
+
+/*!
+ * \brief The ManifestRecord struct holds the edits for a single file as specified by a record of a manifest.
+ */
+struct ManifestRecord {
+    std::size_t lineNumber = 0;
+    std::string file;
+    std::string outputFile;
+    FieldDenotations fields;
+    std::vector<ManifestAttachment> attachments;
+};
+
+/*!
+ * \brief The ManifestReader class reads the records of a manifest passed via "set --manifest" one after another.
+ *
+ * Each non-empty line of the manifest is a record. Lines are either tab-separated values (the file followed by the field
+ * denotations like "title=foo") or JSON objects (if the manifest's file extension is ".ndjson" or ".jsonl"). Empty lines and
+ * lines starting with "#" are ignored.
+ *
+ * \remarks
+ * - Only the current line is held in memory so manifests of arbitrary size can be processed.
+ * - Reading stops at the first invalid record because the manifest is most likely generated and just applying the remaining
+ *   records would leave the batch in a state which is hard to recover from.
+ */
+class ManifestReader {
+public:
+    explicit ManifestReader(std::string_view path);
+    bool read(ManifestRecord &record);
+    bool hasFailed() const;
+
+private:
+    void parseTabSeparatedValues(ManifestRecord &record);
+    void parseJson(ManifestRecord &record);
+    [[noreturn]] static void fail(std::string_view message);
+
+    std::string m_path;
+    CppUtilities::NativeFileStream m_file;
+    std::istream *m_stream;
+    std::string m_line;
+    std::size_t m_lineNumber;
+    bool m_failed;
+    bool m_json;
+};
+
+/*!
+ * \brief Returns whether reading has been stopped due to an invalid record or an IO error.
+ */
+inline bool ManifestReader::hasFailed() const
+{
+    return m_failed;
+}
+
+} // namespace Cli
+
+#endif // CLI_MANIFEST
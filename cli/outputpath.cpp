@@ -0,0 +1,122 @@
+#include "./outputpath.h"
+
+#include <c++utilities/conversion/stringconversion.h>
+
+#include <filesystem>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/*!
+ * \brief Parses the specified \a pattern.
+ * \returns Returns whether the pattern is valid; otherwise \a error is set to a description of the problem.
+ */
+bool OutputPathTemplate::parse(std::string_view pattern, std::string &error)
+{
+    static constexpr std::pair<std::string_view, Variable> variables[] = {
+        { "dir", Variable::Directory },
+        { "basename", Variable::BaseName },
+        { "index", Variable::Index },
+        { "n", Variable::Number },
+        { "ext", Variable::Extension },
+    };
+    m_segments.clear();
+    m_hasVariables = false;
+    for (auto pos = std::size_t(); pos < pattern.size();) {
+        const auto begin = pattern.find('{', pos);
+        auto &segment = m_segments.emplace_back();
+        segment.literal = pattern.substr(pos, begin - pos);
+        if (begin == std::string_view::npos) {
+            break;
+        }
+        const auto end = pattern.find('}', begin);
+        if (end == std::string_view::npos) {
+            error = "the placeholder \"" + std::string(pattern.substr(begin)) + "\" is not terminated";
+            return false;
+        }
+        const auto name = pattern.substr(begin + 1, end - begin - 1);
+        for (const auto &[variableName, variable] : variables) {
+            if (name == variableName) {
+                segment.variable = variable;
+                break;
+            }
+        }
+        if (!segment.variable.has_value()) {
+            error = "the placeholder \"{" + std::string(name) + "}\" is unknown (supported are {dir}, {basename}, {index}, {n} and {ext})";
+            return false;
+        }
+        m_hasVariables = true;
+        pos = end + 1;
+    }
+    return true;
+}
+
+/*!
+ * \brief Returns the path for the value/attachment with the specified \a index within \a inputFile and the specified \a number
+ *        across all input files.
+ */
+std::string OutputPathTemplate::expand(std::string_view inputFile, std::size_t index, std::size_t number, std::string_view extension) const
+{
+    const auto inputPath = std::filesystem::path(inputFile);
+    auto path = std::string();
+    for (const auto &segment : m_segments) {
+        path += segment.literal;
+        if (!segment.variable.has_value()) {
+            continue;
+        }
+        switch (segment.variable.value()) {
+        case Variable::Directory:
+            path += inputPath.has_parent_path() ? inputPath.parent_path().string() : std::string(".");
+            break;
+        case Variable::BaseName:
+            path += inputPath.stem().string();
+            break;
+        case Variable::Index:
+            path += numberToString(index);
+            break;
+        case Variable::Number:
+            path += numberToString(number);
+            break;
+        case Variable::Extension:
+            path += extension;
+            break;
+        }
+    }
+    return path;
+}
+
+/*!
+ * \brief Returns a file extension (without dot) for a value/attachment with the specified \a mimeType and \a name.
+ * \remarks The extension of \a name takes precedence; returns "bin" if no extension can be deduced.
+ */
+std::string_view OutputPathTemplate::extensionFor(std::string_view mimeType, std::string_view name)
+{
+    if (const auto dot = name.rfind('.'); dot != std::string_view::npos && dot + 1 < name.size() && name.find('/', dot) == std::string_view::npos) {
+        return name.substr(dot + 1);
+    }
+    static constexpr std::pair<std::string_view, std::string_view> extensions[] = {
+        { "image/jpeg", "jpg" },
+        { "image/jpg", "jpg" },
+        { "image/png", "png" },
+        { "image/gif", "gif" },
+        { "image/webp", "webp" },
+        { "image/bmp", "bmp" },
+        { "image/tiff", "tiff" },
+        { "text/plain", "txt" },
+        { "application/pdf", "pdf" },
+        { "application/x-truetype-font", "ttf" },
+        { "font/ttf", "ttf" },
+        { "font/otf", "otf" },
+        { "application/vnd.ms-opentype", "otf" },
+    };
+    for (const auto &[knownMimeType, extension] : extensions) {
+        if (mimeType == knownMimeType) {
+            return extension;
+        }
+    }
+    return "bin";
+}
+
+} // namespace Cli
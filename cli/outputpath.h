@@ -0,0 +1,51 @@
+#ifndef CLI_OUTPUT_PATH
+#define CLI_OUTPUT_PATH
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Cli {
+
+/*!
+ * \brief The OutputPathTemplate class expands placeholders within output paths specified via "extract --output-file".
+ *
+ * The following placeholders are supported:
+ * - "{dir}": the directory containing the input file ("." if the input path has no directory)
+ * - "{basename}": the name of the input file without extension
+ * - "{index}": the index of the value/attachment within the input file
+ * - "{n}": the index of the value/attachment across all input files
+ * - "{ext}": the file extension for the value/attachment (deduced from the name/MIME-type; "bin" if unknown)
+ */
+class OutputPathTemplate {
+public:
+    enum class Variable { Directory, BaseName, Index, Number, Extension };
+
+    bool parse(std::string_view pattern, std::string &error);
+    bool hasVariables() const;
+    std::string expand(std::string_view inputFile, std::size_t index, std::size_t number, std::string_view extension) const;
+
+    static std::string_view extensionFor(std::string_view mimeType, std::string_view name = std::string_view());
+
+private:
+    struct Segment {
+        std::string literal;
+        std::optional<Variable> variable;
+    };
+    std::vector<Segment> m_segments;
+    bool m_hasVariables = false;
+};
+
+/*!
+ * \brief Returns whether the template contains any placeholders.
+ */
+inline bool OutputPathTemplate::hasVariables() const
+{
+    return m_hasVariables;
+}
+
+} // namespace Cli
+
+#endif // CLI_OUTPUT_PATH
@@ -0,0 +1,180 @@
+#include "./paddingpolicy.h"
+#include "./writeplan.h"
+
+#include <tagparser/mediafileinfo.h>
+#include <tagparser/tag.h>
+#include <tagparser/tagvalue.h>
+
+#include <c++utilities/conversion/conversionexception.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+#include <c++utilities/io/nativefilestream.h>
+#include <c++utilities/io/path.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+using namespace TagParser;
+
+namespace Cli {
+
+/// \brief The padding reserved for any file (enough for a few additional text fields).
+static constexpr auto basePadding = std::uint64_t(4 * 1024);
+/// \brief The maximum factor the padding is multiplied with for frequently edited files.
+static constexpr auto maxEditFactor = std::uint64_t(4);
+
+/*!
+ * \brief Loads the edit history stored at the specified \a path.
+ * \remarks Starts with an empty history if the file does not exist yet or can not be read.
+ */
+EditHistory::EditHistory(std::string_view path)
+    : m_path(path)
+    , m_modified(false)
+{
+    load();
+}
+
+/*!
+ * \brief Returns how often the specified \a file has been edited so far.
+ */
+std::uint64_t EditHistory::editCount(const char *file)
+{
+    const auto path = absolutePath(file);
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    const auto entry = m_edits.find(path);
+    return entry != m_edits.end() ? entry->second : 0;
+}
+
+/*!
+ * \brief Records that the specified \a file has been edited.
+ */
+void EditHistory::recordEdit(const char *file)
+{
+    auto path = absolutePath(file);
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    ++m_edits[std::move(path)];
+    m_modified = true;
+}
+
+/*!
+ * \brief Writes the history back to disk if it has been modified.
+ * \remarks The history is written to a temporary file first which is renamed afterwards so the file is never left in a
+ *          half-written state.
+ */
+void EditHistory::save()
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    if (!m_modified) {
+        return;
+    }
+    const auto tempPath = m_path + ".tmp";
+    try {
+        auto stream = NativeFileStream();
+        stream.exceptions(ios_base::failbit | ios_base::badbit);
+        stream.open(tempPath, ios_base::out | ios_base::trunc | ios_base::binary);
+        for (const auto &[path, edits] : m_edits) {
+            stream << edits << '\t' << path << '\n';
+        }
+        stream.flush();
+        stream.close();
+        std::filesystem::rename(makeNativePath(tempPath), makeNativePath(m_path));
+        m_modified = false;
+    } catch (const std::ios_base::failure &e) {
+        cerr << Phrases::Warning << "An IO error occurred when writing the edit history \"" << tempPath << "\": " << e.what() << Phrases::EndFlush;
+    } catch (const std::filesystem::filesystem_error &e) {
+        cerr << Phrases::Warning << "Unable to replace the edit history \"" << m_path << "\": " << e.what() << Phrases::EndFlush;
+    }
+}
+
+/*!
+ * \brief Reads all entries from the history file.
+ */
+void EditHistory::load()
+{
+    auto error = std::error_code();
+    if (!std::filesystem::exists(makeNativePath(m_path), error)) {
+        return; // assume the history has just not been created yet
+    }
+    try {
+        auto stream = NativeFileStream();
+        stream.exceptions(ios_base::badbit);
+        stream.open(m_path, ios_base::in | ios_base::binary);
+        auto line = std::string();
+        for (auto lineNumber = std::size_t(1); std::getline(stream, line); ++lineNumber) {
+            if (line.empty()) {
+                continue;
+            }
+            const auto tab = line.find('\t');
+            try {
+                if (tab == std::string::npos) {
+                    throw ConversionException("tab missing");
+                }
+                m_edits[line.substr(tab + 1)] += stringToNumber<std::uint64_t>(line.substr(0, tab));
+            } catch (const ConversionException &e) {
+                cerr << Phrases::Warning << "Ignoring line " << lineNumber << " of the edit history \"" << m_path << "\": " << e.what()
+                     << Phrases::EndFlush;
+            }
+        }
+    } catch (const std::ios_base::failure &e) {
+        m_edits.clear();
+        cerr << Phrases::Warning << "Unable to read the edit history \"" << m_path << "\": " << e.what() << Phrases::End
+             << "note: The history will be recreated." << endl;
+    }
+}
+
+/*!
+ * \brief Returns the absolute path of \a file as used for identifying it within the history.
+ */
+std::string EditHistory::absolutePath(const char *file)
+{
+    auto error = std::error_code();
+    const auto path = std::filesystem::absolute(makeNativePath(file), error);
+    return error ? std::string(file) : path.lexically_normal().string();
+}
+
+/*!
+ * \brief Determines the padding for \a fileInfo according to the adaptive padding policy.
+ *
+ * The padding is sized to allow the text fields to grow by half and the largest cover to be replaced by one of 1.5 times
+ * its size without rewriting the file. Files which have been edited before get up to four times as much padding as files
+ * edited for the first time which are supposed to stay compact.
+ *
+ * The maximum padding is twice the preferred padding unless a maximum has been specified explicitly so files with excessive
+ * padding are shrunk when being edited.
+ *
+ * \remarks Must be invoked after modifying the tags of \a fileInfo.
+ */
+AdaptivePadding computeAdaptivePadding(MediaFileInfo &fileInfo, std::uint64_t editCount, const WritePlanSettings &layout, bool maxPaddingSpecified)
+{
+    // determine the size of the meta-data and the covers
+    // note: Different tags of a file usually contain the same covers so only the tag with most cover data is considered.
+    const auto metaDataSize = computeMetaDataSize(fileInfo);
+    auto coverSize = std::uint64_t(), largestCoverSize = std::uint64_t();
+    for (const auto *const tag : fileInfo.tags()) {
+        auto tagCoverSize = std::uint64_t();
+        for (const auto *const cover : tag->values(KnownField::Cover)) {
+            tagCoverSize += cover->dataSize();
+            largestCoverSize = std::max<std::uint64_t>(largestCoverSize, cover->dataSize());
+        }
+        coverSize = std::max(coverSize, tagCoverSize);
+    }
+    const auto textSize = metaDataSize > coverSize ? metaDataSize - coverSize : 0;
+
+    // compute the padding
+    auto padding = AdaptivePadding();
+    padding.preferred = (basePadding + textSize / 2 + largestCoverSize / 2) * std::min(editCount + 1, maxEditFactor);
+    padding.preferred = std::max(padding.preferred, layout.minPadding);
+    if (maxPaddingSpecified) {
+        padding.max = layout.maxPadding;
+        padding.preferred = std::max(std::min(padding.preferred, layout.maxPadding), layout.minPadding);
+    } else {
+        padding.max = padding.preferred * 2;
+    }
+    return padding;
+}
+
+} // namespace Cli
@@ -0,0 +1,59 @@
+#ifndef CLI_PADDINGPOLICY
+#define CLI_PADDINGPOLICY
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace TagParser {
+class MediaFileInfo;
+}
+
+namespace Cli {
+
+struct WritePlanSettings;
+
+/*!
+ * \brief The EditHistory class records how often files have been edited via the set operation (see --padding-history).
+ *
+ * The history is stored as text file where each line contains the number of edits and the absolute path of a file separated
+ * by a tab.
+ *
+ * \remarks
+ * - The history is loaded completely when constructing the object and only written back when invoking save().
+ * - editCount() and recordEdit() may be invoked from multiple threads.
+ */
+class EditHistory {
+public:
+    explicit EditHistory(std::string_view path);
+
+    std::uint64_t editCount(const char *file);
+    void recordEdit(const char *file);
+    void save();
+
+private:
+    void load();
+    static std::string absolutePath(const char *file);
+
+    std::string m_path;
+    std::unordered_map<std::string, std::uint64_t> m_edits;
+    std::mutex m_mutex;
+    bool m_modified;
+};
+
+/*!
+ * \brief The AdaptivePadding struct holds the padding determined for a file by the adaptive padding policy.
+ */
+struct AdaptivePadding {
+    std::uint64_t preferred = 0;
+    std::uint64_t max = 0;
+};
+
+AdaptivePadding computeAdaptivePadding(
+    TagParser::MediaFileInfo &fileInfo, std::uint64_t editCount, const WritePlanSettings &layout, bool maxPaddingSpecified);
+
+} // namespace Cli
+
+#endif // CLI_PADDINGPOLICY
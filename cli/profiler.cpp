@@ -0,0 +1,299 @@
+#include "./profiler.h"
+
+#include <c++utilities/application/argumentparser.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+
+namespace Cli {
+
+/// \brief The names of the phases as shown in the table and the trace file.
+static constexpr const char *phaseNames[] = {
+    "open",
+    "parse container format",
+    "parse tags",
+    "parse tracks",
+    "parse attachments",
+    "parse remaining elements",
+    "create tags",
+    "execute JavaScript",
+    "modify tags",
+    "apply changes",
+    "serialize",
+};
+static_assert(sizeof(phaseNames) / sizeof(phaseNames[0]) == static_cast<std::size_t>(ProfilePhase::Count));
+
+/*!
+ * \brief Reads the number of bytes read and written by the current thread so far.
+ * \remarks Only supported under Linux; the counters stay zero on other platforms.
+ */
+static void readIoCounters(std::uint64_t &bytesRead, std::uint64_t &bytesWritten)
+{
+    bytesRead = bytesWritten = 0;
+#if defined(PLATFORM_LINUX)
+    auto io = std::ifstream("/proc/thread-self/io");
+    auto key = std::string();
+    auto value = std::uint64_t();
+    while (io >> key >> value) {
+        if (key == "rchar:") {
+            bytesRead = value;
+        } else if (key == "wchar:") {
+            bytesWritten = value;
+        }
+    }
+#endif
+}
+
+/*!
+ * \brief Returns \a duration in milliseconds.
+ */
+static double toMilliseconds(ProfileClock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/*!
+ * \brief Returns \a duration in microseconds as used by the trace file.
+ */
+static long long toMicroseconds(ProfileClock::duration duration)
+{
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+/*!
+ * \brief Writes \a str as JSON string to \a out.
+ */
+static void writeJsonString(std::ostream &out, std::string_view str)
+{
+    out << '"';
+    for (const auto c : str) {
+        switch (c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+            } else {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+}
+
+/*!
+ * \brief Starts profiling the file with the specified \a path populating \a profile (if not nullptr).
+ */
+ProfileTimer::ProfileTimer(FileProfile *profile, std::string_view path)
+    : m_profile(profile)
+    , m_bytesRead(0)
+    , m_bytesWritten(0)
+{
+    if (!m_profile) {
+        return;
+    }
+    m_profile->path = path;
+    m_profile->events.clear();
+    m_profile->thread = std::this_thread::get_id();
+    m_profile->bytesRead = m_profile->bytesWritten = 0;
+    m_profile->rewritten = m_profile->cloned = m_profile->unchanged = false;
+    m_profile->active = true;
+    readIoCounters(m_bytesRead, m_bytesWritten);
+    m_profile->start = m_last = ProfileClock::now();
+}
+
+/*!
+ * \brief Finishes profiling the file.
+ */
+ProfileTimer::~ProfileTimer()
+{
+    if (!m_profile) {
+        return;
+    }
+    m_profile->end = ProfileClock::now();
+    auto bytesRead = std::uint64_t(), bytesWritten = std::uint64_t();
+    readIoCounters(bytesRead, bytesWritten);
+    m_profile->bytesRead = bytesRead - m_bytesRead;
+    m_profile->bytesWritten = bytesWritten - m_bytesWritten;
+}
+
+/*!
+ * \brief Enables profiling if \a profileArg is present; its value (if any) is the path of the trace file to write.
+ * \remarks Exits the app if more than one value has been specified or the trace file can not be opened.
+ */
+Profiler::Profiler(const Argument &profileArg)
+    : m_enabled(profileArg.isPresent())
+    , m_start(ProfileClock::now())
+    , m_total(ProfileClock::duration::zero())
+    , m_files(0)
+    , m_rewrites(0)
+    , m_clones(0)
+    , m_unchanged(0)
+    , m_coverValues(0)
+    , m_coverFilesRead(0)
+    , m_bytesRead(0)
+    , m_bytesWritten(0)
+    , m_firstTraceEvent(true)
+{
+    if (!m_enabled || profileArg.values().empty()) {
+        return;
+    }
+    if (profileArg.values().size() > 1) {
+        cerr << Phrases::Error << "Only one trace file can be specified via --profile." << Phrases::End
+             << "note: Values following --profile are taken as trace file so specify other values (e.g. field names) before --profile."
+             << endl;
+        std::exit(EXIT_FAILURE);
+    }
+    m_tracePath = profileArg.values().front();
+    m_trace.exceptions(ios_base::badbit | ios_base::failbit);
+    try {
+        m_trace.open(m_tracePath, ios_base::out | ios_base::trunc | ios_base::binary);
+        m_trace << "{\"traceEvents\":[";
+    } catch (const std::ios_base::failure &) {
+        cerr << Phrases::Error << "Unable to open the trace file \"" << m_tracePath << "\"." << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/*!
+ * \brief Adds the specified \a profile to the statistics and the trace file.
+ * \remarks Does nothing if the \a profile has not been populated (e.g. because a cached result has been used).
+ */
+void Profiler::add(FileProfile &profile)
+{
+    if (!m_enabled || !profile.active) {
+        return;
+    }
+    profile.active = false;
+
+    auto visitedPhases = std::array<bool, static_cast<std::size_t>(ProfilePhase::Count)>();
+    for (const auto &event : profile.events) {
+        const auto phaseIndex = static_cast<std::size_t>(event.phase);
+        auto &phase = m_phases[phaseIndex];
+        phase.total += event.duration;
+        phase.max = std::max(phase.max, event.duration);
+        if (!visitedPhases[phaseIndex]) {
+            visitedPhases[phaseIndex] = true;
+            ++phase.files;
+        }
+    }
+    m_total += profile.end - profile.start;
+    m_bytesRead += profile.bytesRead;
+    m_bytesWritten += profile.bytesWritten;
+    m_rewrites += profile.rewritten;
+    m_clones += profile.cloned;
+    m_unchanged += profile.unchanged;
+    ++m_files;
+
+    if (!m_trace.is_open()) {
+        return;
+    }
+    const auto thread = threadIndex(profile.thread);
+    try {
+        writeTraceEvent("file", profile.path, profile.start, profile.end - profile.start, thread);
+        for (const auto &event : profile.events) {
+            writeTraceEvent(phaseNames[static_cast<std::size_t>(event.phase)], profile.path, event.start, event.duration, thread);
+        }
+    } catch (const std::ios_base::failure &) {
+        cerr << Phrases::Warning << "Unable to write to the trace file \"" << m_tracePath << "\"." << Phrases::EndFlush;
+        m_trace.exceptions(ios_base::goodbit);
+        m_trace.close();
+    }
+}
+
+/*!
+ * \brief Records that files (e.g. covers) have been requested \a values times as field values and \a filesRead of them were read.
+ */
+void Profiler::addCoverFiles(std::size_t values, std::size_t filesRead)
+{
+    m_coverValues += values;
+    m_coverFilesRead += filesRead;
+}
+
+/*!
+ * \brief Prints the aggregated statistics to stderr and finalizes the trace file.
+ */
+void Profiler::finish()
+{
+    if (!m_enabled) {
+        return;
+    }
+    if (m_trace.is_open()) {
+        try {
+            m_trace << "\n]}\n";
+            m_trace.close();
+        } catch (const std::ios_base::failure &) {
+            cerr << Phrases::Warning << "Unable to write to the trace file \"" << m_tracePath << "\"." << Phrases::EndFlush;
+        }
+    }
+
+    const auto wallTime = ProfileClock::now() - m_start;
+    cerr << TextAttribute::Bold << "Profile" << TextAttribute::Reset << '\n';
+    cerr << " - Files:         " << m_files << " (" << m_rewrites << " rewritten completely, " << m_clones << " cloned, " << m_unchanged
+         << " unchanged)\n";
+    cerr << " - Wall time:     " << std::fixed << std::setprecision(3) << toMilliseconds(wallTime) << " ms (" << toMilliseconds(m_total)
+         << " ms spent processing files)\n";
+    cerr << " - Bytes read:    " << dataSizeToString(m_bytesRead, true) << " (" << dataSizeToString(m_files ? m_bytesRead / m_files : 0)
+         << " per file)\n";
+    cerr << " - Bytes written: " << dataSizeToString(m_bytesWritten, true) << " (" << dataSizeToString(m_files ? m_bytesWritten / m_files : 0)
+         << " per file)\n";
+    if (m_coverValues) {
+        cerr << " - Cover files:   " << m_coverFilesRead << " read, " << m_coverValues << " requested\n";
+    }
+    cerr << ' ' << std::left << std::setw(26) << "Phase" << std::right << std::setw(8) << "Files" << std::setw(14) << "Total (ms)"
+         << std::setw(14) << "Mean (ms)" << std::setw(14) << "Max (ms)" << std::setw(8) << "Share" << '\n';
+    for (auto i = std::size_t(); i != m_phases.size(); ++i) {
+        const auto &phase = m_phases[i];
+        if (!phase.files) {
+            continue;
+        }
+        const auto total = toMilliseconds(phase.total);
+        cerr << ' ' << std::left << std::setw(26) << phaseNames[i] << std::right << std::setw(8) << phase.files << std::setw(14) << total
+             << std::setw(14) << total / static_cast<double>(phase.files) << std::setw(14) << toMilliseconds(phase.max) << std::setw(7)
+             << std::setprecision(1) << (m_total.count() ? total / toMilliseconds(m_total) * 100.0 : 0.0) << '%' << std::setprecision(3)
+             << '\n';
+    }
+    cerr << std::defaultfloat << std::setprecision(6) << std::flush;
+}
+
+/*!
+ * \brief Returns a small number identifying the specified \a thread within the trace file.
+ */
+std::size_t Profiler::threadIndex(std::thread::id thread)
+{
+    const auto i = std::find(m_threads.begin(), m_threads.end(), thread);
+    if (i != m_threads.end()) {
+        return static_cast<std::size_t>(i - m_threads.begin());
+    }
+    m_threads.emplace_back(thread);
+    return m_threads.size() - 1;
+}
+
+/*!
+ * \brief Writes a "complete event" to the trace file.
+ */
+void Profiler::writeTraceEvent(
+    std::string_view name, std::string_view file, ProfileClock::time_point start, ProfileClock::duration duration, std::size_t thread)
+{
+    m_trace << (m_firstTraceEvent ? "\n" : ",\n") << "{\"name\":";
+    writeJsonString(m_trace, name);
+    m_trace << ",\"cat\":\"file\",\"ph\":\"X\",\"ts\":" << toMicroseconds(start - m_start) << ",\"dur\":" << toMicroseconds(duration)
+            << ",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"file\":";
+    writeJsonString(m_trace, file);
+    m_trace << "}}";
+    m_firstTraceEvent = false;
+}
+
+} // namespace Cli
@@ -0,0 +1,176 @@
+#ifndef CLI_PROFILER
+#define CLI_PROFILER
+
+#include <c++utilities/io/nativefilestream.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace CppUtilities {
+class Argument;
+}
+
+namespace Cli {
+
+/*!
+ * \brief The ProfilePhase enum specifies the phases of processing a file which are distinguished when profiling.
+ */
+enum class ProfilePhase : std::size_t {
+    Open,
+    ParseContainerFormat,
+    ParseTags,
+    ParseTracks,
+    ParseAttachments,
+    ParseRemaining,
+    CreateTags,
+    Script,
+    ModifyTags,
+    ApplyChanges,
+    Serialize,
+    Count,
+};
+
+using ProfileClock = std::chrono::steady_clock;
+
+/*!
+ * \brief The ProfileEvent struct holds the time spent within a phase.
+ */
+struct ProfileEvent {
+    ProfilePhase phase;
+    ProfileClock::time_point start;
+    ProfileClock::duration duration;
+};
+
+/*!
+ * \brief The FileProfile struct holds the measurements for processing a single file.
+ * \remarks Instances are populated via ProfileTimer by the thread processing the file and passed to Profiler::add() afterwards.
+ */
+struct FileProfile {
+    std::string path;
+    std::vector<ProfileEvent> events;
+    ProfileClock::time_point start, end;
+    std::thread::id thread;
+    std::uint64_t bytesRead = 0;
+    std::uint64_t bytesWritten = 0;
+    bool rewritten = false;
+    bool cloned = false;
+    bool unchanged = false;
+    bool active = false;
+};
+
+/*!
+ * \brief The ProfileTimer class measures the phases of processing a file.
+ *
+ * Each invocation of mark() attributes the time since the previous invocation (or the construction) to the specified phase.
+ * So mark() is supposed to be invoked right after the work of a phase has been done.
+ *
+ * \remarks Does nothing if no profile has been specified (profiling is disabled).
+ */
+class ProfileTimer {
+public:
+    explicit ProfileTimer(FileProfile *profile, std::string_view path);
+    ~ProfileTimer();
+    ProfileTimer(const ProfileTimer &) = delete;
+
+    void mark(ProfilePhase phase);
+    void skip();
+
+private:
+    FileProfile *m_profile;
+    ProfileClock::time_point m_last;
+    std::uint64_t m_bytesRead, m_bytesWritten;
+};
+
+/*!
+ * \brief Attributes the time since the last mark to the specified \a phase.
+ */
+inline void ProfileTimer::mark(ProfilePhase phase)
+{
+    if (!m_profile) {
+        return;
+    }
+    const auto now = ProfileClock::now();
+    m_profile->events.emplace_back(ProfileEvent{ phase, m_last, now - m_last });
+    m_last = now;
+}
+
+/*!
+ * \brief Discards the time since the last mark (e.g. for work which does not belong to any phase).
+ */
+inline void ProfileTimer::skip()
+{
+    if (m_profile) {
+        m_last = ProfileClock::now();
+    }
+}
+
+/*!
+ * \brief The Profiler class aggregates the profiles of all processed files when --profile has been specified.
+ * \remarks
+ * - profile() may be invoked from any thread; add() and finish() only from the thread which has created the profiler.
+ * - The trace file (if specified via --profile) uses the Chrome trace event format so it can be viewed via chrome://tracing or Perfetto.
+ */
+class Profiler {
+public:
+    explicit Profiler(const CppUtilities::Argument &profileArg);
+
+    bool isEnabled() const;
+    FileProfile *profile(FileProfile &profile) const;
+    void add(FileProfile &profile);
+    void addCoverFiles(std::size_t values, std::size_t filesRead);
+    void finish();
+
+private:
+    struct PhaseStatistics {
+        ProfileClock::duration total = ProfileClock::duration::zero();
+        ProfileClock::duration max = ProfileClock::duration::zero();
+        std::size_t files = 0;
+    };
+
+    std::size_t threadIndex(std::thread::id thread);
+    void writeTraceEvent(std::string_view name, std::string_view file, ProfileClock::time_point start, ProfileClock::duration duration,
+        std::size_t thread);
+
+    bool m_enabled;
+    ProfileClock::time_point m_start;
+    std::array<PhaseStatistics, static_cast<std::size_t>(ProfilePhase::Count)> m_phases;
+    ProfileClock::duration m_total;
+    std::size_t m_files;
+    std::size_t m_rewrites;
+    std::size_t m_clones;
+    std::size_t m_unchanged;
+    std::size_t m_coverValues;
+    std::size_t m_coverFilesRead;
+    std::uint64_t m_bytesRead;
+    std::uint64_t m_bytesWritten;
+    std::vector<std::thread::id> m_threads;
+    std::string m_tracePath;
+    CppUtilities::NativeFileStream m_trace;
+    bool m_firstTraceEvent;
+};
+
+/*!
+ * \brief Returns whether profiling is enabled (--profile has been specified).
+ */
+inline bool Profiler::isEnabled() const
+{
+    return m_enabled;
+}
+
+/*!
+ * \brief Returns \a profile if profiling is enabled; otherwise returns nullptr so ProfileTimer does nothing.
+ */
+inline FileProfile *Profiler::profile(FileProfile &profile) const
+{
+    return m_enabled ? &profile : nullptr;
+}
+
+} // namespace Cli
+
+#endif // CLI_PROFILER
@@ -30,6 +30,7 @@
 #include <QByteArray>
 #include <QCoreApplication>
 #include <QDir>
+#include <QEventLoop>
 #include <QHash>
 #include <QImage>
 #include <QJSEngine>
@@ -69,12 +70,14 @@ UtilityObject::UtilityObject(QJSEngine *engine)
     , m_engine(engine)
     , m_context(nullptr)
     , m_diag(nullptr)
+    , m_out(&std::cout)
+    , m_eventLoop(nullptr)
 {
 }
 
 void UtilityObject::log(const QString &message)
 {
-    std::cout << message.toStdString() << std::endl;
+    *m_out << message.toStdString() << std::endl;
 }
 
 void UtilityObject::diag(const QString &level, const QString &message, const QString &context)
@@ -100,12 +103,19 @@ int UtilityObject::exec(int timeout)
     if (timeout > 0) {
         QTimer::singleShot(timeout, this, [this] { exit(EXIT_FAILURE); });
     }
-    return QCoreApplication::exec();
+    // run a local event loop (instead of the application's one) so this also works within worker threads
+    auto eventLoop = QEventLoop();
+    auto *const previousEventLoop = std::exchange(m_eventLoop, &eventLoop);
+    const auto res = eventLoop.exec();
+    m_eventLoop = previousEventLoop;
+    return res;
 }
 
 void UtilityObject::exit(int retcode)
 {
-    QCoreApplication::exit(retcode);
+    if (m_eventLoop) {
+        m_eventLoop->exit(retcode);
+    }
 }
 
 QJSValue UtilityObject::readEnvironmentVariable(const QString &variable, const QJSValue &defaultValue) const
@@ -653,6 +663,7 @@ MediaFileInfoObject::MediaFileInfoObject(
     , m_f(mediaFileInfo)
     , m_diag(diag)
     , m_engine(engine)
+    , m_out(&std::cout)
     , m_quiet(quiet)
 {
 }
@@ -751,7 +762,7 @@ bool MediaFileInfoObject::rename(const QString &newPath)
         return false;
     }
     if (!m_quiet) {
-        std::cout << " - Renamed \"" << from << "\" to \"" << toView << "\"\n";
+        *m_out << " - Renamed \"" << from << "\" to \"" << toView << "\"\n";
     }
     return true;
 }
@@ -16,6 +16,9 @@ QT_END_NAMESPACE
 #include <QJSValue>
 #include <QObject>
 
+#include <iosfwd>
+
+QT_FORWARD_DECLARE_CLASS(QEventLoop)
 QT_FORWARD_DECLARE_CLASS(QJSEngine)
 
 namespace TagParser {
@@ -43,6 +46,7 @@ public:
     explicit UtilityObject(QJSEngine *engine);
 
     void setDiag(const std::string *context, TagParser::Diagnostics *diag);
+    void setOutput(std::ostream *out);
 
 public Q_SLOTS:
     void log(const QString &message);
@@ -75,6 +79,8 @@ private:
     const std::string *m_context;
     static const std::string s_defaultContext;
     TagParser::Diagnostics *m_diag;
+    std::ostream *m_out;
+    QEventLoop *m_eventLoop;
 };
 
 inline void UtilityObject::setDiag(const std::string *context, TagParser::Diagnostics *diag)
@@ -83,6 +89,14 @@ inline void UtilityObject::setDiag(const std::string *context, TagParser::Diagno
     m_diag = diag;
 }
 
+/*!
+ * \brief Sets the stream log() writes to (std::cout by default).
+ */
+inline void UtilityObject::setOutput(std::ostream *out)
+{
+    m_out = out;
+}
+
 class TagValueObject;
 
 /*!
@@ -215,6 +229,7 @@ public:
     QString savePath() const;
     void setSavePath(const QString &path);
     QList<TagObject *> &tags();
+    void setOutput(std::ostream *out);
 
 public Q_SLOTS:
     void applyChanges();
@@ -226,6 +241,7 @@ private:
     TagParser::Diagnostics &m_diag;
     QJSEngine *m_engine;
     QList<TagObject *> m_tags;
+    std::ostream *m_out;
     bool m_quiet;
 };
 
@@ -234,6 +250,14 @@ inline TagParser::MediaFileInfo &MediaFileInfoObject::fileInfo()
     return m_f;
 }
 
+/*!
+ * \brief Sets the stream status messages (e.g. about renaming the file) are written to (std::cout by default).
+ */
+inline void MediaFileInfoObject::setOutput(std::ostream *out)
+{
+    m_out = out;
+}
+
 } // namespace Cli
 
 #endif // CLI_SCRIPT_API_H
@@ -0,0 +1,545 @@
+#include "./server.h"
+#include "./helper.h"
+#include "./mainfeatures.h"
+
+#include "resources/config.h"
+
+#include <c++utilities/application/argumentparser.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#if defined(PLATFORM_UNIX) && defined(TAGEDITOR_JSON_EXPORT)
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+
+namespace Cli {
+
+#if defined(PLATFORM_UNIX) && defined(TAGEDITOR_JSON_EXPORT)
+
+using ResponseWriter = RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::StringBuffer>;
+
+/// \brief The operations which can be invoked via requests.
+static constexpr std::string_view servedMethods[] = { "info", "get", "set", "export" };
+/// \brief Whether the current process has been forked from a process serving requests.
+static auto serving = false;
+
+/*!
+ * \brief Writes all of the specified \a data to the specified \a fd.
+ */
+static bool writeAll(int fd, std::string_view data)
+{
+    while (!data.empty()) {
+        const auto written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+/*!
+ * \brief Reads the whole contents of the specified \a file.
+ */
+static std::string readAll(std::FILE *file)
+{
+    auto contents = std::string();
+    char buffer[4096];
+    std::rewind(file);
+    for (std::size_t bytesRead; (bytesRead = std::fread(buffer, 1, sizeof(buffer), file));) {
+        contents.append(buffer, bytesRead);
+    }
+    return contents;
+}
+
+/*!
+ * \brief Writes the members of a JSON-RPC 2.0 response which are present in every response.
+ */
+static void beginResponse(ResponseWriter &writer, const RAPIDJSON_NAMESPACE::Value &id)
+{
+    writer.StartObject();
+    writer.Key("jsonrpc");
+    writer.String("2.0");
+    writer.Key("id");
+    id.Accept(writer);
+}
+
+/*!
+ * \brief Returns a response for the request with the specified \a id which failed with the specified \a code and \a message.
+ * \remarks The codes are the ones defined by JSON-RPC 2.0.
+ */
+static std::string makeErrorResponse(const RAPIDJSON_NAMESPACE::Value &id, int code, std::string_view message)
+{
+    auto buffer = RAPIDJSON_NAMESPACE::StringBuffer();
+    auto writer = ResponseWriter(buffer);
+    beginResponse(writer, id);
+    writer.Key("error");
+    writer.StartObject();
+    writer.Key("code");
+    writer.Int(code);
+    writer.Key("message");
+    writer.String(message.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(message.size()));
+    writer.EndObject();
+    writer.EndObject();
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+/*!
+ * \brief Reads exactly \a size bytes from the specified \a fd into \a buffer.
+ * \returns Returns whether all bytes could be read (and not end-of-file or an error has been encountered).
+ */
+static bool readExactly(int fd, void *buffer, std::size_t size)
+{
+    for (auto *data = static_cast<char *>(buffer); size;) {
+        const auto bytesRead = ::read(fd, data, size);
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            return false;
+        }
+        data += bytesRead;
+        size -= static_cast<std::size_t>(bytesRead);
+    }
+    return true;
+}
+
+/*!
+ * \brief The RequestWorker class runs the operations requested via a single connection in a long-lived child process.
+ *
+ * The worker process is kept running between requests so state which is kept by the operations (most notably the
+ * JavaScript engine with the script loaded for "set --script") stays warm for subsequent requests of the connection. The
+ * worker process writes its output into temporary files which are shared with the connection handler. So the existing
+ * implementation of the operations is used as-is (including its error handling which might just exit).
+ *
+ * \remarks If an operation exits the worker process, its exit status is used as result and a new worker process is
+ *          started for the next request.
+ */
+class RequestWorker {
+public:
+    explicit RequestWorker(const CommandRunner &runCommand, int connection);
+    RequestWorker(const RequestWorker &) = delete;
+    ~RequestWorker();
+
+    bool run(const std::vector<const char *> &args, int &exitStatus, std::string &output, std::string &errors);
+
+private:
+    bool start();
+    void stop();
+    [[noreturn]] void serveRequests(int requestFd, int resultFd);
+
+    const CommandRunner &m_runCommand;
+    int m_connection;
+    pid_t m_pid;
+    int m_requestFd;
+    int m_resultFd;
+    std::FILE *m_outputFile;
+    std::FILE *m_errorFile;
+};
+
+/*!
+ * \brief Initializes the worker; the worker process is only started when running the first request.
+ * \remarks The \a connection is closed within the worker process as it is only served by the connection handler.
+ */
+RequestWorker::RequestWorker(const CommandRunner &runCommand, int connection)
+    : m_runCommand(runCommand)
+    , m_connection(connection)
+    , m_pid(-1)
+    , m_requestFd(-1)
+    , m_resultFd(-1)
+    , m_outputFile(nullptr)
+    , m_errorFile(nullptr)
+{
+}
+
+/*!
+ * \brief Stops the worker process.
+ */
+RequestWorker::~RequestWorker()
+{
+    stop();
+}
+
+/*!
+ * \brief Starts the worker process.
+ */
+bool RequestWorker::start()
+{
+    int requestPipe[2], resultPipe[2];
+    if (::pipe(requestPipe)) {
+        return false;
+    }
+    if (::pipe(resultPipe)) {
+        ::close(requestPipe[0]);
+        ::close(requestPipe[1]);
+        return false;
+    }
+    m_requestFd = requestPipe[1];
+    m_resultFd = resultPipe[0];
+    m_outputFile = std::tmpfile();
+    m_errorFile = std::tmpfile();
+    if (m_outputFile && m_errorFile) {
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        m_pid = ::fork();
+    }
+    if (!m_pid) {
+        ::close(m_connection);
+        ::close(requestPipe[1]);
+        ::close(resultPipe[0]);
+        serveRequests(requestPipe[0], resultPipe[1]);
+    }
+    ::close(requestPipe[0]);
+    ::close(resultPipe[1]);
+    if (m_pid < 0) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Stops the worker process (if running) and releases all resources associated with it.
+ */
+void RequestWorker::stop()
+{
+    for (auto *const fd : { &m_requestFd, &m_resultFd }) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    for (auto *const file : { &m_outputFile, &m_errorFile }) {
+        if (*file) {
+            std::fclose(*file);
+            *file = nullptr;
+        }
+    }
+    if (m_pid > 0) {
+        while (::waitpid(m_pid, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+    m_pid = -1;
+}
+
+/*!
+ * \brief Runs the requests received via \a requestFd one after another within the worker process.
+ *
+ * Each request is sent as its size followed by the null-terminated arguments. The exit code of the operation is written to
+ * \a resultFd when the operation has returned.
+ */
+void RequestWorker::serveRequests(int requestFd, int resultFd)
+{
+    ::dup2(::fileno(m_outputFile), STDOUT_FILENO);
+    ::dup2(::fileno(m_errorFile), STDERR_FILENO);
+    EscapeCodes::enabled = false;
+    keepJavaScriptEnginesAlive();
+    auto request = std::string();
+    auto args = std::vector<const char *>();
+    for (std::uint32_t size; readExactly(requestFd, &size, sizeof(size));) {
+        request.resize(size);
+        if (!readExactly(requestFd, request.data(), size)) {
+            break;
+        }
+        args.clear();
+        for (auto arg = std::string::size_type(); arg < request.size(); arg = request.find('\0', arg) + 1) {
+            args.emplace_back(request.data() + arg);
+        }
+        const auto argc = static_cast<int>(args.size());
+        args.emplace_back(nullptr);
+        exitCode = EXIT_SUCCESS;
+        const auto res = m_runCommand(argc, args.data());
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        if (!writeAll(resultFd, std::string_view(reinterpret_cast<const char *>(&res), sizeof(res)))) {
+            break;
+        }
+    }
+    ::_exit(EXIT_SUCCESS);
+}
+
+/*!
+ * \brief Runs the operation specified via \a args within the worker process (starting it if not running yet).
+ * \returns Returns whether the operation could be run; if so \a exitStatus, \a output and \a errors are populated.
+ */
+bool RequestWorker::run(const std::vector<const char *> &args, int &exitStatus, std::string &output, std::string &errors)
+{
+    if (m_pid < 0 && !start()) {
+        return false;
+    }
+
+    // clear the output of the previous request (the file offset is shared with the worker process)
+    for (auto *const file : { m_outputFile, m_errorFile }) {
+        std::fflush(file);
+        if (::ftruncate(::fileno(file), 0)) {
+            return false;
+        }
+        std::rewind(file);
+    }
+
+    // send the request and wait for the result
+    auto request = std::string();
+    for (const auto *const arg : args) {
+        request.append(arg);
+        request += '\0';
+    }
+    const auto size = static_cast<std::uint32_t>(request.size());
+    auto res = 0;
+    if (writeAll(m_requestFd, std::string_view(reinterpret_cast<const char *>(&size), sizeof(size))) && writeAll(m_requestFd, request)
+        && readExactly(m_resultFd, &res, sizeof(res))) {
+        exitStatus = res;
+    } else {
+        // the operation has exited the worker process so use the exit status as result and start a new process next time
+        auto status = 0;
+        while (::waitpid(m_pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        m_pid = -1;
+        exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    }
+    output = readAll(m_outputFile);
+    errors = readAll(m_errorFile);
+    if (m_pid < 0) {
+        stop();
+    }
+    return true;
+}
+
+/*!
+ * \brief Handles the specified \a request via the specified \a worker and returns the response.
+ */
+static std::string handleRequest(std::string_view line, RequestWorker &worker)
+{
+    // parse request
+    auto request = RAPIDJSON_NAMESPACE::Document();
+    const auto nullId = RAPIDJSON_NAMESPACE::Value();
+    if (request.Parse(line.data(), line.size()).HasParseError()) {
+        return makeErrorResponse(nullId, -32700, "Parse error");
+    }
+    if (!request.IsObject()) {
+        return makeErrorResponse(nullId, -32600, "Invalid Request: the request is not a JSON object");
+    }
+    const auto idMember = request.FindMember("id");
+    const auto &id = idMember != request.MemberEnd() ? idMember->value : nullId;
+    const auto method = request.FindMember("method");
+    if (method == request.MemberEnd() || !method->value.IsString()) {
+        return makeErrorResponse(id, -32600, "Invalid Request: \"method\" is not a string");
+    }
+    const auto methodName = std::string_view(method->value.GetString(), method->value.GetStringLength());
+    if (std::find(std::begin(servedMethods), std::end(servedMethods), methodName) == std::end(servedMethods)) {
+        return makeErrorResponse(id, -32601, "Method not found");
+    }
+    auto args = std::vector<const char *>{ PROJECT_NAME, method->value.GetString() };
+    if (const auto params = request.FindMember("params"); params != request.MemberEnd()) {
+        if (!params->value.IsArray()) {
+            return makeErrorResponse(id, -32602, "Invalid params: \"params\" is not an array");
+        }
+        for (const auto &param : params->value.GetArray()) {
+            if (!param.IsString()) {
+                return makeErrorResponse(id, -32602, "Invalid params: \"params\" contains a value which is not a string");
+            }
+            args.emplace_back(param.GetString());
+        }
+    }
+
+    // run the operation capturing its output
+    auto exitStatus = 0;
+    auto output = std::string(), errors = std::string();
+    if (!worker.run(args, exitStatus, output, errors)) {
+        return makeErrorResponse(id, -32603, "Internal error: unable to create process");
+    }
+
+    // make response
+    auto buffer = RAPIDJSON_NAMESPACE::StringBuffer();
+    auto writer = ResponseWriter(buffer);
+    beginResponse(writer, id);
+    writer.Key("result");
+    writer.StartObject();
+    writer.Key("exitCode");
+    writer.Int(exitStatus);
+    writer.Key("stdout");
+    writer.String(output.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(output.size()));
+    writer.Key("stderr");
+    writer.String(errors.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(errors.size()));
+    writer.EndObject();
+    writer.EndObject();
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+/*!
+ * \brief Handles the requests received via the specified \a connection (one JSON object per line) until the client disconnects.
+ */
+static void serveConnection(int connection, const CommandRunner &runCommand)
+{
+    auto worker = RequestWorker(runCommand, connection);
+    auto received = std::string();
+    char buffer[4096];
+    for (;;) {
+        const auto bytesRead = ::read(connection, buffer, sizeof(buffer));
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            return;
+        }
+        received.append(buffer, static_cast<std::size_t>(bytesRead));
+        auto lineBegin = std::string::size_type();
+        for (auto lineEnd = received.find('\n'); lineEnd != std::string::npos; lineEnd = received.find('\n', lineBegin)) {
+            const auto line = std::string_view(received.data() + lineBegin, lineEnd - lineBegin);
+            lineBegin = lineEnd + 1;
+            if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+                continue;
+            }
+            if (!writeAll(connection, handleRequest(line, worker) + '\n')) {
+                return;
+            }
+        }
+        received.erase(0, lineBegin);
+    }
+}
+
+/*!
+ * \brief Implements the "serve"-operation of the CLI.
+ *
+ * Listens on a Unix domain socket for JSON-RPC 2.0 style requests (one JSON object per line) to run the "info", "get", "set"
+ * and "export" operations. Each connection is handled in its own process so multiple clients are served concurrently.
+ *
+ * \remarks
+ * - The requests of a connection are run by a worker process forked from the server so the startup costs of a new process
+ *   (loading libraries, initializing static data) are avoided. The worker process is kept running between the requests
+ *   of the connection so e.g. a script passed via "set --script" is only loaded once (see RequestWorker).
+ * - Requests of a single connection are processed one after another so clients should open multiple connections to
+ *   process requests concurrently.
+ */
+void serve(const Argument &socketArg, const Argument &maxConnectionsArg, const CommandRunner &runCommand)
+{
+    if (serving) {
+        std::cerr << Phrases::Error << "The \"serve\"-operation can not be invoked via a request." << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+    serving = true;
+
+    // create socket
+    const auto path = std::string_view(socketArg.values().front());
+    auto address = sockaddr_un();
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << Phrases::Error << "The socket path \"" << path << "\" is empty or too long." << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+    path.copy(address.sun_path, path.size());
+    const auto server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        std::cerr << Phrases::Error << "Unable to create socket: " << std::strerror(errno) << Phrases::EndFlush;
+        std::exit(EXIT_IO_FAILURE);
+    }
+
+    // remove a stale socket (but don't remove any other kind of file or a socket another server is still listening on)
+    struct stat fileStat;
+    if (!::stat(address.sun_path, &fileStat) && S_ISSOCK(fileStat.st_mode)) {
+        const auto probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        const auto connectError = probe < 0 || !::connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) ? 0 : errno;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (connectError != ECONNREFUSED) {
+            std::cerr << Phrases::Error << "The socket \"" << path << "\" is already in use." << Phrases::End
+                      << "note: Another server seems to be listening on it. Remove the socket manually if that's not the case." << endl;
+            ::close(server);
+            std::exit(EXIT_FAILURE);
+        }
+        ::unlink(address.sun_path);
+    }
+    if (::bind(server, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) || ::listen(server, SOMAXCONN)) {
+        std::cerr << Phrases::Error << "Unable to listen on \"" << path << "\": " << std::strerror(errno) << Phrases::EndFlush;
+        ::close(server);
+        std::exit(EXIT_IO_FAILURE);
+    }
+    std::cout << "Serving requests via \"" << path << "\" ..." << std::endl;
+
+    // accept connections, handle each connection in a child process
+    const auto maxConnections = parseUInt64(maxConnectionsArg, 0);
+    for (auto connectionCount = std::uint64_t(); !maxConnections || connectionCount < maxConnections;) {
+        const auto connection = ::accept(server, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            std::cerr << Phrases::Error << "Unable to accept connection: " << std::strerror(errno) << Phrases::EndFlush;
+            exitCode = EXIT_IO_FAILURE;
+            break;
+        }
+        ++connectionCount;
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        const auto pid = ::fork();
+        if (!pid) {
+            ::close(server);
+            ::signal(SIGPIPE, SIG_IGN); // just stop serving the connection when the client disconnects prematurely
+            serveConnection(connection, runCommand);
+            ::close(connection);
+            ::_exit(EXIT_SUCCESS);
+        }
+        ::close(connection);
+        if (pid < 0) {
+            std::cerr << Phrases::Error << "Unable to create process for handling connection: " << std::strerror(errno) << Phrases::EndFlush;
+        }
+        // reap connection handlers which have already exited
+        while (::waitpid(-1, nullptr, WNOHANG) > 0) {
+        }
+    }
+
+    // wait for ongoing connections when stopping
+    ::close(server);
+    ::unlink(address.sun_path);
+    while (::waitpid(-1, nullptr, 0) > 0 || errno == EINTR) {
+    }
+}
+
+#else
+
+void serve(const Argument &socketArg, const Argument &maxConnectionsArg, const CommandRunner &runCommand)
+{
+    CPP_UTILITIES_UNUSED(socketArg);
+    CPP_UTILITIES_UNUSED(maxConnectionsArg);
+    CPP_UTILITIES_UNUSED(runCommand);
+#if !defined(PLATFORM_UNIX)
+    std::cerr << Phrases::Error << "Serving requests is only supported under UNIX-like platforms." << Phrases::EndFlush;
+#else
+    std::cerr << Phrases::Error << "Serving requests requires JSON support which has been disabled at compile-time." << Phrases::EndFlush;
+#endif
+    std::exit(EXIT_FAILURE);
+}
+
+#endif
+
+} // namespace Cli
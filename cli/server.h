@@ -0,0 +1,21 @@
+#ifndef CLI_SERVER
+#define CLI_SERVER
+
+#include <functional>
+
+namespace CppUtilities {
+class Argument;
+}
+
+namespace Cli {
+
+/*!
+ * \brief Runs the CLI with the specified arguments (like main() but without initialization) and returns the exit code.
+ */
+using CommandRunner = std::function<int(int argc, const char *const *argv)>;
+
+void serve(const CppUtilities::Argument &socketArg, const CppUtilities::Argument &maxConnectionsArg, const CommandRunner &runCommand);
+
+} // namespace Cli
+
+#endif // CLI_SERVER
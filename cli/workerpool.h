@@ -0,0 +1,175 @@
+#ifndef CLI_WORKER_POOL
+#define CLI_WORKER_POOL
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Cli {
+
+/*!
+ * \brief Returns the number of slots to use when processing \a itemCount items via processInOrder() with \a jobs worker threads.
+ * \remarks Uses more slots than threads so a slow item does not immediately block the other threads.
+ */
+constexpr std::size_t slotCountFor(std::size_t jobs, std::size_t itemCount)
+{
+    return jobs > 1 && itemCount > 1 ? jobs * 2 : 1;
+}
+
+/*!
+ * \brief Processes the items provided by \a fetch via \a process using up to \a jobs worker threads and passes the processed
+ *        items to \a emit in the order of their indexes.
+ *
+ * Each item is processed within one of the specified \a slots which are re-used for subsequent items. So at most
+ * \a slots.size() items are held at a time and a slow item only blocks further processing when all slots are in use.
+ *
+ * - \a fetch is invoked as fetch(index, slot) to load the next item into the slot. It returns false if there are no further
+ *   items. It is invoked in the order of the indexes and never concurrently but possibly from a worker thread.
+ * - \a process is invoked as process(index, slot) and must only touch state owned by the slot (or state which is
+ *   read-only while processing). It is invoked concurrently unless \a jobs is 1.
+ * - \a emit is invoked as emit(index, slot) on the calling thread. It may return false to stop processing further items.
+ * - If \a fetch or \a process throws, the exception is re-thrown on the calling thread when the item would have been
+ *   emitted. No further items are fetched after \a fetch has thrown.
+ *
+ * \remarks
+ * - The number of items does not need to be known in advance and the worker threads are kept running until all items have
+ *   been processed. So items can be streamed from a source of arbitrary size without introducing a barrier every few items.
+ * - If \a jobs is 1 (or there is only one slot), everything happens on the calling thread using the first slot and each
+ *   item is emitted immediately after it has been processed.
+ */
+template <typename Slots, typename FetchFunction, typename ProcessFunction, typename EmitFunction>
+void processFetchedInOrder(Slots &slots, std::size_t jobs, FetchFunction &&fetch, ProcessFunction &&process, EmitFunction &&emit)
+{
+    // process everything on the calling thread if no concurrency is wanted
+    const auto slotCount = static_cast<std::size_t>(slots.size());
+    if (jobs <= 1 || slotCount <= 1) {
+        for (auto index = std::size_t(); fetch(index, slots[0]); ++index) {
+            process(index, slots[0]);
+            if (!emit(index, slots[0])) {
+                break;
+            }
+        }
+        return;
+    }
+
+    // use one thread per job
+    auto mutex = std::mutex();
+    auto itemProcessed = std::condition_variable(), slotReleased = std::condition_variable();
+    auto nextIndex = std::size_t(), emittedCount = std::size_t();
+    auto itemCount = std::numeric_limits<std::size_t>::max(); // determined when fetch() returns false for the first time
+    auto processed = std::vector<unsigned char>(slotCount);
+    auto exceptions = std::vector<std::exception_ptr>(slotCount);
+    auto stopped = false;
+    auto threads = std::vector<std::thread>();
+    const auto stopAndJoin = [&] {
+        {
+            auto lock = std::unique_lock<std::mutex>(mutex);
+            stopped = true;
+        }
+        slotReleased.notify_all();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+    };
+    const auto worker = [&] {
+        for (;;) {
+            // claim and fetch the next item as soon as its slot has been released
+            auto lock = std::unique_lock<std::mutex>(mutex);
+            slotReleased.wait(lock, [&] { return stopped || nextIndex >= itemCount || nextIndex < emittedCount + slotCount; });
+            if (stopped || nextIndex >= itemCount) {
+                return;
+            }
+            const auto index = nextIndex;
+            const auto slotIndex = index % slotCount;
+            auto exception = std::exception_ptr();
+            try {
+                if (!fetch(index, slots[slotIndex])) {
+                    itemCount = index;
+                    lock.unlock();
+                    slotReleased.notify_all();
+                    itemProcessed.notify_all();
+                    return;
+                }
+            } catch (...) {
+                exception = std::current_exception();
+                itemCount = index + 1;
+            }
+            ++nextIndex;
+            lock.unlock();
+
+            // process the item without holding the lock
+            if (!exception) {
+                try {
+                    process(index, slots[slotIndex]);
+                } catch (...) {
+                    exception = std::current_exception();
+                }
+            }
+
+            lock.lock();
+            exceptions[slotIndex] = exception;
+            processed[slotIndex] = true;
+            lock.unlock();
+            itemProcessed.notify_all();
+        }
+    };
+    threads.reserve(jobs);
+    for (auto i = jobs; i; --i) {
+        threads.emplace_back(worker);
+    }
+
+    // emit items in order as they become available
+    try {
+        for (auto index = std::size_t();; ++index) {
+            const auto slotIndex = index % slotCount;
+            auto lock = std::unique_lock<std::mutex>(mutex);
+            itemProcessed.wait(lock, [&] { return processed[slotIndex] != 0 || index >= itemCount; });
+            if (!processed[slotIndex]) {
+                break;
+            }
+            auto exception = std::move(exceptions[slotIndex]);
+            exceptions[slotIndex] = nullptr;
+            lock.unlock();
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+            const auto continueProcessing = emit(index, slots[slotIndex]);
+            lock.lock();
+            processed[slotIndex] = false;
+            ++emittedCount;
+            stopped = stopped || !continueProcessing;
+            lock.unlock();
+            slotReleased.notify_all();
+            if (!continueProcessing) {
+                break;
+            }
+        }
+    } catch (...) {
+        stopAndJoin();
+        throw;
+    }
+    stopAndJoin();
+}
+
+/*!
+ * \brief Processes \a itemCount items via \a process using up to \a jobs worker threads and passes the processed items
+ *        to \a emit in the order of their indexes.
+ * \remarks This is processFetchedInOrder() for a number of items known in advance (which are not loaded into the slots
+ *          but just identified by their index). No more threads than items are used.
+ */
+template <typename Slots, typename ProcessFunction, typename EmitFunction>
+void processInOrder(std::size_t itemCount, Slots &slots, std::size_t jobs, ProcessFunction &&process, EmitFunction &&emit)
+{
+    processFetchedInOrder(
+        slots, std::min(jobs, itemCount), [itemCount](std::size_t index, auto &) { return index < itemCount; }, process, emit);
+}
+
+} // namespace Cli
+
+#endif // CLI_WORKER_POOL
@@ -0,0 +1,198 @@
+#include "./writeplan.h"
+#include "./countingstreambuffer.h"
+
+#include <tagparser/abstractcontainer.h>
+#include <tagparser/diagnostics.h>
+#include <tagparser/exceptions.h>
+#include <tagparser/id3/id3v2tag.h>
+#include <tagparser/matroska/matroskaattachment.h>
+#include <tagparser/matroska/matroskatag.h>
+#include <tagparser/mediafileinfo.h>
+#include <tagparser/mp4/mp4tag.h>
+#include <tagparser/signature.h>
+#include <tagparser/vorbis/vorbiscomment.h>
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \brief Resets the plan so it can be re-used for another file.
+ */
+void WritePlan::clear()
+{
+    *this = WritePlan();
+}
+
+/*!
+ * \brief Adds the specified \a plan to the summary.
+ * \remarks Does nothing if the \a plan has not been populated (e.g. because the file could not be parsed).
+ */
+void WritePlanSummary::add(const WritePlan &plan)
+{
+    if (!plan.valid) {
+        return;
+    }
+    ++files;
+    if (plan.unchanged) {
+        ++unchanged;
+        return;
+    }
+    ++(plan.rewrite ? rewrites : inPlaceUpdates);
+    bytesToRead += plan.bytesToRead;
+    bytesToWrite += plan.bytesToWrite;
+}
+
+/*!
+ * \brief Prints the summary to \a out.
+ */
+void WritePlanSummary::print(std::ostream &out) const
+{
+    out << TextAttribute::Bold << "Plan" << TextAttribute::Reset << '\n';
+    out << " - Files:          " << files << " (" << inPlaceUpdates << " updated in-place, " << rewrites << " rewritten completely, " << unchanged
+        << " unchanged)\n";
+    out << " - Projected I/O:  " << dataSizeToString(bytesToRead) << " read, " << dataSizeToString(bytesToWrite) << " written\n";
+    out << "note: No files have been modified." << endl;
+}
+
+/*!
+ * \brief Returns the size of all tags (and Matroska attachments) of \a fileInfo when serialized by the tag parser.
+ * \remarks
+ * - ID3v1 tags are not taken into account as they have a fixed size and are always placed at the end of the file.
+ * - Tags which can not be serialized (e.g. due to invalid values) are not taken into account; applying the changes would
+ *   fail for them anyways.
+ */
+std::uint64_t computeMetaDataSize(MediaFileInfo &fileInfo)
+{
+    auto diag = Diagnostics();
+    auto size = std::uint64_t();
+    for (auto *const tag : fileInfo.tags()) {
+        try {
+            switch (tag->type()) {
+            case TagType::Id3v2Tag:
+                size += static_cast<Id3v2Tag *>(tag)->prepareMaking(diag).requiredSize();
+                break;
+            case TagType::Mp4Tag:
+                size += static_cast<Mp4Tag *>(tag)->prepareMaking(diag).requiredSize();
+                break;
+            case TagType::MatroskaTag:
+                size += static_cast<MatroskaTag *>(tag)->prepareMaking(diag).requiredSize();
+                break;
+            case TagType::VorbisComment:
+            case TagType::OggVorbisComment: {
+                auto buffer = CountingStreamBuffer();
+                auto stream = std::ostream(&buffer);
+                static_cast<VorbisComment *>(tag)->make(stream, VorbisCommentFlags::None, diag);
+                size += buffer.count();
+                break;
+            }
+            default:;
+            }
+        } catch (const TagParser::Failure &) {
+        }
+    }
+    switch (fileInfo.containerFormat()) {
+    case ContainerFormat::Matroska:
+    case ContainerFormat::Webm:
+        for (auto *const attachment : fileInfo.attachments()) {
+            if (attachment->isIgnored()) {
+                continue;
+            }
+            try {
+                size += static_cast<MatroskaAttachment *>(attachment)->prepareMaking(diag).requiredSize();
+            } catch (const TagParser::Failure &) {
+            }
+        }
+        break;
+    default:;
+    }
+    return size;
+}
+
+/*!
+ * \brief Determines whether applying the changes made to \a fileInfo would require a complete rewrite and the projected I/O.
+ * \remarks
+ * - The current meta-data size must have been populated via computeMetaDataSize() before modifying the tags.
+ * - Mirrors the decision the tag parser makes when applying changes: The file is rewritten if forced, if the tag/index needs
+ *   to be moved or if the padding resulting from an in-place update would not be within the configured limits.
+ */
+void planWrite(WritePlan &plan, MediaFileInfo &fileInfo, const WritePlanSettings &settings, const char *outputFile, Diagnostics &diag)
+{
+    plan.fileSize = fileInfo.size();
+    plan.currentPadding = fileInfo.paddingSize();
+    plan.newMetaDataSize = computeMetaDataSize(fileInfo);
+    plan.newPadding = 0;
+    plan.reason.clear();
+    plan.valid = true;
+
+    // check for reasons to rewrite the file regardless of the meta-data size
+    auto *const container = fileInfo.container();
+    const auto isOgg = fileInfo.containerFormat() == ContainerFormat::Ogg;
+    if (outputFile) {
+        plan.reason = "output file specified";
+    } else if (settings.forceRewrite) {
+        plan.reason = "rewrite forced";
+    } else if (isOgg) {
+        plan.reason = "padding not supported for Ogg streams";
+    } else if (container && settings.forceTagPosition && settings.tagPosition != ElementPosition::Keep
+        && container->determineTagPosition(diag) != settings.tagPosition) {
+        plan.reason = "tag position needs to be changed";
+    } else if (container && settings.forceIndexPosition && settings.indexPosition != ElementPosition::Keep
+        && container->determineIndexPosition(diag) != settings.indexPosition) {
+        plan.reason = "index position needs to be changed";
+    } else {
+        // check whether the new meta-data fits into the space occupied by the current meta-data and the padding
+        const auto availableSize = plan.currentMetaDataSize + plan.currentPadding;
+        if (plan.newMetaDataSize > availableSize) {
+            plan.reason = argsToString("meta-data exceeds available space by ", dataSizeToString(plan.newMetaDataSize - availableSize));
+        } else if ((plan.newPadding = availableSize - plan.newMetaDataSize) < settings.minPadding) {
+            plan.reason = argsToString("padding would fall below the minimum of ", dataSizeToString(settings.minPadding));
+        } else if (plan.newPadding > settings.maxPadding) {
+            plan.reason = argsToString("padding would exceed the maximum of ", dataSizeToString(settings.maxPadding));
+        }
+    }
+    plan.rewrite = !plan.reason.empty();
+
+    // project the I/O: an in-place update only writes the meta-data and the padding; a rewrite copies the whole file
+    if (!plan.rewrite) {
+        plan.bytesToRead = 0;
+        plan.bytesToWrite = plan.newMetaDataSize + plan.newPadding;
+        return;
+    }
+    plan.newPadding = isOgg ? 0 : settings.preferredPadding;
+    plan.bytesToRead = plan.fileSize;
+    plan.bytesToWrite
+        = plan.fileSize - std::min(plan.fileSize, plan.currentMetaDataSize + plan.currentPadding) + plan.newMetaDataSize + plan.newPadding;
+}
+
+/*!
+ * \brief Prints the specified \a plan for a single file to \a out.
+ */
+void printWritePlan(std::ostream &out, const WritePlan &plan)
+{
+    if (plan.unchanged) {
+        out << " - Plan: none (the changes would not alter the file)" << endl;
+        return;
+    }
+    if (plan.rewrite) {
+        out << " - Plan: complete rewrite (" << plan.reason << ")\n";
+    } else {
+        out << " - Plan: in-place update (fits into existing padding)\n";
+    }
+    out << "   Meta-data:      " << dataSizeToString(plan.currentMetaDataSize) << " -> " << dataSizeToString(plan.newMetaDataSize) << '\n';
+    out << "   Padding:        " << dataSizeToString(plan.currentPadding) << " -> " << dataSizeToString(plan.newPadding) << '\n';
+    out << "   Projected I/O:  " << dataSizeToString(plan.bytesToRead) << " read, " << dataSizeToString(plan.bytesToWrite) << " written"
+        << endl;
+}
+
+} // namespace Cli
@@ -0,0 +1,77 @@
+#ifndef CLI_WRITEPLAN
+#define CLI_WRITEPLAN
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace TagParser {
+class MediaFileInfo;
+class Diagnostics;
+enum class ElementPosition;
+} // namespace TagParser
+
+namespace Cli {
+
+/*!
+ * \brief The WritePlanSettings struct holds the file layout options relevant to decide whether a file needs to be rewritten.
+ */
+struct WritePlanSettings {
+    std::uint64_t minPadding = 0;
+    std::uint64_t maxPadding = 0;
+    std::uint64_t preferredPadding = 0;
+    TagParser::ElementPosition tagPosition;
+    TagParser::ElementPosition indexPosition;
+    bool forceTagPosition = false;
+    bool forceIndexPosition = false;
+    bool forceRewrite = false;
+};
+
+/*!
+ * \brief The WritePlan struct holds the projected outcome of applying changes to a file (see set --plan).
+ * \remarks
+ * - The meta-data size is the size of the serialized tags (and Matroska attachments) as the tag parser would write them.
+ *   It is determined before and after modifying the tags to compute how much of the available padding would be used.
+ * - The figures are estimations. Changes of track headers and the index are not taken into account.
+ * - Files which would not be altered by applying the changes are flagged as unchanged; they are not written at all.
+ */
+struct WritePlan {
+    void clear();
+
+    std::uint64_t fileSize = 0;
+    std::uint64_t currentMetaDataSize = 0;
+    std::uint64_t newMetaDataSize = 0;
+    std::uint64_t currentPadding = 0;
+    std::uint64_t newPadding = 0;
+    std::uint64_t bytesToRead = 0;
+    std::uint64_t bytesToWrite = 0;
+    std::string reason;
+    bool rewrite = false;
+    bool unchanged = false;
+    bool valid = false;
+};
+
+/*!
+ * \brief The WritePlanSummary struct accumulates the plans of all files.
+ */
+struct WritePlanSummary {
+    void add(const WritePlan &plan);
+    void print(std::ostream &out) const;
+
+    std::size_t files = 0;
+    std::size_t inPlaceUpdates = 0;
+    std::size_t rewrites = 0;
+    std::size_t unchanged = 0;
+    std::uint64_t bytesToRead = 0;
+    std::uint64_t bytesToWrite = 0;
+};
+
+std::uint64_t computeMetaDataSize(TagParser::MediaFileInfo &fileInfo);
+void planWrite(WritePlan &plan, TagParser::MediaFileInfo &fileInfo, const WritePlanSettings &settings, const char *outputFile,
+    TagParser::Diagnostics &diag);
+void printWritePlan(std::ostream &out, const WritePlan &plan);
+
+} // namespace Cli
+
+#endif // CLI_WRITEPLAN
@@ -63,6 +63,8 @@ RenameFilesDialog::RenameFilesDialog(QWidget *parent)
     m_ui->generatePreviewPushButton->setIcon(style()->standardIcon(QStyle::SP_BrowserReload, nullptr, m_ui->generatePreviewPushButton));
     m_ui->applyChangingsPushButton->setIcon(style()->standardIcon(QStyle::SP_DialogApplyButton, nullptr, m_ui->applyChangingsPushButton));
     m_ui->applyChangingsPushButton->setEnabled(false);
+    m_ui->undoPushButton->setIcon(style()->standardIcon(QStyle::SP_ArrowBack, nullptr, m_ui->undoPushButton));
+    m_ui->undoPushButton->setEnabled(RenamingEngine::canUndo());
     m_ui->abortClosePushButton->setIcon(style()->standardIcon(QStyle::SP_DialogCancelButton, nullptr, m_ui->abortClosePushButton));
 
     // restore settings
@@ -81,9 +83,11 @@ RenameFilesDialog::RenameFilesDialog(QWidget *parent)
     // connect signals and slots
     connect(m_ui->generatePreviewPushButton, &QPushButton::clicked, this, &RenameFilesDialog::startGeneratingPreview);
     connect(m_ui->applyChangingsPushButton, &QPushButton::clicked, this, &RenameFilesDialog::startApplyChangings);
+    connect(m_ui->undoPushButton, &QPushButton::clicked, this, &RenameFilesDialog::startUndoChangings);
     connect(m_ui->abortClosePushButton, &QPushButton::clicked, this, &RenameFilesDialog::abortClose);
     connect(m_engine, &RenamingEngine::previewGenerated, this, &RenameFilesDialog::showPreviewResults);
     connect(m_engine, &RenamingEngine::changingsApplied, this, &RenameFilesDialog::showChangsingsResults);
+    connect(m_engine, &RenamingEngine::changingsUndone, this, &RenameFilesDialog::showUndoResults);
     connect(m_engine, &RenamingEngine::progress, this, &RenameFilesDialog::showPreviewProgress);
     connect(m_ui->currentTreeView, &QTreeView::customContextMenuRequested, this, &RenameFilesDialog::showTreeViewContextMenu);
     connect(m_ui->previewTreeView, &QTreeView::customContextMenuRequested, this, &RenameFilesDialog::showTreeViewContextMenu);
@@ -170,6 +174,7 @@ void RenameFilesDialog::startGeneratingPreview()
                 m_ui->abortClosePushButton->setText(tr("Abort"));
                 m_ui->generatePreviewPushButton->setHidden(true);
                 m_ui->applyChangingsPushButton->setHidden(true);
+                m_ui->undoPushButton->setHidden(true);
                 m_engine->generatePreview(directory(), m_ui->includeSubdirsCheckBox->isChecked());
             } else {
                 m_engine->clearPreview();
@@ -205,9 +210,28 @@ void RenameFilesDialog::startApplyChangings()
     m_ui->abortClosePushButton->setText(tr("Abort"));
     m_ui->generatePreviewPushButton->setHidden(true);
     m_ui->applyChangingsPushButton->setHidden(true);
+    m_ui->undoPushButton->setHidden(true);
     m_engine->applyChangings();
 }
 
+void RenameFilesDialog::startUndoChangings()
+{
+    if (m_engine->isBusy()) {
+        return;
+    }
+    if (QMessageBox::question(this, windowTitle(), tr("Do you really want to revert the most recently applied names?")) != QMessageBox::Yes) {
+        return;
+    }
+    m_ui->notificationLabel->setHidden(false);
+    m_ui->notificationLabel->setText(tr("Reverting changings ..."));
+    m_ui->notificationLabel->setNotificationType(NotificationType::Progress);
+    m_ui->abortClosePushButton->setText(tr("Abort"));
+    m_ui->generatePreviewPushButton->setHidden(true);
+    m_ui->applyChangingsPushButton->setHidden(true);
+    m_ui->undoPushButton->setHidden(true);
+    m_engine->undoChangings();
+}
+
 void RenameFilesDialog::showPreviewProgress(int itemsProcessed, int errorsOccured)
 {
     m_itemsProcessed = itemsProcessed;
@@ -225,6 +249,7 @@ void RenameFilesDialog::showPreviewResults()
     m_ui->abortClosePushButton->setText(tr("Close"));
     m_ui->generatePreviewPushButton->setHidden(false);
     m_ui->applyChangingsPushButton->setHidden(false);
+    m_ui->undoPushButton->setHidden(false);
     if (m_engine->rootItem()) {
         m_ui->notificationLabel->setText(tr("Preview has been generated."));
         m_ui->notificationLabel->appendLine(tr("%1 files/directories have been processed.", nullptr, m_itemsProcessed).arg(m_itemsProcessed));
@@ -250,6 +275,8 @@ void RenameFilesDialog::showChangsingsResults()
     m_ui->abortClosePushButton->setText(tr("Close"));
     m_ui->generatePreviewPushButton->setHidden(false);
     m_ui->applyChangingsPushButton->setHidden(false);
+    m_ui->undoPushButton->setHidden(false);
+    m_ui->undoPushButton->setEnabled(RenamingEngine::canUndo());
     m_ui->notificationLabel->setText(tr("Changins applied."));
     m_ui->notificationLabel->appendLine(tr("%1 files/directories have been processed.", nullptr, m_itemsProcessed).arg(m_itemsProcessed));
     m_ui->notificationLabel->setNotificationType(NotificationType::Information);
@@ -263,6 +290,28 @@ void RenameFilesDialog::showChangsingsResults()
     }
 }
 
+void RenameFilesDialog::showUndoResults()
+{
+    m_ui->abortClosePushButton->setText(tr("Close"));
+    m_ui->generatePreviewPushButton->setHidden(false);
+    m_ui->applyChangingsPushButton->setHidden(false);
+    m_ui->applyChangingsPushButton->setEnabled(false);
+    m_ui->undoPushButton->setHidden(false);
+    m_ui->undoPushButton->setEnabled(RenamingEngine::canUndo());
+    m_ui->notificationLabel->setText(tr("Changings reverted."));
+    m_ui->notificationLabel->appendLine(tr("%1 files/directories have been restored.", nullptr, m_itemsProcessed).arg(m_itemsProcessed));
+    m_ui->notificationLabel->setNotificationType(NotificationType::Information);
+    if (m_engine->isAborted()) {
+        m_ui->notificationLabel->appendLine(tr("Reverting has been aborted prematurely."));
+        m_ui->notificationLabel->setNotificationType(NotificationType::Warning);
+    }
+    if (m_errorsOccured) {
+        m_ui->notificationLabel->appendLine(tr("%1 error(s) occurred.", nullptr, m_errorsOccured).arg(m_errorsOccured));
+        m_ui->notificationLabel->appendLine(tr("The undo journal has been kept so reverting can be tried again."));
+        m_ui->notificationLabel->setNotificationType(NotificationType::Warning);
+    }
+}
+
 void RenameFilesDialog::currentItemSelected(const QItemSelection &, const QItemSelection &)
 {
     if (m_changingSelection) {
@@ -38,9 +38,11 @@ private Q_SLOTS:
     void showScriptFileSelectionDlg();
     void startGeneratingPreview();
     void startApplyChangings();
+    void startUndoChangings();
     void showPreviewProgress(int itemsProcessed, int errorsOccured);
     void showPreviewResults();
     void showChangsingsResults();
+    void showUndoResults();
     void currentItemSelected(const QItemSelection &selected, const QItemSelection &deselected);
     void previewItemSelected(const QItemSelection &selected, const QItemSelection &deselected);
     void pasteScriptFromFile(const QString &fileName);
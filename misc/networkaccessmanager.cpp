@@ -4,10 +4,27 @@
 
 namespace Utility {
 
+/// \brief The network access manager to be used by the current thread instead of the global one (if set).
+static thread_local QNetworkAccessManager *networkAccessManagerOfThread = nullptr;
+
 QNetworkAccessManager &networkAccessManager()
 {
+    if (networkAccessManagerOfThread) {
+        return *networkAccessManagerOfThread;
+    }
     static QNetworkAccessManager mgr;
     return mgr;
 }
 
+/*!
+ * \brief Makes networkAccessManager() return the specified \a manager when called from the current thread.
+ * \remarks
+ * - Needs to be used by threads other than the main thread as QObjects must only be used within their thread.
+ * - Pass nullptr to use the global network access manager again (e.g. before \a manager is destroyed).
+ */
+void setNetworkAccessManagerForCurrentThread(QNetworkAccessManager *manager)
+{
+    networkAccessManagerOfThread = manager;
+}
+
 } // namespace Utility
@@ -8,6 +8,7 @@ QT_FORWARD_DECLARE_CLASS(QNetworkAccessManager)
 namespace Utility {
 
 QNetworkAccessManager &networkAccessManager();
+void setNetworkAccessManagerForCurrentThread(QNetworkAccessManager *manager);
 }
 
 #endif // TAGEDITOR_NETWORKACCESSMANAGER_H
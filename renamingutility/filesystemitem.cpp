@@ -18,6 +18,7 @@ const QString &emptyStr()
 
 FileSystemItem::FileSystemItem(ItemStatus status, ItemType type, const QString &name, FileSystemItem *parent)
     : m_parent(parent)
+    , m_caseSensitivity(parent ? parent->m_caseSensitivity : Qt::CaseSensitive)
     , m_counterpart(nullptr)
     , m_status(status)
     , m_type(type)
@@ -28,7 +29,7 @@ FileSystemItem::FileSystemItem(ItemStatus status, ItemType type, const QString &
     , m_checkable(false)
 {
     if (m_parent) {
-        m_parent->m_children << this;
+        m_parent->addChild(this);
     }
 }
 
@@ -39,7 +40,7 @@ FileSystemItem::~FileSystemItem()
         delete child;
     }
     if (m_parent) {
-        m_parent->m_children.removeAll(this);
+        m_parent->removeChild(this);
     }
 }
 
@@ -49,14 +50,24 @@ void FileSystemItem::setParent(FileSystemItem *parent)
         return;
     }
     if (m_parent) {
-        m_parent->m_children.removeAll(this);
+        m_parent->removeChild(this);
     }
     m_parent = parent;
-    if (m_parent && !m_parent->m_children.contains(this)) {
-        m_parent->m_children << this;
+    if (m_parent) {
+        m_parent->addChild(this);
     }
 }
 
+void FileSystemItem::setName(const QString &name)
+{
+    if (m_parent) {
+        // keep the index of the parent up-to-date
+        m_parent->m_childrenByName.remove(m_parent->childKey(m_name), this);
+        m_parent->m_childrenByName.insert(m_parent->childKey(name), this);
+    }
+    m_name = name;
+}
+
 const QString &FileSystemItem::currentName() const
 {
     switch (m_status) {
@@ -118,24 +129,31 @@ bool FileSystemItem::setNewName(const QString &newName)
     return false;
 }
 
+/*!
+ * \brief Returns the child with the specified \a name or nullptr if there is no such child.
+ * \remarks
+ * - If there are multiple children with the specified \a name, the least recently added (or renamed) one is returned.
+ * - The lookup takes constant time (on average) as the children are indexed by name.
+ */
 FileSystemItem *FileSystemItem::findChild(const QString &name) const
 {
-    for (auto *const child : m_children) {
-        if (child->name() == name) {
-            return child;
-        }
-    }
-    return nullptr;
+    return findChild(name, nullptr);
 }
 
+/*!
+ * \brief Returns the child with the specified \a name which is not \a exclude or nullptr if there is no such child.
+ */
 FileSystemItem *FileSystemItem::findChild(const QString &name, const FileSystemItem *exclude) const
 {
-    for (auto *const child : m_children) {
-        if (child != exclude && child->name() == name) {
-            return child;
+    // note: Items with the same key are iterated from the most recently to the least recently inserted one.
+    const auto key = childKey(name);
+    FileSystemItem *found = nullptr;
+    for (auto i = m_childrenByName.constFind(key), end = m_childrenByName.cend(); i != end && i.key() == key; ++i) {
+        if (i.value() != exclude) {
+            found = i.value();
         }
     }
-    return nullptr;
+    return found;
 }
 
 FileSystemItem *FileSystemItem::makeChildAvailable(const QString &relativePath)
@@ -168,6 +186,25 @@ FileSystemItem *FileSystemItem::makeChildAvailable(const QString &relativePath)
     return parent;
 }
 
+/*!
+ * \brief Sets whether the names of the children (and the children of the children) are compared case-sensitively.
+ * \remarks Comparing case-insensitively is useful for file systems which do not distinguish names differing only in case.
+ *          Children created later inherit the setting.
+ */
+void FileSystemItem::setCaseSensitivity(Qt::CaseSensitivity caseSensitivity)
+{
+    if (m_caseSensitivity != caseSensitivity) {
+        m_caseSensitivity = caseSensitivity;
+        m_childrenByName.clear();
+        for (auto *const child : m_children) {
+            m_childrenByName.insert(childKey(child->name()), child);
+        }
+    }
+    for (auto *const child : m_children) {
+        child->setCaseSensitivity(caseSensitivity);
+    }
+}
+
 void FileSystemItem::relativeDir(QString &res) const
 {
     if (m_parent) {
@@ -201,21 +238,40 @@ QString FileSystemItem::relativePath() const
     return path;
 }
 
+/*!
+ * \brief Returns whether another item within the same directory has the specified \a name.
+ * \remarks Current and new items are considered so a current item which is renamed within the same directory counts with its
+ *          current and its new name.
+ */
 bool FileSystemItem::hasSibling(const QString &name) const
 {
-    if (!m_parent) {
-        return false;
-    }
-    const auto &siblings = m_parent->children();
-    for (const auto *const siblingItem : siblings) {
-        if (siblingItem == this) {
-            continue;
-        }
-        if ((!siblingItem->newName().isEmpty() && siblingItem->newName() == name) || siblingItem->name() == name) {
-            return true;
-        }
-    }
-    return false;
+    return m_parent && m_parent->findChild(name, this);
+}
+
+/*!
+ * \brief Returns the key the child with the specified \a name is indexed with.
+ */
+QString FileSystemItem::childKey(const QString &name) const
+{
+    return m_caseSensitivity == Qt::CaseInsensitive ? name.toCaseFolded() : name;
+}
+
+/*!
+ * \brief Adds the specified \a child to the list of children and the index.
+ */
+void FileSystemItem::addChild(FileSystemItem *child)
+{
+    m_children << child;
+    m_childrenByName.insert(childKey(child->name()), child);
+}
+
+/*!
+ * \brief Removes the specified \a child from the list of children and the index.
+ */
+void FileSystemItem::removeChild(FileSystemItem *child)
+{
+    m_children.removeAll(child);
+    m_childrenByName.remove(childKey(child->name()), child);
 }
 
 } // namespace RenamingUtility
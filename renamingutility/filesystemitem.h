@@ -4,6 +4,7 @@
 #include "../misc/utility.h"
 
 #include <QList>
+#include <QMultiHash>
 #include <QString>
 
 namespace RenamingUtility {
@@ -32,6 +33,8 @@ public:
     FileSystemItem *findChild(const QString &name) const;
     FileSystemItem *findChild(const QString &name, const FileSystemItem *exclude) const;
     FileSystemItem *makeChildAvailable(const QString &relativePath);
+    Qt::CaseSensitivity caseSensitivity() const;
+    void setCaseSensitivity(Qt::CaseSensitivity caseSensitivity);
     ItemStatus status() const;
     ItemType type() const;
     bool errorOccured() const;
@@ -58,8 +61,14 @@ public:
     bool hasSibling(const QString &name) const;
 
 private:
+    QString childKey(const QString &name) const;
+    void addChild(FileSystemItem *child);
+    void removeChild(FileSystemItem *child);
+
     FileSystemItem *m_parent;
     QList<FileSystemItem *> m_children;
+    QMultiHash<QString, FileSystemItem *> m_childrenByName;
+    Qt::CaseSensitivity m_caseSensitivity;
     FileSystemItem *m_counterpart;
     ItemStatus m_status;
     ItemType m_type;
@@ -102,6 +111,14 @@ inline void FileSystemItem::setCounterpart(FileSystemItem *counterpart)
     }
 }
 
+/*!
+ * \brief Returns whether the names of the children are compared case-sensitively.
+ */
+inline Qt::CaseSensitivity FileSystemItem::caseSensitivity() const
+{
+    return m_caseSensitivity;
+}
+
 inline ItemStatus FileSystemItem::status() const
 {
     return m_status;
@@ -145,11 +162,6 @@ inline const QString &FileSystemItem::name() const
     return m_name;
 }
 
-inline void FileSystemItem::setName(const QString &name)
-{
-    m_name = name;
-}
-
 inline const QString &FileSystemItem::note() const
 {
     if (m_note.isEmpty() && m_counterpart) {
@@ -0,0 +1,50 @@
+#include "./parseresultcache.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+namespace RenamingUtility {
+
+ParseResultCache::ParseResultCache(int maxEntries)
+    : m_entries(maxEntries)
+{
+}
+
+/*!
+ * \brief Returns the information for the file with the specified \a fileName invoking \a parse only if there is no
+ *        up-to-date entry.
+ * \remarks The file is not locked while being parsed so two threads might parse the same file at the same time. That is
+ *          not a problem as both would store the same information.
+ */
+QVariantMap ParseResultCache::get(const QString &fileName, bool tagsOnly, const std::function<QVariantMap()> &parse)
+{
+    const auto file = QFileInfo(fileName);
+    if (!file.isFile()) {
+        return parse(); // don't cache the information about files which can not be read anyways
+    }
+    const auto key = QString((tagsOnly ? QLatin1Char('t') : QLatin1Char('f')) + file.absoluteFilePath());
+    const auto lastModified = file.lastModified().toMSecsSinceEpoch();
+    const auto size = file.size();
+    {
+        QMutexLocker locker(&m_mutex);
+        if (const auto *const entry = m_entries.object(key); entry && entry->lastModified == lastModified && entry->size == size) {
+            return entry->fileInfo;
+        }
+    }
+    auto fileInfo = parse();
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(key, new Entry{ lastModified, size, fileInfo });
+    return fileInfo;
+}
+
+/*!
+ * \brief Drops all entries.
+ */
+void ParseResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+}
+
+} // namespace RenamingUtility
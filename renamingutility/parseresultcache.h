@@ -0,0 +1,45 @@
+#ifndef RENAMINGUTILITY_PARSERESULTCACHE_H
+#define RENAMINGUTILITY_PARSERESULTCACHE_H
+
+#include <QCache>
+#include <QMutex>
+#include <QString>
+#include <QVariantMap>
+
+#include <functional>
+
+namespace RenamingUtility {
+
+/*!
+ * \brief The ParseResultCache class keeps the information gathered by parsing files so it can be reused when generating
+ *        the preview again (e.g. after tweaking the script).
+ *
+ * Entries are keyed by the absolute path of the file and whether only the tags have been parsed. An entry is only used
+ * if the modification time and the size of the file are still the same. The number of entries is bounded; the least
+ * recently used entries are dropped first.
+ *
+ * \remarks
+ * - The information is stored as QVariantMap (and not as script value) so it can be shared between script engines.
+ * - get() may be invoked from multiple threads.
+ */
+class ParseResultCache {
+public:
+    explicit ParseResultCache(int maxEntries = 10000);
+
+    QVariantMap get(const QString &fileName, bool tagsOnly, const std::function<QVariantMap()> &parse);
+    void clear();
+
+private:
+    struct Entry {
+        qint64 lastModified;
+        qint64 size;
+        QVariantMap fileInfo;
+    };
+
+    QCache<QString, Entry> m_entries;
+    QMutex m_mutex;
+};
+
+} // namespace RenamingUtility
+
+#endif // RENAMINGUTILITY_PARSERESULTCACHE_H
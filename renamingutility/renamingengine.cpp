@@ -4,14 +4,214 @@
 #include "./tageditorobject.h"
 
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QStringBuilder>
+#include <QWaitCondition>
+#include <QtConcurrent/QtConcurrentMap>
 
+#include <algorithm>
+#include <deque>
 #include <memory>
+#include <vector>
 
 using namespace std;
 
 namespace RenamingUtility {
 
+/*!
+ * \brief The RenamingOperation struct describes renaming (or moving) an item or creating a directory.
+ */
+struct RenamingOperation {
+    FileSystemItem *item = nullptr;
+    QString currentPath; ///< empty if a directory is supposed to be created
+    QString newPath;
+};
+
+#ifndef TAGEDITOR_NO_JSENGINE
+/*!
+ * \brief The PreviewTask struct holds the information the script is executed with for an item and the outcome of the execution.
+ */
+struct PreviewTask {
+    QFileInfo fileInfo;
+    QString relativeDirectory;
+    ItemType type = ItemType::File;
+    FileSystemItem *item = nullptr;
+    ActionType action = ActionType::None;
+    QString newName;
+    QString newRelativeDirectory;
+    QString note;
+    bool failed = false;
+    bool done = false;
+};
+
+/*!
+ * \brief The PreviewQueue class passes PreviewTask objects from the PreviewGenerator to the PreviewWorker threads and back.
+ * \remarks Tasks are never removed while the preview is generated so pointers to them remain valid.
+ */
+class PreviewQueue {
+public:
+    void add(PreviewTask &&task);
+    void finishAdding();
+    void stop();
+    PreviewTask *take();
+    void markDone(PreviewTask *task);
+    PreviewTask *waitForResult(std::size_t index, RenamingEngine &engine);
+
+private:
+    std::deque<PreviewTask> m_tasks;
+    std::size_t m_nextTask = 0;
+    bool m_complete = false;
+    bool m_stopped = false;
+    QMutex m_mutex;
+    QWaitCondition m_taskAvailable;
+    QWaitCondition m_resultAvailable;
+};
+
+/*!
+ * \brief Adds the specified \a task letting an idle worker know about it.
+ */
+void PreviewQueue::add(PreviewTask &&task)
+{
+    QMutexLocker locker(&m_mutex);
+    m_tasks.emplace_back(std::move(task));
+    m_taskAvailable.wakeOne();
+}
+
+/*!
+ * \brief Indicates that no further tasks will be added.
+ */
+void PreviewQueue::finishAdding()
+{
+    QMutexLocker locker(&m_mutex);
+    m_complete = true;
+    m_taskAvailable.wakeAll();
+    m_resultAvailable.wakeAll();
+}
+
+/*!
+ * \brief Lets the workers stop after their current task.
+ */
+void PreviewQueue::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stopped = true;
+    m_taskAvailable.wakeAll();
+    m_resultAvailable.wakeAll();
+}
+
+/*!
+ * \brief Returns the next task to be executed by the calling worker or nullptr if there are no further tasks.
+ */
+PreviewTask *PreviewQueue::take()
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopped && !m_complete && m_nextTask == m_tasks.size()) {
+        m_taskAvailable.wait(&m_mutex);
+    }
+    return m_stopped || m_nextTask == m_tasks.size() ? nullptr : &m_tasks[m_nextTask++];
+}
+
+/*!
+ * \brief Marks the specified \a task as done.
+ */
+void PreviewQueue::markDone(PreviewTask *task)
+{
+    QMutexLocker locker(&m_mutex);
+    task->done = true;
+    m_resultAvailable.wakeAll();
+}
+
+/*!
+ * \brief Returns the task with the specified \a index once it is done.
+ * \remarks Returns nullptr if there is no such task or if the \a engine has been aborted.
+ */
+PreviewTask *PreviewQueue::waitForResult(std::size_t index, RenamingEngine &engine)
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        if (m_stopped || engine.isAborted()) {
+            return nullptr;
+        }
+        if (index < m_tasks.size()) {
+            if (m_tasks[index].done) {
+                return &m_tasks[index];
+            }
+        } else if (m_complete) {
+            return nullptr;
+        }
+        // wake up periodically to check whether the engine has been aborted
+        m_resultAvailable.wait(&m_mutex, 100);
+    }
+}
+
+/*!
+ * \brief The PreviewWorker class executes the script for the tasks of a PreviewQueue.
+ * \remarks Each worker uses its own script engine as an engine must only be used by the thread it belongs to.
+ */
+class PreviewWorker final : public QThread {
+public:
+    explicit PreviewWorker(RenamingEngine *engine, PreviewQueue *queue, const QString &programSource, ParseResultCache *parseResultCache);
+
+protected:
+    void run() final;
+
+private:
+    RenamingEngine *m_engine;
+    PreviewQueue *m_queue;
+    QString m_programSource;
+    ParseResultCache *m_parseResultCache;
+};
+
+PreviewWorker::PreviewWorker(RenamingEngine *engine, PreviewQueue *queue, const QString &programSource, ParseResultCache *parseResultCache)
+    : m_engine(engine)
+    , m_queue(queue)
+    , m_programSource(programSource)
+    , m_parseResultCache(parseResultCache)
+{
+}
+
+void PreviewWorker::run()
+{
+    auto engine = TAGEDITOR_JS_ENGINE();
+    auto *const tagEditorQObj = new TagEditorObject(&engine, m_parseResultCache); // will be deleted by the engine
+    engine.globalObject().setProperty(QStringLiteral("tageditor"), TAGEDITOR_JS_QOBJECT(engine, tagEditorQObj));
+    const auto program = engine.evaluate(m_programSource);
+    while (auto *const task = m_queue->take()) {
+        if (!TAGEDITOR_JS_IS_VALID_PROG(program)) {
+            task->failed = true;
+            task->note = program.toString();
+        } else {
+            // make file info for the item available in the script and execute it
+            tagEditorQObj->setFileInfo(task->fileInfo, task->type, task->relativeDirectory);
+            const auto scriptResult = program.call();
+            if (scriptResult.isError()) {
+                task->failed = true;
+                task->note = scriptResult.toString();
+            } else {
+                task->action = tagEditorQObj->action();
+                task->newName = tagEditorQObj->newName();
+                task->newRelativeDirectory = tagEditorQObj->newRelativeDirectory();
+                task->note = tagEditorQObj->note();
+            }
+        }
+        m_queue->markDone(task);
+        if (m_engine->isAborted()) {
+            m_queue->stop();
+            return;
+        }
+    }
+}
+#endif
+
 RenamingEngine::RenamingEngine(QObject *parent)
     : QObject(parent)
     ,
@@ -34,6 +234,7 @@ RenamingEngine::RenamingEngine(QObject *parent)
 #endif
     connect(this, &RenamingEngine::previewGenerated, this, &RenamingEngine::processPreviewGenerated);
     connect(this, &RenamingEngine::changingsApplied, this, &RenamingEngine::processChangingsApplied);
+    connect(this, &RenamingEngine::changingsUndone, this, &RenamingEngine::processChangingsUndone);
 }
 
 RenamingEngine::~RenamingEngine()
@@ -63,6 +264,7 @@ bool RenamingEngine::setProgram(const TAGEDITOR_JS_VALUE &program)
     m_errorMessage.clear();
     m_errorLineNumber = 0;
     m_program = program;
+    m_programSource = QStringLiteral("(") % program.toString() % QStringLiteral(")");
     return true;
 }
 #endif
@@ -70,7 +272,13 @@ bool RenamingEngine::setProgram(const TAGEDITOR_JS_VALUE &program)
 bool RenamingEngine::setProgram(const QString &program)
 {
 #ifndef TAGEDITOR_NO_JSENGINE
-    return setProgram(m_engine.evaluate(QStringLiteral("(function(){") % program % QStringLiteral("})")));
+    // keep the source as well because the preview is generated using one engine per thread
+    const auto programSource = QString(QStringLiteral("(function(){") % program % QStringLiteral("})"));
+    if (!setProgram(m_engine.evaluate(programSource))) {
+        return false;
+    }
+    m_programSource = programSource;
+    return true;
 #else
     Q_UNUSED(program)
     m_errorLineNumber = 0;
@@ -109,6 +317,40 @@ bool RenamingEngine::applyChangings()
     return m_isBusy = true;
 }
 
+/*!
+ * \brief Reverts the changings applied most recently using the undo journal.
+ * \remarks
+ * - Also reverts the changings of a run which has been aborted or has failed partially. Operations which have not been applied
+ *   are skipped.
+ * - The preview is cleared when done as it does not reflect the state of the file system anymore.
+ */
+bool RenamingEngine::undoChangings()
+{
+    if (m_isBusy || !canUndo()) {
+        return false;
+    }
+#ifndef TAGEDITOR_NO_JSENGINE
+    (new RenamingThing(this, true))->start();
+#endif
+    return m_isBusy = true;
+}
+
+/*!
+ * \brief Returns the path of the undo journal.
+ */
+QString RenamingEngine::journalPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/renaming-journal.json");
+}
+
+/*!
+ * \brief Returns whether there is an undo journal for changings which can be reverted via undoChangings().
+ */
+bool RenamingEngine::canUndo()
+{
+    return QFile::exists(journalPath());
+}
+
 bool RenamingEngine::clearPreview()
 {
     if (m_isBusy) {
@@ -155,10 +397,24 @@ void RenamingEngine::processPreviewGenerated()
 void RenamingEngine::processChangingsApplied()
 {
     finalizeTaskCompletion();
+#ifndef TAGEDITOR_NO_JSENGINE
+    // drop the parse results as files have been renamed
+    m_parseResultCache.clear();
+#endif
     updateModel(nullptr);
     updateModel(m_rootItem.get());
 }
 
+void RenamingEngine::processChangingsUndone()
+{
+    finalizeTaskCompletion();
+#ifndef TAGEDITOR_NO_JSENGINE
+    m_parseResultCache.clear();
+#endif
+    updateModel(nullptr);
+    m_rootItem.reset();
+}
+
 void RenamingEngine::resetStatus()
 {
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
@@ -192,9 +448,33 @@ void RenamingEngine::updateModel(FileSystemItem *rootItem)
 }
 
 #ifndef TAGEDITOR_NO_JSENGINE
-unique_ptr<FileSystemItem> RenamingEngine::generatePreview(const QDir &dir, FileSystemItem *parent)
+/*!
+ * \brief Returns whether the file system is assumed to distinguish names which differ only in case.
+ * \remarks The file systems commonly used under Windows and macOS (NTFS, APFS and HFS+) do not by default.
+ */
+static constexpr Qt::CaseSensitivity fileSystemCaseSensitivity()
+{
+#if defined(Q_OS_WINDOWS) || defined(Q_OS_MAC)
+    return Qt::CaseInsensitive;
+#else
+    return Qt::CaseSensitive;
+#endif
+}
+
+/*!
+ * \brief Creates the items for the entries of the specified \a dir and adds a task for executing the script for each of them
+ *        to the specified \a queue.
+ * \remarks
+ * - Tasks for the entries of a sub directory are added before the task for the sub directory itself.
+ * - The names of the items are compared case-insensitively when checking for conflicts if the file system is assumed to
+ *   be case-insensitive (see fileSystemCaseSensitivity()).
+ */
+unique_ptr<FileSystemItem> RenamingEngine::generatePreview(const QDir &dir, PreviewQueue &queue, FileSystemItem *parent)
 {
     auto item = make_unique<FileSystemItem>(ItemStatus::Current, ItemType::Dir, dir.dirName(), parent);
+    if (!parent) {
+        item->setCaseSensitivity(fileSystemCaseSensitivity());
+    }
     item->setApplied(false);
     for (const QFileInfo &entry : dir.entryInfoList()) {
         if (entry.fileName() == QLatin1String("..") || entry.fileName() == QLatin1String(".")) {
@@ -202,100 +482,282 @@ unique_ptr<FileSystemItem> RenamingEngine::generatePreview(const QDir &dir, File
         }
         FileSystemItem *subItem; // will be deleted by parent
         if (entry.isDir() && m_includeSubdirs) {
-            subItem = generatePreview(QDir(entry.absoluteFilePath()), item.get()).release();
+            subItem = generatePreview(QDir(entry.absoluteFilePath()), queue, item.get()).release();
         } else if (entry.isFile()) {
             subItem = new FileSystemItem(ItemStatus::Current, ItemType::File, entry.fileName(), item.get());
             subItem->setApplied(false);
         } else {
             subItem = nullptr;
+            ++m_itemsProcessed;
         }
         if (subItem) {
-            executeScriptForItem(entry, subItem);
-            if (subItem->errorOccured()) {
-                ++m_errorsOccured;
-            }
+            auto task = PreviewTask();
+            task.fileInfo = entry;
+            task.relativeDirectory = subItem->relativeDir();
+            task.type = subItem->type();
+            task.item = subItem;
+            queue.add(std::move(task));
         }
-        ++m_itemsProcessed;
         if (isAborted()) {
             return item;
         }
     }
-    emit progress(m_itemsProcessed, m_errorsOccured);
     return item;
 }
+
+/*!
+ * \brief Applies the results of the tasks of the specified \a queue in the order the tasks have been added.
+ * \remarks Applying the results in order keeps the detection of conflicts deterministic, no matter which worker has finished first.
+ */
+void RenamingEngine::applyScriptResults(PreviewQueue &queue)
+{
+    for (auto index = std::size_t(); const auto *const task = queue.waitForResult(index, *this); ++index) {
+        applyScriptResult(*task);
+        if (task->item->errorOccured()) {
+            ++m_errorsOccured;
+        }
+        if (!(++m_itemsProcessed % 64)) {
+            emit progress(m_itemsProcessed, m_errorsOccured);
+        }
+    }
+    emit progress(m_itemsProcessed, m_errorsOccured);
+}
 #endif
 
-void RenamingEngine::applyChangings(FileSystemItem *parentItem)
+/*!
+ * \brief Determines the operations required to apply the changings for the children of \a parentItem (recursively).
+ * \remarks The operations are added in the order they need to be executed, e.g. the contents of a directory are renamed
+ *          before the directory itself and a new directory is created before anything is moved into it.
+ */
+void RenamingEngine::planChangings(FileSystemItem *parentItem, std::vector<RenamingOperation> &operations)
 {
     for (auto *const item : parentItem->children()) {
-        if (!item->applied() && !item->errorOccured()) {
-            switch (item->status()) {
-            case ItemStatus::New: {
-                const FileSystemItem *counterpartItem = item->counterpart(); // holds current name
-                const QString currentPath = counterpartItem ? counterpartItem->relativePath() : QString();
-                const QString newPath = item->relativePath();
-                if (item->name().isEmpty()) {
-                    // new item name mustn't be empty
-                    item->setNote(tr("generated name is empty"));
-                    item->setErrorOccured(true);
-                } else if (counterpartItem && !counterpartItem->name().isEmpty()) {
-                    // rename current item
-                    if (item->parent() != counterpartItem->parent() || item->name() != counterpartItem->name()) {
-                        if (m_dir.exists(newPath)) {
-                            if (item->parent() == counterpartItem->parent()) {
-                                item->setNote(tr("unable to rename, there is already an entry with the same name"));
-                            } else {
-                                item->setNote(tr("unable to move, there is already an entry with the same name"));
-                            }
-                            item->setErrorOccured(true);
-                        } else if (m_dir.rename(currentPath, newPath)) {
-                            if (item->parent() == counterpartItem->parent()) {
-                                item->setNote(tr("renamed"));
-                            } else {
-                                item->setNote(tr("moved"));
-                            }
-                            item->setApplied(true);
-                        } else {
-                            item->setNote(tr("unable to rename"));
-                            item->setErrorOccured(true);
-                        }
-                    } else {
-                        item->setNote(tr("nothing to be changed"));
-                        item->setApplied(true);
-                    }
-                } else if (item->type() == ItemType::Dir) {
-                    // create new item, but only if its a dir
-                    if (m_dir.exists(newPath)) {
-                        item->setNote(tr("directory already existed"));
-                        item->setApplied(true);
-                    } else if (m_dir.mkpath(newPath)) {
-                        item->setNote(tr("directory created"));
-                        item->setApplied(true);
-                    } else {
-                        item->setNote(tr("unable to create directory"));
-                        item->setErrorOccured(true);
-                    }
+        if (!item->applied() && !item->errorOccured() && item->status() == ItemStatus::New) {
+            const FileSystemItem *counterpartItem = item->counterpart(); // holds current name
+            if (item->name().isEmpty()) {
+                // new item name mustn't be empty
+                item->setNote(tr("generated name is empty"));
+                item->setErrorOccured(true);
+            } else if (counterpartItem && !counterpartItem->name().isEmpty()) {
+                // rename current item
+                if (item->parent() != counterpartItem->parent() || item->name() != counterpartItem->name()) {
+                    operations.emplace_back(RenamingOperation{ item, counterpartItem->relativePath(), item->relativePath() });
                 } else {
-                    // can not create new file
-                    item->setNote(tr("unable to create file"));
-                    item->setErrorOccured(true);
+                    item->setNote(tr("nothing to be changed"));
+                    item->setApplied(true);
                 }
-                break;
+            } else if (item->type() == ItemType::Dir) {
+                // create new item, but only if its a dir
+                operations.emplace_back(RenamingOperation{ item, QString(), item->relativePath() });
+            } else {
+                // can not create new file
+                item->setNote(tr("unable to create file"));
+                item->setErrorOccured(true);
             }
-            case ItemStatus::Current:
-                break;
+        }
+        // plan changings for child items as well
+        if (item->type() == ItemType::Dir) {
+            planChangings(item, operations);
+        }
+    }
+}
+
+/*!
+ * \brief Applies the changings of the current preview.
+ *
+ * The operations are planned upfront and written to the undo journal before anything is changed. Operations on directories
+ * are executed one after another in the planned order. The operations on files in between are grouped by their target
+ * directory and the groups are executed concurrently as they do not depend on each other (conflicting names have already
+ * been ruled out when generating the preview).
+ */
+void RenamingEngine::executeChangings()
+{
+    auto operations = std::vector<RenamingOperation>();
+    planChangings(m_rootItem.get(), operations);
+    if (!writeJournal(operations)) {
+        for (auto &operation : operations) {
+            operation.item->setNote(tr("not applied, unable to write undo journal"));
+            operation.item->setErrorOccured(true);
+        }
+        countResults(m_rootItem.get());
+        emit progress(m_itemsProcessed, m_errorsOccured);
+        return;
+    }
+
+    const auto rootPath = m_dir.absolutePath();
+    const auto dir = QDir(rootPath);
+    auto operationsExecuted = 0;
+    for (auto i = operations.begin(), end = operations.end(); i != end && !isAborted();) {
+        if (i->item->type() == ItemType::Dir) {
+            executeOperation(*i, dir);
+            ++i;
+            ++operationsExecuted;
+            continue;
+        }
+
+        // group the operations on files up to the next operation on a directory by their target directory
+        auto batches = std::vector<std::vector<RenamingOperation *>>();
+        auto batchIndexByTargetDir = QHash<const FileSystemItem *, std::size_t>();
+        for (; i != end && i->item->type() != ItemType::Dir; ++i, ++operationsExecuted) {
+            const auto *const targetDir = i->item->parent();
+            auto batchIndex = batchIndexByTargetDir.find(targetDir);
+            if (batchIndex == batchIndexByTargetDir.end()) {
+                batchIndex = batchIndexByTargetDir.insert(targetDir, batches.size());
+                batches.emplace_back();
             }
+            batches[batchIndex.value()].emplace_back(&*i);
         }
+        QtConcurrent::blockingMap(batches, [this, &rootPath](const std::vector<RenamingOperation *> &batch) {
+            const auto batchDir = QDir(rootPath); // QDir must not be used by multiple threads at the same time
+            for (auto *const operation : batch) {
+                if (isAborted()) {
+                    return;
+                }
+                executeOperation(*operation, batchDir);
+            }
+        });
+        emit progress(operationsExecuted, m_errorsOccured);
+    }
+    countResults(m_rootItem.get());
+    emit progress(m_itemsProcessed, m_errorsOccured);
+}
+
+/*!
+ * \brief Executes the specified \a operation relative to the specified \a dir.
+ * \remarks Only alters the item of the \a operation so operations on different items can be executed concurrently.
+ */
+void RenamingEngine::executeOperation(RenamingOperation &operation, const QDir &dir)
+{
+    auto *const item = operation.item;
+    if (!operation.currentPath.isEmpty()) {
+        const auto moved = item->parent() != item->counterpart()->parent();
+        if (dir.exists(operation.newPath)) {
+            if (!moved) {
+                item->setNote(tr("unable to rename, there is already an entry with the same name"));
+            } else {
+                item->setNote(tr("unable to move, there is already an entry with the same name"));
+            }
+            item->setErrorOccured(true);
+        } else if (dir.rename(operation.currentPath, operation.newPath)) {
+            if (!moved) {
+                item->setNote(tr("renamed"));
+            } else {
+                item->setNote(tr("moved"));
+            }
+            item->setApplied(true);
+        } else {
+            item->setNote(tr("unable to rename"));
+            item->setErrorOccured(true);
+        }
+    } else if (dir.exists(operation.newPath)) {
+        item->setNote(tr("directory already existed"));
+        item->setApplied(true);
+    } else if (dir.mkpath(operation.newPath)) {
+        item->setNote(tr("directory created"));
+        item->setApplied(true);
+    } else {
+        item->setNote(tr("unable to create directory"));
+        item->setErrorOccured(true);
+    }
+}
+
+/*!
+ * \brief Writes the undo journal for the specified \a operations.
+ * \remarks Directories which exist already are not recorded as they must not be removed when undoing.
+ */
+bool RenamingEngine::writeJournal(const std::vector<RenamingOperation> &operations) const
+{
+    auto operationsArray = QJsonArray();
+    for (const auto &operation : operations) {
+        auto operationObject = QJsonObject();
+        if (!operation.currentPath.isEmpty()) {
+            operationObject.insert(QStringLiteral("from"), operation.currentPath);
+        } else if (m_dir.exists(operation.newPath)) {
+            continue;
+        }
+        operationObject.insert(QStringLiteral("to"), operation.newPath);
+        operationsArray.append(operationObject);
+    }
+    auto journal = QJsonObject();
+    journal.insert(QStringLiteral("directory"), m_dir.absolutePath());
+    journal.insert(QStringLiteral("operations"), operationsArray);
+
+    const auto path = journalPath();
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return false;
+    }
+    auto file = QSaveFile(path);
+    return file.open(QIODevice::WriteOnly) && file.write(QJsonDocument(journal).toJson(QJsonDocument::Compact)) >= 0 && file.commit();
+}
+
+/*!
+ * \brief Reverts the operations recorded in the undo journal in reverse order.
+ * \remarks The journal is removed if all operations could be reverted (or have not been applied in the first place).
+ */
+void RenamingEngine::revertChangings()
+{
+    auto file = QFile(journalPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        ++m_errorsOccured;
+        emit progress(m_itemsProcessed, m_errorsOccured);
+        return;
+    }
+    const auto journal = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+    const auto directory = journal.value(QStringLiteral("directory")).toString();
+    const auto operations = journal.value(QStringLiteral("operations")).toArray();
+    const auto dir = QDir(directory);
+    if (directory.isEmpty() || !dir.exists()) {
+        ++m_errorsOccured;
+        emit progress(m_itemsProcessed, m_errorsOccured);
+        return;
+    }
+    for (auto i = operations.size(); i > 0 && !isAborted(); --i) {
+        const auto operation = operations.at(i - 1).toObject();
+        const auto from = operation.value(QStringLiteral("from")).toString();
+        const auto to = operation.value(QStringLiteral("to")).toString();
+        if (to.isEmpty()) {
+            continue;
+        }
+        if (from.isEmpty()) {
+            // remove created directory (only succeeds if it is still empty)
+            if (dir.exists(to) && !dir.rmdir(to)) {
+                ++m_errorsOccured;
+            } else {
+                ++m_itemsProcessed;
+            }
+        } else if (dir.exists(to) && !dir.exists(from)) {
+            // rename/move back (skipping operations which have not been applied)
+            if (dir.rename(to, from)) {
+                ++m_itemsProcessed;
+            } else {
+                ++m_errorsOccured;
+            }
+        }
+        if (!(i % 64)) {
+            emit progress(m_itemsProcessed, m_errorsOccured);
+        }
+    }
+    if (!m_errorsOccured && !isAborted()) {
+        QFile::remove(journalPath());
+    }
+    emit progress(m_itemsProcessed, m_errorsOccured);
+}
+
+/*!
+ * \brief Counts the processed items and the items an error occurred for (recursively).
+ */
+void RenamingEngine::countResults(FileSystemItem *parentItem)
+{
+    for (auto *const item : parentItem->children()) {
         if (item->errorOccured()) {
             ++m_errorsOccured;
         }
-        // apply changings for child items as well
         if (item->type() == ItemType::Dir) {
-            applyChangings(item);
+            countResults(item);
         }
     }
     m_itemsProcessed += Utility::containerSizeToInt(parentItem->children().size());
-    emit progress(m_itemsProcessed, m_errorsOccured);
 }
 
 void RenamingEngine::setError(const QList<FileSystemItem *> items)
@@ -307,24 +769,20 @@ void RenamingEngine::setError(const QList<FileSystemItem *> items)
 }
 
 #ifndef TAGEDITOR_NO_JSENGINE
-void RenamingEngine::executeScriptForItem(const QFileInfo &fileInfo, FileSystemItem *item)
+void RenamingEngine::applyScriptResult(const PreviewTask &task)
 {
-    // make file info for the specified item available in the script
-    m_tagEditorQObj->setFileInfo(fileInfo, item);
-
-    // execute script
-    const auto scriptResult(m_program.call());
-    if (scriptResult.isError()) {
+    auto *const item = task.item;
+    if (task.failed) {
         // handle error
         item->setErrorOccured(true);
-        item->setNote(scriptResult.toString());
+        item->setNote(task.note);
         return;
     }
 
     // create preview for action
-    const QString &newName = m_tagEditorQObj->newName();
-    const QString &newRelativeDirectory = m_tagEditorQObj->newRelativeDirectory();
-    switch (m_tagEditorQObj->action()) {
+    const QString &newName = task.newName;
+    const QString &newRelativeDirectory = task.newRelativeDirectory;
+    switch (task.action) {
     case ActionType::None:
         item->setNote(tr("no action specified"));
         break;
@@ -368,7 +826,7 @@ void RenamingEngine::executeScriptForItem(const QFileInfo &fileInfo, FileSystemI
         }
         break;
     default:
-        item->setNote(m_tagEditorQObj->note().isEmpty() ? tr("skipped") : m_tagEditorQObj->note());
+        item->setNote(task.note.isEmpty() ? tr("skipped") : task.note);
     }
 }
 
@@ -376,7 +834,6 @@ PreviewGenerator::PreviewGenerator(RenamingEngine *engine)
     : QThread(engine)
     , m_engine(engine)
 {
-    m_engine->m_engine.moveToThread(this);
     connect(this, &PreviewGenerator::finished, m_engine, &RenamingEngine::previewGenerated, Qt::QueuedConnection);
     connect(this, &PreviewGenerator::finished, this, &PreviewGenerator::deleteLater);
 }
@@ -384,22 +841,46 @@ PreviewGenerator::PreviewGenerator(RenamingEngine *engine)
 void PreviewGenerator::run()
 {
     m_engine->resetStatus();
-    m_engine->m_newlyGeneratedRootItem = m_engine->generatePreview(m_engine->m_dir);
+
+    // execute the script in parallel while walking through the directory tree
+    auto queue = PreviewQueue();
+    auto workers = std::vector<std::unique_ptr<PreviewWorker>>();
+    const auto workerCount = std::max(QThread::idealThreadCount(), 1);
+    workers.reserve(static_cast<std::size_t>(workerCount));
+    for (auto i = 0; i != workerCount; ++i) {
+        workers.emplace_back(std::make_unique<PreviewWorker>(m_engine, &queue, m_engine->m_programSource, &m_engine->m_parseResultCache))
+            ->start();
+    }
+    m_engine->m_newlyGeneratedRootItem = m_engine->generatePreview(m_engine->m_dir, queue);
+    queue.finishAdding();
+
+    // apply the results in order to build the preview
+    m_engine->applyScriptResults(queue);
+    queue.stop();
+    for (auto &worker : workers) {
+        worker->wait();
+    }
 }
 
-RenamingThing::RenamingThing(RenamingEngine *engine)
+RenamingThing::RenamingThing(RenamingEngine *engine, bool undo)
     : QThread(engine)
     , m_engine(engine)
+    , m_undo(undo)
 {
     m_engine->m_engine.moveToThread(this);
-    connect(this, &RenamingThing::finished, m_engine, &RenamingEngine::changingsApplied, Qt::QueuedConnection);
+    connect(this, &RenamingThing::finished, m_engine, undo ? &RenamingEngine::changingsUndone : &RenamingEngine::changingsApplied,
+        Qt::QueuedConnection);
     connect(this, &RenamingThing::finished, this, &RenamingThing::deleteLater);
 }
 
 void RenamingThing::run()
 {
     m_engine->resetStatus();
-    m_engine->applyChangings(m_engine->m_rootItem.get());
+    if (m_undo) {
+        m_engine->revertChangings();
+    } else {
+        m_engine->executeChangings();
+    }
 }
 
 #endif
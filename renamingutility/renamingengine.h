@@ -4,6 +4,7 @@
 #include "./filesystemitem.h"
 #include "./jsdefs.h"
 #include "./jsincludes.h"
+#include "./parseresultcache.h"
 
 #include <QAtomicInteger>
 #include <QDir>
@@ -12,6 +13,7 @@
 #include <QThread>
 
 #include <memory>
+#include <vector>
 
 QT_FORWARD_DECLARE_CLASS(QFileInfo)
 
@@ -21,6 +23,11 @@ class FileSystemItemModel;
 class FilteredFileSystemItemModel;
 class TagEditorObject;
 class RenamingEngine;
+struct RenamingOperation;
+#ifndef TAGEDITOR_NO_JSENGINE
+struct PreviewTask;
+class PreviewQueue;
+#endif
 
 #ifndef TAGEDITOR_NO_JSENGINE
 class PreviewGenerator final : public QThread {
@@ -38,13 +45,14 @@ private:
 class RenamingThing final : public QThread {
     Q_OBJECT
 public:
-    explicit RenamingThing(RenamingEngine *engine);
+    explicit RenamingThing(RenamingEngine *engine, bool undo = false);
 
 protected:
     void run() final;
 
 private:
     RenamingEngine *m_engine;
+    bool m_undo;
 };
 #endif
 
@@ -74,20 +82,25 @@ public:
     FilteredFileSystemItemModel *previewModel();
     const QString &errorMessage() const;
     int errorLineNumber() const;
+    static QString journalPath();
+    static bool canUndo();
 
 public Q_SLOTS:
     bool generatePreview(const QDir &rootDirectory, bool includeSubdirs);
     bool applyChangings();
+    bool undoChangings();
     void abort();
 
 Q_SIGNALS:
     void previewGenerated();
     void changingsApplied();
+    void changingsUndone();
     void progress(int itemsProcessed, int errorsOccured);
 
 private Q_SLOTS:
     void processPreviewGenerated();
     void processChangingsApplied();
+    void processChangingsUndone();
 
 private:
     void resetStatus();
@@ -95,12 +108,18 @@ private:
     void setRootItem(std::unique_ptr<FileSystemItem> &&rootItem = std::unique_ptr<FileSystemItem>());
     void updateModel(FileSystemItem *rootItem);
 #ifndef TAGEDITOR_NO_JSENGINE
-    std::unique_ptr<FileSystemItem> generatePreview(const QDir &dir, FileSystemItem *parent = nullptr);
+    std::unique_ptr<FileSystemItem> generatePreview(const QDir &dir, PreviewQueue &queue, FileSystemItem *parent = nullptr);
+    void applyScriptResults(PreviewQueue &queue);
 #endif
-    void applyChangings(FileSystemItem *parentItem);
+    void planChangings(FileSystemItem *parentItem, std::vector<RenamingOperation> &operations);
+    void executeChangings();
+    static void executeOperation(RenamingOperation &operation, const QDir &dir);
+    bool writeJournal(const std::vector<RenamingOperation> &operations) const;
+    void revertChangings();
+    void countResults(FileSystemItem *parentItem);
     static void setError(const QList<FileSystemItem *> items);
 #ifndef TAGEDITOR_NO_JSENGINE
-    void executeScriptForItem(const QFileInfo &fileInfo, FileSystemItem *item);
+    void applyScriptResult(const PreviewTask &task);
 #endif
 
 #ifndef TAGEDITOR_NO_JSENGINE
@@ -115,6 +134,8 @@ private:
     QAtomicInteger<unsigned char> m_aborted;
 #ifndef TAGEDITOR_NO_JSENGINE
     TAGEDITOR_JS_VALUE m_program;
+    QString m_programSource;
+    ParseResultCache m_parseResultCache;
 #endif
     QDir m_dir;
     bool m_includeSubdirs;
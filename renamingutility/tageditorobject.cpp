@@ -3,6 +3,7 @@
 #include "./tageditorobject.h"
 #include "./filesystemitem.h"
 #include "./jsincludes.h"
+#include "./parseresultcache.h"
 
 #include "../cli/fieldmapping.h"
 #include "../misc/utility.h"
@@ -31,22 +32,21 @@ using namespace Utility;
 
 namespace RenamingUtility {
 
-/// \brief Adds notifications from \a statusProvider to \a notificationsObject.
-TAGEDITOR_JS_VALUE &operator<<(TAGEDITOR_JS_VALUE &diagObject, const Diagnostics &diag)
+/// \brief Adds notifications from \a diag to \a diagList.
+QVariantList &operator<<(QVariantList &diagList, const Diagnostics &diag)
 {
-    quint32 counter = 0;
+    diagList.reserve(static_cast<decltype(diagList.size())>(diag.size()));
     for (const auto &msg : diag) {
-        TAGEDITOR_JS_VALUE val;
-        val.setProperty("msg", QString::fromUtf8(msg.message().data()) TAGEDITOR_JS_READONLY);
-        val.setProperty("critical", msg.level() >= DiagLevel::Critical TAGEDITOR_JS_READONLY);
-        diagObject.setProperty(counter, val);
-        ++counter;
+        auto val = QVariantMap();
+        val.insert(QStringLiteral("msg"), QString::fromUtf8(msg.message().data()));
+        val.insert(QStringLiteral("critical"), msg.level() >= DiagLevel::Critical);
+        diagList << val;
     }
-    return diagObject;
+    return diagList;
 }
 
-/// \brief Add fields and notifications from \a tag to \a tagObject.
-TAGEDITOR_JS_VALUE &operator<<(TAGEDITOR_JS_VALUE &tagObject, const Tag &tag)
+/// \brief Add fields from \a tag to \a tagObject.
+QVariantMap &operator<<(QVariantMap &tagObject, const Tag &tag)
 {
     for (const auto &mapping : Cli::FieldMapping::mapping()) {
         const auto fieldName = [&] {
@@ -58,7 +58,7 @@ TAGEDITOR_JS_VALUE &operator<<(TAGEDITOR_JS_VALUE &tagObject, const Tag &tag)
         case KnownField::PartNumber:
         case KnownField::TotalParts:
             try {
-                tagObject.setProperty(fieldName, tag.value(mapping.knownField).toInteger() TAGEDITOR_JS_READONLY);
+                tagObject.insert(fieldName, tag.value(mapping.knownField).toInteger());
             } catch (const ConversionException &) {
             }
             break;
@@ -66,8 +66,8 @@ TAGEDITOR_JS_VALUE &operator<<(TAGEDITOR_JS_VALUE &tagObject, const Tag &tag)
         case KnownField::DiskPosition:
             try {
                 const auto pos = tag.value(mapping.knownField).toPositionInSet();
-                tagObject.setProperty(fieldName + QStringLiteral("Pos"), pos.position() TAGEDITOR_JS_READONLY);
-                tagObject.setProperty(fieldName + QStringLiteral("Total"), pos.total() TAGEDITOR_JS_READONLY);
+                tagObject.insert(fieldName + QStringLiteral("Pos"), pos.position());
+                tagObject.insert(fieldName + QStringLiteral("Total"), pos.total());
             } catch (const ConversionException &) {
             }
             break;
@@ -76,7 +76,7 @@ TAGEDITOR_JS_VALUE &operator<<(TAGEDITOR_JS_VALUE &tagObject, const Tag &tag)
             break;
         default:
             try {
-                tagObject.setProperty(fieldName, tagValueToQString(tag.value(mapping.knownField)) TAGEDITOR_JS_READONLY);
+                tagObject.insert(fieldName, tagValueToQString(tag.value(mapping.knownField)));
             } catch (const ConversionException &) {
             }
         }
@@ -84,22 +84,47 @@ TAGEDITOR_JS_VALUE &operator<<(TAGEDITOR_JS_VALUE &tagObject, const Tag &tag)
     return tagObject;
 }
 
-TagEditorObject::TagEditorObject(TAGEDITOR_JS_ENGINE *engine)
+/// \brief Defines the properties of a file info object which require parsing the file completely as getters doing so on first access.
+static constexpr const char *lazyPropertiesDefinition = R"js(
+(function(fileInfo) {
+    var completeFileInfo;
+    ["mimeType", "suitableSuffix", "technicalSummary", "hasAudioTracks", "hasVideoTracks", "tracks"].forEach(function(name) {
+        Object.defineProperty(fileInfo, name, {
+            enumerable: true,
+            get: function() {
+                if (!completeFileInfo) {
+                    completeFileInfo = tageditor.parseFileInfo(fileInfo.currentPath);
+                }
+                return completeFileInfo[name];
+            }
+        });
+    });
+})
+)js";
+
+TagEditorObject::TagEditorObject(TAGEDITOR_JS_ENGINE *engine, ParseResultCache *parseResultCache)
     : m_engine(engine)
+    , m_parseResultCache(parseResultCache)
     , m_currentType(ItemType::Dir)
     , m_action(ActionType::None)
 {
 }
 
-void TagEditorObject::setFileInfo(const QFileInfo &file, FileSystemItem *item)
+/*!
+ * \brief Makes the specified \a file available in the script and resets the outcome of the previous execution.
+ * \remarks The \a type and \a relativeDirectory are passed explicitly (instead of the item) so the script can be executed without
+ *          accessing the item tree.
+ */
+void TagEditorObject::setFileInfo(const QFileInfo &file, ItemType type, const QString &relativeDirectory)
 {
     m_currentPath = file.absoluteFilePath();
     m_currentName = file.fileName();
-    m_currentRelativeDirectory = item->relativeDir();
-    m_currentType = item->type();
+    m_currentRelativeDirectory = relativeDirectory;
+    m_currentType = type;
     m_action = ActionType::None;
     m_newName.clear();
     m_newRelativeDirectory.clear();
+    m_note.clear();
 }
 
 const QString &TagEditorObject::currentPath() const
@@ -137,28 +162,86 @@ const QString &TagEditorObject::newRelativeDirectory() const
     return m_newRelativeDirectory;
 }
 
+/*!
+ * \brief Parses the file with the specified \a fileName completely and returns the gathered information.
+ */
 TAGEDITOR_JS_VALUE TagEditorObject::parseFileInfo(const QString &fileName)
+{
+    return parseFile(fileName, false);
+}
+
+/*!
+ * \brief Parses only the container header and the tags of the file with the specified \a fileName and returns the gathered
+ *        information.
+ * \remarks
+ * - This is considerably faster than parseFileInfo() for big files (especially videos) as tracks, chapters and attachments are
+ *   not parsed.
+ * - The returned object has the same properties as the one returned by parseFileInfo(). The properties requiring track
+ *   information ("mimeType", "suitableSuffix", "technicalSummary", "hasAudioTracks", "hasVideoTracks" and "tracks") are
+ *   populated lazily by parsing the file completely when one of them is accessed for the first time.
+ */
+TAGEDITOR_JS_VALUE TagEditorObject::parseTags(const QString &fileName)
+{
+    return parseFile(fileName, true);
+}
+
+/*!
+ * \brief Parses the file with the specified \a fileName and returns the gathered information.
+ * \remarks
+ * - Only the container header and the tags are parsed if \a tagsOnly is set.
+ * - The information is taken from the cache if the file has been parsed before and has not changed since then.
+ */
+TAGEDITOR_JS_VALUE TagEditorObject::parseFile(const QString &fileName, bool tagsOnly)
+{
+    auto fileInfoObject = m_engine->toScriptValue(m_parseResultCache
+            ? m_parseResultCache->get(fileName, tagsOnly, [&] { return parseFileToVariantMap(fileName, tagsOnly); })
+            : parseFileToVariantMap(fileName, tagsOnly));
+
+    // define getters parsing the file completely on first access if only the tags have been parsed
+    if (tagsOnly) {
+        // note: The function is not kept as member as this object is destroyed by the engine (and compiling it is cheap compared
+        //       to parsing the file anyways).
+        auto defineLazyProperties = m_engine->evaluate(QString::fromLatin1(lazyPropertiesDefinition));
+#if defined(TAGEDITOR_USE_JSENGINE)
+        defineLazyProperties.call(QJSValueList{ fileInfoObject });
+#else
+        defineLazyProperties.call(QScriptValue(), QScriptValueList{ fileInfoObject });
+#endif
+    }
+    return fileInfoObject;
+}
+
+/*!
+ * \brief Parses the file with the specified \a fileName and returns the gathered information as QVariantMap.
+ * \remarks Only the container header and the tags are parsed if \a tagsOnly is set.
+ */
+QVariantMap TagEditorObject::parseFileToVariantMap(const QString &fileName, bool tagsOnly)
 {
     Diagnostics diag;
     AbortableProgressFeedback progress; // FIXME: actually use the progress object
     MediaFileInfo fileInfo(std::string(toNativeFileName(fileName).data()));
 
     // add basic file information
-    auto fileInfoObject = m_engine->newObject();
-    fileInfoObject.setProperty(QStringLiteral("currentPath"), QString::fromUtf8(fileInfo.path().data()));
-    fileInfoObject.setProperty(QStringLiteral("currentPathWithoutExtension"), QString::fromUtf8(fileInfo.pathWithoutExtension().data()));
-    fileInfoObject.setProperty(QStringLiteral("currentName"), QString::fromUtf8(fileInfo.fileName(false).data()));
-    fileInfoObject.setProperty(QStringLiteral("currentBaseName"), QString::fromUtf8(fileInfo.fileName(true).data()));
+    auto fileInfoObject = QVariantMap();
+    fileInfoObject.insert(QStringLiteral("currentPath"), QString::fromUtf8(fileInfo.path().data()));
+    fileInfoObject.insert(QStringLiteral("currentPathWithoutExtension"), QString::fromUtf8(fileInfo.pathWithoutExtension().data()));
+    fileInfoObject.insert(QStringLiteral("currentName"), QString::fromUtf8(fileInfo.fileName(false).data()));
+    fileInfoObject.insert(QStringLiteral("currentBaseName"), QString::fromUtf8(fileInfo.fileName(true).data()));
     QString suffix = fromNativeFileName(fileInfo.extension().data());
     if (suffix.startsWith('.')) {
         suffix.remove(0, 1);
     }
-    fileInfoObject.setProperty(QStringLiteral("currentSuffix"), suffix TAGEDITOR_JS_READONLY);
+    fileInfoObject.insert(QStringLiteral("currentSuffix"), suffix);
 
     // parse further file information
     bool criticalParseingErrorOccured = false, ioErrorOccured = false;
     try {
-        fileInfo.parseEverything(diag, progress);
+        if (tagsOnly) {
+            fileInfo.parseContainerFormat(diag, progress);
+            fileInfo.parseTags(diag, progress);
+        } else {
+            fileInfo.parseEverything(diag, progress);
+        }
     } catch (const Failure &) {
         // parsing notifications will be added anyways
         criticalParseingErrorOccured = true;
@@ -168,52 +251,54 @@ TAGEDITOR_JS_VALUE TagEditorObject::parseFileInfo(const QString &fileName)
     }
 
     // add diag messages
-    auto diagObj = m_engine->newArray(static_cast<uint>(diag.size()));
-    diagObj << diag;
+    auto diagList = QVariantList();
+    diagList << diag;
     criticalParseingErrorOccured |= diag.level() >= DiagLevel::Critical;
-    fileInfoObject.setProperty(QStringLiteral("hasCriticalMessages"), criticalParseingErrorOccured);
-    fileInfoObject.setProperty(QStringLiteral("ioErrorOccured"), ioErrorOccured);
-    fileInfoObject.setProperty(QStringLiteral("diagMessages"), diagObj);
-
-    // add MIME-type, suitable suffix and technical summary
-    fileInfoObject.setProperty(QStringLiteral("mimeType"), qstr(fileInfo.mimeType()) TAGEDITOR_JS_READONLY);
-    fileInfoObject.setProperty(QStringLiteral("suitableSuffix"), qstr(fileInfo.containerFormatAbbreviation()) TAGEDITOR_JS_READONLY);
-    fileInfoObject.setProperty(QStringLiteral("technicalSummary"), qstr(fileInfo.technicalSummary()) TAGEDITOR_JS_READONLY);
-    fileInfoObject.setProperty(QStringLiteral("hasAudioTracks"), fileInfo.hasTracksOfType(MediaType::Audio) TAGEDITOR_JS_READONLY);
-    fileInfoObject.setProperty(QStringLiteral("hasVideoTracks"), fileInfo.hasTracksOfType(MediaType::Video) TAGEDITOR_JS_READONLY);
+    fileInfoObject.insert(QStringLiteral("hasCriticalMessages"), criticalParseingErrorOccured);
+    fileInfoObject.insert(QStringLiteral("ioErrorOccured"), ioErrorOccured);
+    fileInfoObject.insert(QStringLiteral("diagMessages"), diagList);
 
     // add tag information
     const vector<Tag *> tags = fileInfo.tags();
-    auto combinedTagObject = m_engine->newObject();
-    auto tagsObject = m_engine->newArray(static_cast<uint>(tags.size()));
-    std::uint32_t tagIndex = 0;
-    for (auto tagIterator = tags.cbegin(), end = tags.cend(); tagIterator != end; ++tagIterator, ++tagIndex) {
-        const Tag &tag = **tagIterator;
-        auto tagObject = m_engine->newObject();
-        combinedTagObject << tag;
-        tagObject << tag;
-        tagsObject.setProperty(tagIndex, tagObject TAGEDITOR_JS_READONLY);
+    auto combinedTagObject = QVariantMap();
+    auto tagsList = QVariantList();
+    tagsList.reserve(static_cast<decltype(tagsList.size())>(tags.size()));
+    for (const auto *const tag : tags) {
+        auto tagObject = QVariantMap();
+        combinedTagObject << *tag;
+        tagObject << *tag;
+        tagsList << tagObject;
     }
-    fileInfoObject.setProperty(QStringLiteral("tag"), combinedTagObject TAGEDITOR_JS_READONLY);
-    fileInfoObject.setProperty(QStringLiteral("tags"), tagsObject TAGEDITOR_JS_READONLY);
+    fileInfoObject.insert(QStringLiteral("tag"), combinedTagObject);
+    fileInfoObject.insert(QStringLiteral("tags"), tagsList);
+    if (tagsOnly) {
+        return fileInfoObject;
+    }
+
+    // add MIME-type and suitable suffix
+    // note: Both depend on the tracks (e.g. an MP4 file is only considered a video if it has video tracks).
+    fileInfoObject.insert(QStringLiteral("mimeType"), qstr(fileInfo.mimeType()));
+    fileInfoObject.insert(QStringLiteral("suitableSuffix"), qstr(fileInfo.containerFormatAbbreviation()));
 
-    // add track information
+    // add technical summary and track information
+    fileInfoObject.insert(QStringLiteral("technicalSummary"), qstr(fileInfo.technicalSummary()));
+    fileInfoObject.insert(QStringLiteral("hasAudioTracks"), fileInfo.hasTracksOfType(MediaType::Audio));
+    fileInfoObject.insert(QStringLiteral("hasVideoTracks"), fileInfo.hasTracksOfType(MediaType::Video));
     const vector<AbstractTrack *> tracks = fileInfo.tracks();
-    auto tracksObject = m_engine->newArray(static_cast<uint>(tracks.size()));
-    std::uint32_t trackIndex = 0;
-    for (auto trackIterator = tracks.cbegin(), end = tracks.cend(); trackIterator != end; ++trackIterator, ++trackIndex) {
-        const AbstractTrack &track = **trackIterator;
-        auto trackObject = m_engine->newObject();
-        trackObject.setProperty(QStringLiteral("mediaType"), qstr(track.mediaTypeName()));
-        trackObject.setProperty(QStringLiteral("format"), qstr(track.formatName()));
-        trackObject.setProperty(QStringLiteral("formatAbbreviation"), qstr(track.formatAbbreviation()));
-        trackObject.setProperty(QStringLiteral("version"), QString::number(track.version()));
-        trackObject.setProperty(QStringLiteral("language"), QString::fromStdString(track.locale().someAbbreviatedName()));
-        trackObject.setProperty(QStringLiteral("description"), QString::fromStdString(track.description()));
-        trackObject.setProperty(QStringLiteral("shortDescription"), QString::fromStdString(track.shortDescription()));
-        tracksObject.setProperty(trackIndex, trackObject TAGEDITOR_JS_READONLY);
+    auto tracksList = QVariantList();
+    tracksList.reserve(static_cast<decltype(tracksList.size())>(tracks.size()));
+    for (const auto *const track : tracks) {
+        auto trackObject = QVariantMap();
+        trackObject.insert(QStringLiteral("mediaType"), qstr(track->mediaTypeName()));
+        trackObject.insert(QStringLiteral("format"), qstr(track->formatName()));
+        trackObject.insert(QStringLiteral("formatAbbreviation"), qstr(track->formatAbbreviation()));
+        trackObject.insert(QStringLiteral("version"), QString::number(track->version()));
+        trackObject.insert(QStringLiteral("language"), QString::fromStdString(track->locale().someAbbreviatedName()));
+        trackObject.insert(QStringLiteral("description"), QString::fromStdString(track->description()));
+        trackObject.insert(QStringLiteral("shortDescription"), QString::fromStdString(track->shortDescription()));
+        tracksList << trackObject;
     }
-    fileInfoObject.setProperty(QStringLiteral("tracks"), tracksObject TAGEDITOR_JS_READONLY);
+    fileInfoObject.insert(QStringLiteral("tracks"), tracksList);
 
     return fileInfoObject;
 }
@@ -6,12 +6,13 @@
 #include "./jsdefs.h"
 
 #include <QObject>
+#include <QVariantMap>
 
 QT_FORWARD_DECLARE_CLASS(QFileInfo)
 
 namespace RenamingUtility {
 
-class FileSystemItem;
+class ParseResultCache;
 enum class ItemType;
 enum class ActionType;
 
@@ -27,10 +28,10 @@ class TagEditorObject : public QObject {
     Q_PROPERTY(QString note READ note)
 
 public:
-    explicit TagEditorObject(TAGEDITOR_JS_ENGINE *engine);
+    explicit TagEditorObject(TAGEDITOR_JS_ENGINE *engine, ParseResultCache *parseResultCache = nullptr);
 
     ActionType action() const;
-    void setFileInfo(const QFileInfo &file, FileSystemItem *item);
+    void setFileInfo(const QFileInfo &file, ItemType type, const QString &relativeDirectory);
 
     const QString &currentPath() const;
     const QString &currentName() const;
@@ -43,6 +44,7 @@ public:
 
 public Q_SLOTS:
     TAGEDITOR_JS_VALUE parseFileInfo(const QString &fileName);
+    TAGEDITOR_JS_VALUE parseTags(const QString &fileName);
     TAGEDITOR_JS_VALUE parseFileName(const QString &fileName);
     TAGEDITOR_JS_VALUE allFiles(const QString &dirName);
     TAGEDITOR_JS_VALUE firstFile(const QString &dirName);
@@ -52,7 +54,11 @@ public Q_SLOTS:
     void skip(const QString &note = QString());
 
 private:
+    TAGEDITOR_JS_VALUE parseFile(const QString &fileName, bool tagsOnly);
+    static QVariantMap parseFileToVariantMap(const QString &fileName, bool tagsOnly);
+
     TAGEDITOR_JS_ENGINE *m_engine;
+    ParseResultCache *m_parseResultCache;
     QString m_currentPath;
     QString m_currentName;
     QString m_currentRelativeDirectory;
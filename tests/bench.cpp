@@ -0,0 +1,504 @@
+// Benchmark for the hot paths of the CLI (build the target "tageditor_bench" explicitly; it is not part of "all")
+//
+// Generates corpora of different formats, sizes and paddings from the test files and times the operations get, set (with
+// and without reusing the padding, with and without cloning output files), export and set --script by invoking the
+// tageditor executable once per file. The results are printed as JSON so they can be compared between releases.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/*!
+ * \brief The Settings struct holds the settings specified via the command-line.
+ */
+struct Settings {
+    std::string tageditor = TAGEDITOR_BENCH_EXECUTABLE;
+    fs::path testFiles;
+    fs::path workDir = fs::temp_directory_path() / "tageditor-bench";
+    fs::path output;
+    std::size_t copies = 20;
+};
+
+/*!
+ * \brief The Source struct specifies a test file corpora are generated from.
+ */
+struct Source {
+    const char *format;
+    const char *path;
+    bool id3v1;
+};
+
+/*!
+ * \brief The Corpus struct holds the files generated for a source with a certain padding.
+ */
+struct Corpus {
+    std::string name;
+    std::string format;
+    std::uint64_t padding = 0;
+    std::vector<std::string> files;
+    std::uint64_t bytes = 0;
+};
+
+/*!
+ * \brief The Run struct holds the measurements of a single invocation of the tageditor executable.
+ */
+struct Run {
+    double seconds = 0.0;
+    long maxRssKiB = 0;
+    std::uint64_t bytesRead = 0;
+    std::uint64_t bytesWritten = 0;
+    bool success = false;
+};
+
+/*!
+ * \brief The Result struct holds the aggregated measurements of a benchmark over a corpus.
+ */
+struct Result {
+    std::string benchmark;
+    const Corpus *corpus = nullptr;
+    std::vector<double> latencies;
+    double totalSeconds = 0.0;
+    long peakRssKiB = 0;
+    std::uint64_t bytesRead = 0;
+    std::uint64_t bytesWritten = 0;
+    std::size_t failures = 0;
+};
+
+// clang-format off
+const Source sources[] = {
+    { "mp3", "mtx-test-data/mp3/id3-tag-and-xing-header.mp3", true },
+    { "mp3", "misc/multiple_id3v2_4_values.mp3", true },
+    { "flac", "flac/test.flac", false },
+    { "mp4", "mtx-test-data/aac/he-aacv2-ps.m4a", false },
+    { "mp4", "mtx-test-data/alac/othertest-itunes.m4a", false },
+    { "mkv", "matroska_wave1/test1.mkv", false },
+    { "mkv", "matroska_wave1/test3.mkv", false },
+};
+// clang-format on
+constexpr std::uint64_t paddings[] = { 0, 4 * 1024, 64 * 1024 };
+
+/*!
+ * \brief Reads the number of bytes read and written by the process with the specified \a pid (which must not be reaped yet).
+ * \remarks The counters are those of the read()/write() family of system calls so copies done by the kernel on behalf of
+ *          the process (e.g. when cloning files) are not included. Only supported under Linux; otherwise the counters stay 0.
+ */
+void readIoCounters(pid_t pid, Run &res)
+{
+    auto io = std::ifstream("/proc/" + std::to_string(pid) + "/io");
+    auto line = std::string();
+    while (std::getline(io, line)) {
+        if (line.rfind("rchar: ", 0) == 0) {
+            res.bytesRead = std::strtoull(line.data() + 7, nullptr, 10);
+        } else if (line.rfind("wchar: ", 0) == 0) {
+            res.bytesWritten = std::strtoull(line.data() + 7, nullptr, 10);
+        }
+    }
+}
+
+/*!
+ * \brief Runs the tageditor executable with the specified \a args discarding its output.
+ * \remarks If \a errorOutput is specified, the error output is written to that file instead.
+ */
+Run run(const Settings &settings, const std::vector<std::string> &args, const fs::path &errorOutput = fs::path())
+{
+    auto argv = std::vector<char *>();
+    argv.reserve(args.size() + 2);
+    argv.emplace_back(const_cast<char *>(settings.tageditor.data()));
+    for (const auto &arg : args) {
+        argv.emplace_back(const_cast<char *>(arg.data()));
+    }
+    argv.emplace_back(nullptr);
+
+    auto res = Run();
+    const auto start = std::chrono::steady_clock::now();
+    const auto pid = fork();
+    if (pid < 0) {
+        return res;
+    }
+    if (!pid) {
+        if (const auto devNull = open("/dev/null", O_WRONLY); devNull >= 0) {
+            dup2(devNull, STDOUT_FILENO);
+            dup2(devNull, STDERR_FILENO);
+        }
+        if (!errorOutput.empty()) {
+            if (const auto errorFile = open(errorOutput.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666); errorFile >= 0) {
+                dup2(errorFile, STDERR_FILENO);
+            }
+        }
+        execv(argv.front(), argv.data());
+        _exit(127);
+    }
+    auto info = siginfo_t();
+    if (!waitid(P_PID, static_cast<id_t>(pid), &info, WEXITED | WNOWAIT)) {
+        readIoCounters(pid, res);
+    }
+    auto status = 0;
+    auto usage = rusage();
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        return res;
+    }
+    res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    res.maxRssKiB = usage.ru_maxrss;
+    res.success = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    return res;
+}
+
+/*!
+ * \brief Generates the corpora for all sources which are present within the test files directory.
+ */
+std::vector<Corpus> generateCorpora(const Settings &settings)
+{
+    auto corpora = std::vector<Corpus>();
+    for (const auto &source : sources) {
+        const auto sourcePath = settings.testFiles / source.path;
+        if (!fs::is_regular_file(sourcePath)) {
+            std::cerr << "Skipping \"" << sourcePath.string() << "\" (not found)\n";
+            continue;
+        }
+        for (const auto padding : paddings) {
+            auto &corpus = corpora.emplace_back();
+            corpus.name = sourcePath.stem().string() + "-padding" + std::to_string(padding);
+            corpus.format = source.format;
+            corpus.padding = padding;
+            const auto dir = settings.workDir / "corpora" / corpus.format / corpus.name;
+            fs::create_directories(dir);
+            for (auto i = std::size_t(); i != settings.copies; ++i) {
+                const auto path = dir / (std::to_string(i) + sourcePath.extension().string());
+                fs::copy_file(sourcePath, path, fs::copy_options::overwrite_existing);
+                corpus.files.emplace_back(path.string());
+            }
+
+            // apply the padding (and tag formats) once for the whole corpus
+            const auto paddingStr = std::to_string(padding);
+            auto args = std::vector<std::string>{ "set", "comment=tageditor benchmark", "--force-rewrite", "--min-padding", paddingStr,
+                "--max-padding", paddingStr, "--preferred-padding", paddingStr, "--id3v2-usage", "always", "--id3v1-usage",
+                source.id3v1 ? "always" : "never", "-f" };
+            args.insert(args.end(), corpus.files.begin(), corpus.files.end());
+            if (!run(settings, args).success) {
+                std::cerr << "Error: Unable to prepare corpus \"" << corpus.name << "\"; the results would be incomplete.\n";
+                std::exit(EXIT_FAILURE);
+            }
+            for (const auto &file : corpus.files) {
+                corpus.bytes += fs::file_size(file);
+            }
+        }
+    }
+    return corpora;
+}
+
+/*!
+ * \brief Invokes the tageditor executable for each file of the \a corpus with \a args followed by "-f" and the file.
+ * \remarks If \a outputDir is specified, "-o" and a file within that directory is appended as well.
+ */
+Result benchmark(
+    const Settings &settings, const char *name, const Corpus &corpus, const std::vector<std::string> &args, const fs::path &outputDir = fs::path())
+{
+    auto result = Result();
+    result.benchmark = name;
+    result.corpus = &corpus;
+    result.latencies.reserve(corpus.files.size());
+    auto fileArgs = args;
+    fileArgs.emplace_back("-f");
+    fileArgs.emplace_back();
+    const auto fileArgIndex = fileArgs.size() - 1;
+    if (!outputDir.empty()) {
+        fs::create_directories(outputDir);
+        fileArgs.emplace_back("-o");
+        fileArgs.emplace_back();
+    }
+    for (const auto &file : corpus.files) {
+        fileArgs[fileArgIndex] = file;
+        if (!outputDir.empty()) {
+            fileArgs.back() = (outputDir / fs::path(file).filename()).string();
+        }
+        const auto res = run(settings, fileArgs);
+        result.latencies.emplace_back(res.seconds);
+        result.totalSeconds += res.seconds;
+        result.peakRssKiB = std::max(result.peakRssKiB, res.maxRssKiB);
+        result.bytesRead += res.bytesRead;
+        result.bytesWritten += res.bytesWritten;
+        result.failures += !res.success;
+    }
+    if (!outputDir.empty()) {
+        fs::remove_all(outputDir);
+    }
+    return result;
+}
+
+/*!
+ * \brief Returns the "title=…" argument for the benchmark with the specified \a name.
+ * \remarks Each benchmark uses a different title so the files are never left unchanged because the previous benchmark has
+ *          already written the same value.
+ */
+std::string titleArg(std::string_view name)
+{
+    auto arg = std::string("title=tageditor benchmark (");
+    arg += name;
+    arg += ')';
+    return arg;
+}
+
+/*!
+ * \brief Returns whether files within \a dir can be cloned (only supported under Linux with a file system supporting reflinks).
+ */
+bool supportsCloning(const fs::path &dir)
+{
+#if defined(__linux__) && defined(FICLONE)
+    const auto source = dir / "clone-test-source", target = dir / "clone-test-target";
+    auto supported = false;
+    if (const auto sourceFd = open(source.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666); sourceFd >= 0) {
+        if (write(sourceFd, "test", 4) == 4) {
+            if (const auto targetFd = open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666); targetFd >= 0) {
+                supported = !ioctl(targetFd, FICLONE, sourceFd);
+                close(targetFd);
+            }
+        }
+        close(sourceFd);
+    }
+    auto ec = std::error_code();
+    fs::remove(source, ec);
+    fs::remove(target, ec);
+    return supported;
+#else
+    static_cast<void>(dir);
+    return false;
+#endif
+}
+
+/*!
+ * \brief Checks whether writing an output file with \a args actually exercises the code path for cloning if \a cloning is
+ *        set (or the code path for copying otherwise); exits if not.
+ * \remarks The check is done via the profile printed by the tageditor executable so it is not part of the timed runs.
+ */
+void checkOutputFileRun(const Settings &settings, const std::string &file, std::vector<std::string> args, bool cloning)
+{
+    const auto outputDir = settings.workDir / "output-check";
+    const auto log = settings.workDir / "output-check.log";
+    fs::create_directories(outputDir);
+    args.insert(args.end(), { "--profile", "-f", file, "-o", (outputDir / fs::path(file).filename()).string() });
+    const auto res = run(settings, args, log);
+    auto profile = std::stringstream();
+    profile << std::ifstream(log).rdbuf();
+    fs::remove_all(outputDir);
+    fs::remove(log);
+    // note: A cloned file might still be rewritten completely (if the padding is not sufficient) but it must not be unchanged.
+    const auto expectedFiles = std::string_view(cloning ? " 1 cloned, 0 unchanged)" : " (1 rewritten completely, 0 cloned, 0 unchanged)");
+    if (!res.success || profile.str().find(" - Files:         1 (") == std::string::npos || profile.str().find(expectedFiles) == std::string::npos
+        || profile.str().find(" - Bytes written: 0 bytes") != std::string::npos) {
+        std::cerr << "Error: Writing an output file " << (cloning ? "with" : "without") << " cloning did not work as expected; the profile is:\n"
+                  << profile.str();
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/*!
+ * \brief Returns the specified \a percentile of the latencies in milliseconds.
+ */
+double percentile(std::vector<double> latencies, double percentile)
+{
+    if (latencies.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(percentile * static_cast<double>(latencies.size() - 1) + 0.5);
+    std::nth_element(latencies.begin(), latencies.begin() + static_cast<std::ptrdiff_t>(index), latencies.end());
+    return latencies[index] * 1000.0;
+}
+
+/*!
+ * \brief Writes \a str as JSON string to \a out.
+ */
+void writeJsonString(std::ostream &out, std::string_view str)
+{
+    out << '"';
+    for (const auto c : str) {
+        switch (c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+            } else {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+}
+
+/*!
+ * \brief Writes the \a results as JSON to \a out.
+ */
+void writeResults(std::ostream &out, const Settings &settings, const std::vector<Result> &results)
+{
+    out << "{\n  \"tageditor\": ";
+    writeJsonString(out, settings.tageditor);
+    out << ",\n  \"copies\": " << settings.copies << ",\n  \"results\": [";
+    auto first = true;
+    for (const auto &result : results) {
+        const auto &corpus = *result.corpus;
+        const auto megabytes = static_cast<double>(corpus.bytes) / (1024.0 * 1024.0);
+        const auto seconds = result.totalSeconds > 0.0 ? result.totalSeconds : 1.0;
+        out << (first ? "\n" : ",\n") << "    {\"benchmark\": ";
+        writeJsonString(out, result.benchmark);
+        out << ", \"corpus\": ";
+        writeJsonString(out, corpus.name);
+        out << ", \"format\": ";
+        writeJsonString(out, corpus.format);
+        out << ", \"padding\": " << corpus.padding << ", \"files\": " << corpus.files.size() << ", \"bytes\": " << corpus.bytes
+            << ", \"seconds\": " << result.totalSeconds << ", \"filesPerSecond\": " << static_cast<double>(corpus.files.size()) / seconds
+            << ", \"megabytesPerSecond\": " << megabytes / seconds << ", \"p50Ms\": " << percentile(result.latencies, 0.5)
+            << ", \"p99Ms\": " << percentile(result.latencies, 0.99) << ", \"peakRssKiB\": " << result.peakRssKiB
+            << ", \"bytesReadPerFile\": " << result.bytesRead / corpus.files.size()
+            << ", \"bytesWrittenPerFile\": " << result.bytesWritten / corpus.files.size() << ", \"failures\": " << result.failures << '}';
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+}
+
+/*!
+ * \brief Parses the command-line; exits on invalid arguments.
+ */
+Settings parseSettings(int argc, char *argv[])
+{
+    auto settings = Settings();
+    if (const auto *const testFilePath = std::getenv("TEST_FILE_PATH")) {
+        settings.testFiles = testFilePath;
+    } else {
+        settings.testFiles = TAGEDITOR_BENCH_SOURCE_DIR "/testfiles";
+    }
+    for (auto i = 1; i < argc; ++i) {
+        const auto arg = std::string_view(argv[i]);
+        if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [--tageditor path] [--test-files dir] [--work-dir dir] [--copies n] [--output file]\n"
+                      << "The test files directory defaults to $TEST_FILE_PATH.\n";
+            std::exit(EXIT_SUCCESS);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: No value specified for \"" << arg << "\".\n";
+            std::exit(EXIT_FAILURE);
+        }
+        const auto *const value = argv[++i];
+        if (arg == "--tageditor") {
+            settings.tageditor = value;
+        } else if (arg == "--test-files") {
+            settings.testFiles = value;
+        } else if (arg == "--work-dir") {
+            settings.workDir = value;
+        } else if (arg == "--output") {
+            settings.output = value;
+        } else if (arg == "--copies") {
+            settings.copies = std::strtoul(value, nullptr, 10);
+            if (!settings.copies) {
+                std::cerr << "Error: The number of copies must be a positive integer.\n";
+                std::exit(EXIT_FAILURE);
+            }
+        } else {
+            std::cerr << "Error: The argument \"" << arg << "\" is unknown.\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    return settings;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const auto settings = parseSettings(argc, argv);
+    auto corpora = std::vector<Corpus>();
+    try {
+        corpora = generateCorpora(settings);
+    } catch (const fs::filesystem_error &e) {
+        std::cerr << "Error: Unable to generate corpora: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    if (corpora.empty()) {
+        std::cerr << "Error: No corpora could be generated; specify the directory containing the test files via --test-files.\n";
+        return EXIT_FAILURE;
+    }
+
+    // check which optional features are available by trying them on the first file
+    const auto &probe = corpora.front().files.front();
+    const auto script = (fs::path(TAGEDITOR_BENCH_SOURCE_DIR) / "testfiles" / "script-processing-test.js").string();
+    const auto exportArgs = std::vector<std::string>{ "export" };
+    const auto scriptArgs = std::vector<std::string>{ "set", "--script", script, "--script-settings", "set:title=bench", "dryRun=1" };
+    const auto hasExport = run(settings, { "export", "-f", probe }).success;
+    const auto hasScript = run(settings, { "set", "--script", script, "--script-settings", "dryRun=1", "-f", probe }).success;
+    if (!hasExport) {
+        std::cerr << "Skipping export benchmark (feature not enabled)\n";
+    }
+    if (!hasScript) {
+        std::cerr << "Skipping script benchmark (feature not enabled)\n";
+    }
+    const auto canClone = supportsCloning(settings.workDir);
+    if (!canClone) {
+        std::cerr << "Not checking whether output files are cloned (not supported by the file system of the work directory)\n";
+    }
+
+    // run the benchmarks
+    auto results = std::vector<Result>();
+    for (const auto &corpus : corpora) {
+        std::cerr << "Benchmarking " << corpus.format << '/' << corpus.name << '\n';
+        results.emplace_back(benchmark(settings, "get", corpus, { "get" }));
+        results.emplace_back(benchmark(
+            settings, "set-reuse-padding", corpus, { "set", titleArg("set-reuse-padding"), "--max-padding", std::to_string(1024 * 1024) }));
+        results.emplace_back(benchmark(settings, "set-rewrite", corpus, { "set", titleArg("set-rewrite"), "--force-rewrite" }));
+        const auto outputDir = settings.workDir / "output";
+        const auto outputArgs = std::vector<std::string>{ "set", titleArg("set-output-file"), "--max-padding", std::to_string(1024 * 1024) };
+        const auto noCloneArgs
+            = std::vector<std::string>{ "set", titleArg("set-output-file-no-clone"), "--max-padding", std::to_string(1024 * 1024), "--no-clone" };
+        if (canClone) {
+            checkOutputFileRun(settings, corpus.files.front(), outputArgs, true);
+        }
+        checkOutputFileRun(settings, corpus.files.front(), noCloneArgs, false);
+        results.emplace_back(benchmark(settings, "set-output-file", corpus, outputArgs, outputDir));
+        results.emplace_back(benchmark(settings, "set-output-file-no-clone", corpus, noCloneArgs, outputDir));
+        if (hasExport) {
+            results.emplace_back(benchmark(settings, "export", corpus, exportArgs));
+        }
+        if (hasScript) {
+            results.emplace_back(benchmark(settings, "script", corpus, scriptArgs));
+        }
+    }
+
+    // print results
+    if (settings.output.empty()) {
+        writeResults(std::cout, settings, results);
+        return EXIT_SUCCESS;
+    }
+    auto file = std::ofstream(settings.output, std::ios_base::out | std::ios_base::trunc);
+    writeResults(file, settings, results);
+    if (!file.good()) {
+        std::cerr << "Error: Unable to write results to \"" << settings.output.string() << "\".\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
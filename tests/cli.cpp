@@ -4,6 +4,7 @@
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/binarywriter.h>
 #include <c++utilities/io/misc.h>
 #include <c++utilities/io/path.h>
 
@@ -13,9 +14,23 @@
 #include <tagparser/mediafileinfo.h>
 #include <tagparser/progressfeedback.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <thread>
+
+#if defined(PLATFORM_UNIX)
+#include <sys/stat.h>
+#endif
+
+#if defined(PLATFORM_UNIX) && defined(TAGEDITOR_JSON_EXPORT)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 namespace CppUtilities {
 
@@ -78,6 +93,15 @@ class CliTests : public TestFixture {
     CPPUNIT_TEST(testFileLayoutOptions);
     CPPUNIT_TEST(testJsonExport);
     CPPUNIT_TEST(testScriptProcessing);
+    CPPUNIT_TEST(testParallelProcessing);
+    CPPUNIT_TEST(testCache);
+    CPPUNIT_TEST(testManifest);
+    CPPUNIT_TEST(testServer);
+    CPPUNIT_TEST(testProfiling);
+    CPPUNIT_TEST(testPlan);
+    CPPUNIT_TEST(testAdaptivePadding);
+    CPPUNIT_TEST(testJournal);
+    CPPUNIT_TEST(testCoverNormalization);
 #endif
     CPPUNIT_TEST_SUITE_END();
 
@@ -105,6 +129,15 @@ public:
     void testFileLayoutOptions();
     void testJsonExport();
     void testScriptProcessing();
+    void testParallelProcessing();
+    void testCache();
+    void testManifest();
+    void testServer();
+    void testProfiling();
+    void testPlan();
+    void testAdaptivePadding();
+    void testJournal();
+    void testCoverNormalization();
 #endif
 
 private:
@@ -338,6 +371,19 @@ void CliTests::testModifyingCover()
     CPPUNIT_ASSERT_EQUAL_MESSAGE("All covers removed", std::string::npos, stdout.find("Cover"));
     CPPUNIT_ASSERT_EQUAL(0, remove(mp3File1Backup.data()));
 
+    // test whether a file denoted for multiple values is only read once
+    const char *const args6[] = { "tageditor", "set", otherCover.data(), backCover0.data(), "--profile", "-f", mp3File1.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args6);
+    CPPUNIT_ASSERT_MESSAGE("cover file read once", testContainsSubstrings(stderr, { " - Cover files:   1 read, 2 requested" }));
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT_MESSAGE("covers added",
+        testContainsSubstrings(stdout,
+            {
+                "    Cover (other)     can't display image/png as string (use --extract)\n"
+                "    Cover (back-cover) can't display image/png as string (use --extract)\n",
+            }));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mp3File1Backup.data()));
+
     CPPUNIT_ASSERT_EQUAL(0, remove(mp3File1.data()));
 }
 
@@ -672,6 +718,19 @@ void CliTests::testOutputFile()
           "    Title             test1\n",
             " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
             "    Title             test2\n" }));
+    // no backup files are left behind (even if the input files have been cloned and the clones needed to be rewritten)
+    CPPUNIT_ASSERT(!std::filesystem::exists(tempFile1 + ".bak"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(tempFile2 + ".bak"));
+
+    // existing output files are replaced; the result is the same when cloning is disabled
+    const char *const args4[]
+        = { "tageditor", "set", "target-level=30", "title=test3", "--no-clone", "-f", mkvFile1.data(), "-o", tempFile1.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    const char *const args5[] = { "tageditor", "get", "-f", tempFile1.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+          "    Title             test3\n" }));
 
     CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile1.data()));
     CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile2.data()));
@@ -1075,6 +1134,19 @@ void CliTests::testExtraction()
     CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(22771), extractedInfo.size());
     CPPUNIT_ASSERT(ContainerFormat::Jpeg == extractedInfo.containerFormat());
     extractedInfo.close();
+
+    // test extraction from multiple files via output path with placeholders
+    const auto outputDir = (std::filesystem::temp_directory_path() / "tageditor-extraction").string();
+    const auto outputPath = outputDir + "/{basename}-{index}.jpg";
+    const auto cover1 = outputDir + "/othertest-itunes-0.jpg", cover2 = outputDir + "/he-aacv2-ps-0.jpg";
+    const char *const args4[]
+        = { "tageditor", "extract", "cover", "-f", mp4File1.data(), mp4File2.data(), "-o", outputPath.data(), "--jobs", "2", nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Extracting field cover of", mp4File1.data(), cover1.data(), mp4File2.data(), cover2.data() }));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uintmax_t>(22771), std::filesystem::file_size(cover1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uintmax_t>(22771), std::filesystem::file_size(cover2));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uintmax_t>(3), std::filesystem::remove_all(outputDir));
+
     CPPUNIT_ASSERT_EQUAL(0, remove(tempFile.data()));
     CPPUNIT_ASSERT_EQUAL(0, remove(mp4File2.data()));
     CPPUNIT_ASSERT_EQUAL(0, remove((mp4File2 + ".bak").data()));
@@ -1174,6 +1246,27 @@ void CliTests::testJsonExport()
     execHelperAppInSearchPath("jq", jqArgs, stdout, stderr, !logJsonExport || !std::strlen(logJsonExport));
     CPPUNIT_ASSERT_EQUAL(""s, stderr);
     CPPUNIT_ASSERT_EQUAL("true\n"s, stdout);
+
+    // export as NDJSON (one object per line instead of an array)
+    const char *const ndjsonArgs[] = { "tageditor", "export", "--ndjson", "-f", file.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(ndjsonArgs);
+    CPPUNIT_ASSERT_EQUAL(1_st, static_cast<std::size_t>(std::count(stdout.cbegin(), stdout.cend(), '\n')));
+    CPPUNIT_ASSERT_EQUAL('\n', stdout.back());
+    const char *const ndjsonJqArgs[]
+        = { "jq", "--argjson", "expected", expectedJson.data(), "--argjson", "actual", stdout.data(), "-n", "[$actual] == $expected", nullptr };
+    execHelperAppInSearchPath("jq", ndjsonJqArgs, stdout, stderr, !logJsonExport || !std::strlen(logJsonExport));
+    CPPUNIT_ASSERT_EQUAL(""s, stderr);
+    CPPUNIT_ASSERT_EQUAL("true\n"s, stdout);
+
+    // export only certain fields (which skips parsing tracks so the track-dependent members are omitted)
+    const char *const fieldsArgs[] = { "tageditor", "export", "--ndjson", "title", "-f", file.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(fieldsArgs);
+    const char *const fieldsJqArgs[] = { "jq", "--argjson", "actual", stdout.data(), "-n",
+        "([$actual.tags[].fields | keys[]] | unique) == [\"title\"] and ($actual | has(\"formatSummary\") or has(\"duration\") or has(\"mimeType\") | not)",
+        nullptr };
+    execHelperAppInSearchPath("jq", fieldsJqArgs, stdout, stderr, !logJsonExport || !std::strlen(logJsonExport));
+    CPPUNIT_ASSERT_EQUAL(""s, stderr);
+    CPPUNIT_ASSERT_EQUAL("true\n"s, stdout);
 #endif // TAGEDITOR_JSON_EXPORT
 }
 
@@ -1211,6 +1304,532 @@ void CliTests::testScriptProcessing()
     CPPUNIT_ASSERT(testContainsSubstrings(stdout,
         { "Loading JavaScript file", script.data(), "Setting tag information for", file.data(),
             " - Skipping file because JavaScript returned a falsy value other than undefined." }));
+
+    // process multiple files in parallel (each worker thread is supposed to use its own JavaScript engine)
+    const auto file2 = workingCopyPath("mtx-test-data/aac/he-aacv2-ps.m4a");
+    const char *const parallelArgs[] = { "tageditor", "set", "--pedantic", "debug", "--script", script.data(), "--script-settings", "set:title=foo",
+        "dryRun=true", "--jobs", "2", "-f", file.data(), file2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(parallelArgs, EXIT_PARSING_FAILURE);
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, stderr.find("--jobs is not supported"));
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr,
+        { "executing JavaScript for othertest-itunes.m4a: entering main() function",
+            "executing JavaScript for othertest-itunes.m4a: done with return value: false",
+            "executing JavaScript for he-aacv2-ps.m4a: entering main() function",
+            "executing JavaScript for he-aacv2-ps.m4a: done with return value: false" }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { "Loading JavaScript file", script.data(), "Setting tag information for", file.data(),
+            " - Skipping file because JavaScript returned a falsy value other than undefined.", "Setting tag information for", file2.data(),
+            " - Skipping file because JavaScript returned a falsy value other than undefined." }));
+#endif
+}
+
+/*!
+ * \brief Tests processing multiple files in parallel via the --jobs parameter of the set, get and info operations.
+ */
+void CliTests::testParallelProcessing()
+{
+    cout << "\nProcessing multiple files in parallel" << endl;
+    string stdout, stderr;
+    const string mkvFile1(workingCopyPath("matroska_wave1/test1.mkv"));
+    const string mkvFile2(workingCopyPath("matroska_wave1/test2.mkv"));
+    const string mkvFile3(workingCopyPath("matroska_wave1/test3.mkv"));
+
+    // set title and part number of 3 files at once using 2 jobs
+    const char *const args1[] = { "tageditor", "set", "target-level=30", "title=test1", "title=test2", "title=test3", "part+=1", "--jobs", "2", "-f",
+        mkvFile1.data(), mkvFile2.data(), mkvFile3.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    // the output is expected in the order the files have been specified
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { "Setting tag information for \"", mkvFile1.data(), " - Changes have been applied.", "Setting tag information for \"", mkvFile2.data(),
+            " - Changes have been applied.", "Setting tag information for \"", mkvFile3.data(), " - Changes have been applied." }));
+
+    // check whether values have been assigned according to the file index (and increments are applied accordingly)
+    const char *const args2[] = { "tageditor", "get", "-f", mkvFile1.data(), mkvFile2.data(), mkvFile3.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+          "    Title             test1\n"
+          "    Part              1",
+            " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+            "    Title             test2\n"
+            "    Part              2",
+            " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+            "    Title             test3\n"
+            "    Part              3" }));
+
+    // check whether the output of read-only operations is the same when reading files in parallel
+    const auto serialGetOutput = stdout;
+    const char *const args3[] = { "tageditor", "get", "--jobs", "3", "-f", mkvFile1.data(), mkvFile2.data(), mkvFile3.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT_EQUAL(serialGetOutput, stdout);
+    const char *const args4[] = { "tageditor", "info", "-f", mkvFile1.data(), mkvFile2.data(), mkvFile3.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    const auto serialInfoOutput = stdout;
+    const char *const args5[] = { "tageditor", "info", "--jobs", "2", "-f", mkvFile1.data(), mkvFile2.data(), mkvFile3.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT_EQUAL(serialInfoOutput, stdout);
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile1.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile2.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile3.data()));
+    remove((mkvFile1 + ".bak").data()), remove((mkvFile2 + ".bak").data()), remove((mkvFile3 + ".bak").data());
+}
+
+/*!
+ * \brief Tests the --cache parameter of the get operation.
+ */
+void CliTests::testCache()
+{
+    cout << "\nCaching results of read-only operations" << endl;
+    string stdout, stderr;
+    const string mkvFile(workingCopyPath("matroska_wave1/test1.mkv"));
+    const string cacheFile(workingCopyPath("tageditor-cache.bin", WorkingCopyMode::NoCopy));
+    remove(cacheFile.data());
+
+    // read tags initially which creates the cache
+    const char *const args1[] = { "tageditor", "get", "title", "--cache", cacheFile.data(), "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Title             Big Buck Bunny - test 1" }));
+    CPPUNIT_ASSERT(std::filesystem::exists(cacheFile));
+
+    // read tags again which uses the cache and yields the same output
+    const auto uncachedOutput = stdout;
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT_EQUAL(uncachedOutput, stdout);
+
+    // modify the file which invalidates the cached result
+    const char *const args2[] = { "tageditor", "set", "title=changed", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Title             changed" }));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove((mkvFile + ".bak").data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(cacheFile.data()));
+}
+
+/*!
+ * \brief Tests the --manifest parameter of the set operation.
+ */
+void CliTests::testManifest()
+{
+    cout << "\nSetting tags via manifest" << endl;
+    string stdout, stderr;
+    const string mkvFile1(workingCopyPath("matroska_wave1/test1.mkv"));
+    const string mkvFile2(workingCopyPath("matroska_wave1/test2.mkv"));
+    const string manifestFile(workingCopyPath("tageditor-manifest.tsv", WorkingCopyMode::NoCopy));
+    {
+        auto manifest = std::ofstream(manifestFile, ios_base::out | ios_base::trunc);
+        manifest << "# file\tvalues\n"
+                 << mkvFile1 << "\ttarget-level=30\ttitle=manifest title 1\n"
+                 << "\n"
+                 << mkvFile2 << "\ttarget-level=30\ttitle=manifest title 2\tpart=5\n";
+    }
+
+    // set values via manifest; values from the manifest take precedence over values specified via --values
+    const char *const args1[] = { "tageditor", "set", "target-level=30", "part+=1", "--manifest", manifestFile.data(), "--jobs", "2", nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { "Setting tag information for \"", mkvFile1.data(), " - Changes have been applied.", "Setting tag information for \"", mkvFile2.data(),
+            " - Changes have been applied." }));
+    const char *const args2[] = { "tageditor", "get", "-f", mkvFile1.data(), mkvFile2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+          "    Title             manifest title 1\n"
+          "    Part              1",
+            " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+            "    Title             manifest title 2\n"
+            "    Part              5" }));
+
+    // invalid records stop processing
+    {
+        auto manifest = std::ofstream(manifestFile, ios_base::out | ios_base::trunc);
+        manifest << "\ttitle=no file\n";
+    }
+    const char *const args3[] = { "tageditor", "set", "--manifest", manifestFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args3, EXIT_FAILURE);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "Line 1 of the manifest", "is invalid: no file has been specified" }));
+
+    // invalid field denotations stop processing as well (instead of exiting while previous records are still processed)
+    {
+        auto manifest = std::ofstream(manifestFile, ios_base::out | ios_base::trunc);
+        manifest << mkvFile1 << "\ttarget-level=30\ttitle=manifest title 3\n" << mkvFile2 << "\t=no field name\n";
+    }
+    const char *const args4[] = { "tageditor", "set", "--manifest", manifestFile.data(), "--jobs", "2", nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args4, EXIT_FAILURE);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "Line 2 of the manifest", "is invalid: The field denotation \"=no field name\" has no field name." }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Setting tag information for \"", mkvFile1.data(), " - Changes have been applied." }));
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "    Title             manifest title 3\n", "    Title             manifest title 2\n" }));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile1.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile2.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(manifestFile.data()));
+    remove((mkvFile1 + ".bak").data()), remove((mkvFile2 + ".bak").data());
+}
+
+/*!
+ * \brief Tests the serve operation using a client connecting via the Unix domain socket.
+ */
+void CliTests::testServer()
+{
+#if !defined(PLATFORM_UNIX) || !defined(TAGEDITOR_JSON_EXPORT)
+    cout << "\nSkipping serving requests (feature not enabled)" << endl;
+#else
+    cout << "\nServing requests" << endl;
+    string stdout, stderr;
+    const string mkvFile(workingCopyPath("matroska_wave1/test1.mkv"));
+    const auto socketPath = (std::filesystem::temp_directory_path() / ("tageditor-test-" + std::to_string(::getpid()) + ".sock")).string();
+#ifdef TAGEDITOR_USE_JSENGINE
+    const auto script = testFilePath("script-processing-test.js");
+#endif
+
+    // connect to the server (which might not be listening yet) and send requests
+    // note: When the server is not listening within 5 seconds the client gives up but still keeps connecting (without sending
+    //       requests) until the server has exited. Otherwise a server listening late would wait for its only connection forever.
+    auto responses = std::string();
+    auto serverExited = std::atomic_bool(false);
+    auto client = std::thread([&] {
+        auto address = sockaddr_un();
+        address.sun_family = AF_UNIX;
+        socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+        const auto connection = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        auto attempts = 0;
+        for (; ::connect(connection, reinterpret_cast<const sockaddr *>(&address), sizeof(address)); ++attempts) {
+            if (serverExited) {
+                ::close(connection);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        if (attempts >= 100) {
+            ::close(connection);
+            return;
+        }
+        auto requests = "{\"jsonrpc\": \"2.0\", \"id\": 1, \"method\": \"set\", \"params\": [\"title=served\", \"-f\", \"" + mkvFile
+            + "\"]}\n{\"jsonrpc\": \"2.0\", \"id\": 2, \"method\": \"get\", \"params\": [\"title\", \"-f\", \"" + mkvFile
+            + "\"]}\n{\"jsonrpc\": \"2.0\", \"id\": 3, \"method\": \"serve\"}\n{\"jsonrpc\": \"2.0\", \"id\": 4, \"method\": \"get\"}\n"
+              "{\"jsonrpc\": \"2.0\", \"id\": 5, \"method\": \"get\", \"params\": [\"title\", \"-f\", \""
+            + mkvFile + "\"]}\n";
+#ifdef TAGEDITOR_USE_JSENGINE
+        for (const auto id : { "6", "7" }) {
+            requests += "{\"jsonrpc\": \"2.0\", \"id\": " % std::string(id) % ", \"method\": \"set\", \"params\": [\"--script\", \"" % script
+                % "\", \"--script-settings\", \"set:title=foo\", \"-f\", \"" % mkvFile + "\"]}\n";
+        }
+#endif
+        char buffer[4096];
+        const auto written = ::write(connection, requests.data(), requests.size());
+        while (written == static_cast<ssize_t>(requests.size())
+            && std::count(responses.cbegin(), responses.cend(), '\n') < std::count(requests.cbegin(), requests.cend(), '\n')) {
+            const auto bytesRead = ::read(connection, buffer, sizeof(buffer));
+            if (bytesRead <= 0) {
+                break;
+            }
+            responses.append(buffer, static_cast<std::size_t>(bytesRead));
+        }
+        ::close(connection);
+    });
+
+    // serve only the connection of the client
+    const char *const args[] = { "tageditor", "serve", "--socket", socketPath.data(), "--max-connections", "1", nullptr };
+    const auto stopClient = [&] {
+        serverExited = true;
+        client.join();
+    };
+    try {
+        TESTUTILS_ASSERT_EXEC(args);
+    } catch (...) {
+        stopClient();
+        throw;
+    }
+    stopClient();
+    CPPUNIT_ASSERT(testContainsSubstrings(responses,
+        { "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":{\"exitCode\":0,\"stdout\":\"Setting tag information for", "Changes have been applied",
+            "{\"jsonrpc\":\"2.0\",\"id\":2,\"result\":{\"exitCode\":0,\"stdout\":\"", "Title             served",
+            "{\"jsonrpc\":\"2.0\",\"id\":3,\"error\":{\"code\":-32601,\"message\":\"Method not found\"}}",
+            "{\"jsonrpc\":\"2.0\",\"id\":4,\"result\":{\"exitCode\":1,", "{\"jsonrpc\":\"2.0\",\"id\":5,\"result\":{\"exitCode\":0,\"stdout\":\"",
+            "Title             served" }));
+#ifdef TAGEDITOR_USE_JSENGINE
+    // the script is only loaded once as the worker process serving the connection is kept running between requests
+    CPPUNIT_ASSERT(testContainsSubstrings(
+        responses, { "{\"jsonrpc\":\"2.0\",\"id\":6,\"result\":{\"exitCode\":0,", "{\"jsonrpc\":\"2.0\",\"id\":7,\"result\":{\"exitCode\":0," }));
+    const auto loadingMessage = "Loading JavaScript file"s;
+    const auto firstLoadingMessage = responses.find(loadingMessage);
+    CPPUNIT_ASSERT(firstLoadingMessage != std::string::npos);
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, responses.find(loadingMessage, firstLoadingMessage + 1));
+#endif
+    CPPUNIT_ASSERT(!std::filesystem::exists(socketPath));
+
+    // refuse to take over a socket another process is still listening on
+    auto address = sockaddr_un();
+    address.sun_family = AF_UNIX;
+    socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    const auto otherServer = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    CPPUNIT_ASSERT_EQUAL(0, ::bind(otherServer, reinterpret_cast<const sockaddr *>(&address), sizeof(address)));
+    CPPUNIT_ASSERT_EQUAL(0, ::listen(otherServer, 1));
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args, EXIT_FAILURE);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "The socket \"", "\" is already in use." }));
+    CPPUNIT_ASSERT(std::filesystem::exists(socketPath));
+    ::close(otherServer);
+    ::unlink(socketPath.data());
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile.data()));
+    remove((mkvFile + ".bak").data());
+#endif
+}
+
+/*!
+ * \brief Tests the --profile parameter.
+ */
+void CliTests::testProfiling()
+{
+    cout << "\nProfiling" << endl;
+    string stdout, stderr;
+    const string mkvFile(workingCopyPath("matroska_wave1/test1.mkv"));
+    const string traceFile(workingCopyPath("tageditor-trace.json", WorkingCopyMode::NoCopy));
+
+    // read tags printing the profile and writing a trace
+    const char *const args1[] = { "tageditor", "get", "title", "--profile", traceFile.data(), "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Title             Big Buck Bunny - test 1" }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "Profile", " - Files:         1 (0 rewritten completely, 0 cloned, 0 unchanged)", "Phase", "open",
+                                                      "parse container format", "parse tags" }));
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, stderr.find("apply changes"));
+    const auto trace = readFile(traceFile);
+    CPPUNIT_ASSERT(testContainsSubstrings(
+        trace, { "{\"traceEvents\":[", "{\"name\":\"file\",\"cat\":\"file\",\"ph\":\"X\"", "\"name\":\"parse tags\"", "]}" }));
+
+    // field names following --profile are not silently taken as further trace files
+    const char *const ambiguousArgs[] = { "tageditor", "get", "--profile", traceFile.data(), "title", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(ambiguousArgs, EXIT_FAILURE);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "Only one trace file can be specified via --profile." }));
+
+    // force rewriting the file
+    const char *const args2[] = { "tageditor", "set", "title=profiled", "--force-rewrite", "--profile", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "Profile", "parse attachments", "create tags", "modify tags", "apply changes" }));
+#ifdef PLATFORM_UNIX
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { " - Files:         1 (1 rewritten completely, 0 cloned, 0 unchanged)" }));
+#endif
+
+    // setting the same value again does not lead to writing the file at all (not even if a rewrite is forced)
+    const auto modificationTimeBefore = std::filesystem::last_write_time(mkvFile);
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Unchanged; the file has not been written.", "Unchanged: 1 of 1 files have been left as-is" }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { " - Files:         1 (0 rewritten completely, 0 cloned, 1 unchanged)" }));
+    CPPUNIT_ASSERT(modificationTimeBefore == std::filesystem::last_write_time(mkvFile));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove((mkvFile + ".bak").data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(traceFile.data()));
+}
+
+/*!
+ * \brief Tests the set operation's --plan argument.
+ */
+void CliTests::testPlan()
+{
+    cout << "\nPlan" << endl;
+    string stdout, stderr;
+    const string mkvFile(workingCopyPath("matroska_wave1/test1.mkv"));
+    const auto sizeBefore = std::filesystem::file_size(mkvFile);
+    const auto modificationTimeBefore = std::filesystem::last_write_time(mkvFile);
+
+    // determine how changes would be applied without applying them
+    const char *const args1[] = { "tageditor", "set", "title=planned", "--max-padding", "100000", "--plan", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Setting tag information for", " - Plan: ", "Meta-data:", "Padding:", "Projected I/O:", "Plan",
+                                                      " - Files:          1", "note: No files have been modified." }));
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, stdout.find("Changes have been applied"));
+    CPPUNIT_ASSERT_EQUAL(sizeBefore, std::filesystem::file_size(mkvFile));
+    CPPUNIT_ASSERT(modificationTimeBefore == std::filesystem::last_write_time(mkvFile));
+    const char *const args2[] = { "tageditor", "get", "title", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Title             Big Buck Bunny - test 1" }));
+
+    // a forced rewrite always leads to a complete rewrite copying the whole file
+    const char *const args3[] = { "tageditor", "set", "title=planned", "--force-rewrite", "--plan", "--quiet", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    const auto sizeRead = dataSizeToString(sizeBefore);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Plan: complete rewrite (rewrite forced)", sizeRead.data(),
+                                                      " - Files:          1 (0 updated in-place, 1 rewritten completely, 0 unchanged)" }));
+    CPPUNIT_ASSERT_EQUAL(sizeBefore, std::filesystem::file_size(mkvFile));
+    CPPUNIT_ASSERT(!std::filesystem::exists(mkvFile + ".bak"));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile.data()));
+}
+
+/*!
+ * \brief Tests the set operation's --padding-policy and --padding-history arguments.
+ */
+void CliTests::testAdaptivePadding()
+{
+    cout << "\nAdaptive padding" << endl;
+    string stdout, stderr;
+    const string mkvFile(workingCopyPath("matroska_wave1/test2.mkv"));
+    const string historyFile(workingCopyPath("tageditor-padding-history.tsv", WorkingCopyMode::NoCopy));
+    const auto historyEntry = argsToString('\t', std::filesystem::absolute(mkvFile).lexically_normal().string(), '\n');
+
+    // invalid usage
+    const char *const args1[] = { "tageditor", "set", "title=foo", "--padding-policy", "foo", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args1, EXIT_FAILURE);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "The specified padding policy \"foo\" is invalid." }));
+    const char *const args2[] = { "tageditor", "set", "title=foo", "--padding-history", historyFile.data(), "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args2, EXIT_FAILURE);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "An edit history has been specified but the padding policy is not adaptive." }));
+
+    // rewrite the file using the adaptive padding policy recording the edit
+    const char *const args3[] = { "tageditor", "set", "title=adaptive", "--padding-policy", "adaptive", "--padding-history", historyFile.data(),
+        "--force-rewrite", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT_EQUAL("1" + historyEntry, readFile(historyFile));
+
+    // the padding of the rewritten file is now sufficient to update the file in-place
+    const char *const args4[] = { "tageditor", "set", "title=adaptive 2", "--padding-policy", "adaptive", "--padding-history", historyFile.data(),
+        "--plan", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Plan: in-place update", " - Files:          1 (1 updated in-place, 0 rewritten completely, 0 unchanged)" }));
+    CPPUNIT_ASSERT_EQUAL("1" + historyEntry, readFile(historyFile));
+    const char *const args5[] = { "tageditor", "set", "title=adaptive 2", "--padding-policy", "adaptive", "--padding-history", historyFile.data(),
+        "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT_EQUAL("2" + historyEntry, readFile(historyFile));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove((mkvFile + ".bak").data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(historyFile.data()));
+}
+
+#ifdef PLATFORM_UNIX
+/*!
+ * \brief Writes a journal to \a journalPath saving the whole current contents of \a file like it would be left behind when
+ *        crashing while updating \a file in-place (see WriteJournal::begin() for the format).
+ */
+static void writeJournalOfFile(const std::string &journalPath, const std::string &file)
+{
+    const auto absolutePath = std::filesystem::absolute(file).string();
+    const auto contents = readFile(file);
+    struct stat fileStat;
+    CPPUNIT_ASSERT_EQUAL(0, ::stat(file.data(), &fileStat));
+    auto journal = std::ofstream(journalPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    auto writer = BinaryWriter(&journal);
+    writer.writeString("TAGEDITOR-JOURNAL");
+    writer.writeUInt32LE(1);
+    writer.writeUInt64LE(absolutePath.size());
+    writer.writeString(absolutePath);
+    writer.writeUInt64LE(contents.size());
+    writer.writeUInt64LE(static_cast<std::uint64_t>(fileStat.st_dev));
+    writer.writeUInt64LE(static_cast<std::uint64_t>(fileStat.st_ino));
+    writer.writeUInt64LE(1);
+    writer.writeUInt64LE(0);
+    writer.writeUInt64LE(contents.size());
+    writer.writeString(contents);
+    journal.close();
+    CPPUNIT_ASSERT(!journal.fail());
+}
+#endif
+
+void CliTests::testJournal()
+{
+    cout << "\nJournaled in-place update" << endl;
+    string stdout, stderr;
+    const string mkvFile(workingCopyPath("matroska_wave1/test2.mkv"));
+    const auto journalDir = (std::filesystem::temp_directory_path() / "tageditor-journal").string();
+    const auto staleJournal = journalDir + "/stale.journal.tmp";
+    std::filesystem::remove_all(journalDir);
+    std::filesystem::create_directory(journalDir);
+    writeFile(staleJournal, "incomplete");
+
+    // rewrite the file first to ensure there is enough padding for updating it in-place
+    const char *const args1[] = { "tageditor", "set", "title=foo", "--force-rewrite", "--preferred-padding", "10000", "--max-padding", "100000",
+        "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT_EQUAL(0, remove((mkvFile + ".bak").data()));
+
+    // update the file in-place using the journal; incomplete journals are removed and the journal is removed after applying
+    const char *const args2[] = { "tageditor", "set", "title=journaled", "--journal", journalDir.data(), "--max-padding", "100000", "-f",
+        mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Changes have been applied." }));
+    CPPUNIT_ASSERT(!std::filesystem::exists(mkvFile + ".bak"));
+    CPPUNIT_ASSERT(std::filesystem::is_empty(journalDir));
+    const char *const args3[] = { "tageditor", "get", "title", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Title             journaled" }));
+
+#ifdef PLATFORM_UNIX
+    // simulate a crash after the file has been updated in-place but before the journal has been committed by writing the
+    // journal and updating the file in-place without journal
+    const auto contentsBeforeCrash = readFile(mkvFile);
+    const auto crashJournal = journalDir + "/crashed.journal";
+    writeJournalOfFile(crashJournal, mkvFile);
+    const char *const args4[] = { "tageditor", "set", "title=crashed in the middle", "--max-padding", "100000", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    CPPUNIT_ASSERT(!std::filesystem::exists(mkvFile + ".bak"));
+    CPPUNIT_ASSERT(readFile(mkvFile) != contentsBeforeCrash);
+
+    // the next invocation using the journal restores the original bytes and size of the file before processing any files
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Changes to \"", "\" which have not been completed have been rolled back via the journal." }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Unchanged; the file has not been written." }));
+    CPPUNIT_ASSERT(std::filesystem::is_empty(journalDir));
+    const auto contentsAfterRecovery = readFile(mkvFile);
+    CPPUNIT_ASSERT_EQUAL(contentsBeforeCrash.size(), contentsAfterRecovery.size());
+    CPPUNIT_ASSERT(contentsBeforeCrash == contentsAfterRecovery);
+
+    // a journal for a file which has been replaced in the meantime is discarded with a warning (instead of being kept forever)
+    writeJournalOfFile(crashJournal, mkvFile);
+    const auto replacement = mkvFile + ".replacement";
+    std::filesystem::copy_file(mkvFile, replacement);
+    std::filesystem::rename(replacement, mkvFile);
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "does not exist anymore or has been replaced since the journal", "The journal has been discarded" }));
+    CPPUNIT_ASSERT(std::filesystem::is_empty(journalDir));
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, stderr.find("journal"));
+#endif
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile.data()));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uintmax_t>(1), std::filesystem::remove_all(journalDir));
+}
+
+/*!
+ * \brief Tests the --cover-max-size and --cover-format parameters of the set operation.
+ */
+void CliTests::testCoverNormalization()
+{
+#if !defined(TAGEDITOR_GUI_QTWIDGETS) && !defined(TAGEDITOR_GUI_QTQUICK)
+    std::cout << "\nSkipping cover normalization (feature not enabled)" << std::endl;
+#else
+    std::cout << "\nCover normalization" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto coverFile = testFilePath("matroska_wave1/logo3_256x256.png");
+    const auto mp3File = workingCopyPath("mtx-test-data/mp3/id3-tag-and-xing-header.mp3");
+    const auto coverArg = "cover=" + coverFile;
+
+    // set a PNG cover converting it to a scaled-down JPEG
+    const char *const args1[] = { "tageditor", "set", coverArg.data(), "--cover-max-size", "100x100", "--cover-format", "jpg", "--cover-quality",
+        "80", "-f", mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Normalized 1 cover(s) from ", "Covers: 1 normalized (1 distinct pictures re-encoded), " }));
+    const char *const args2[] = { "tageditor", "get", "-f", mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "    Cover (other)     can't display image/jpeg as string (use --extract)\n" }));
+    CPPUNIT_ASSERT_EQUAL(0, remove((mp3File + ".bak").data()));
+
+    // normalizing the cover again does not alter it (so the file is not written)
+    const char *const args3[] = { "tageditor", "set", "--cover-max-size", "100x100", "--cover-format", "jpeg", "-f", mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Unchanged; the file has not been written." }));
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, stdout.find("Normalized"));
+
+    // invalid sizes are rejected
+    const char *const args4[] = { "tageditor", "set", "--cover-max-size", "100", "-f", mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args4, EXIT_FAILURE);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "The specified maximum cover size \"100\" is invalid" }));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mp3File.data()));
 #endif
 }
 
@@ -0,0 +1,161 @@
+// Benchmark for the preview generation of the renaming utility (build the target "tageditor_renamingbench" explicitly; it is
+// not part of "all")
+//
+// Creates flat directories of different sizes and measures
+// - the lookups the preview generation does for each entry on the item tree alone (checking for conflicts at the new
+//   location, creating the counterpart and checking whether its name is already used) and
+// - generating the preview via RenamingEngine::generatePreview() with a script renaming each file (only if compiled with
+//   JavaScript support).
+// The time per entry is supposed to stay roughly constant when the directory size grows. The results are printed as JSON.
+
+#include "../renamingutility/filesystemitem.h"
+#include "../renamingutility/renamingengine.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string_view>
+
+using namespace RenamingUtility;
+
+namespace {
+
+/*!
+ * \brief Simulates generating the preview for a flat directory with the specified number of \a entries.
+ * \returns Returns the number of seconds it took.
+ */
+double simulatePreview(int entries, Qt::CaseSensitivity caseSensitivity)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto root = std::make_unique<FileSystemItem>(ItemStatus::Current, ItemType::Dir, QStringLiteral("root"));
+    root->setCaseSensitivity(caseSensitivity);
+    auto *const dir = new FileSystemItem(ItemStatus::Current, ItemType::Dir, QStringLiteral("dir"), root.get());
+    for (auto i = 0; i != entries; ++i) {
+        new FileSystemItem(ItemStatus::Current, ItemType::File, QStringLiteral("track %1.mp3").arg(i), dir);
+    }
+    auto conflicts = 0;
+    const auto children = dir->children();
+    for (auto *const item : children) {
+        const auto newName = QStringLiteral("Renamed ") + item->name();
+        if (dir->findChild(newName, item)) {
+            ++conflicts;
+            continue;
+        }
+        item->setNewName(newName);
+        if (const auto *const newItem = item->counterpart(); newItem && newItem->parent()->findChild(newItem->name(), newItem)) {
+            ++conflicts;
+        }
+    }
+    if (conflicts) {
+        std::cerr << "Error: Unexpected conflicts detected.\n";
+        std::exit(EXIT_FAILURE);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#ifndef TAGEDITOR_NO_JSENGINE
+/*!
+ * \brief Generates the preview for a flat directory with the specified number of \a entries via RenamingEngine.
+ * \returns Returns the number of seconds it took (not including the creation of the directory).
+ * \remarks The case sensitivity used by the engine is assigned to \a caseSensitivity.
+ */
+double generatePreview(int entries, Qt::CaseSensitivity &caseSensitivity)
+{
+    const auto dir = QTemporaryDir();
+    if (!dir.isValid()) {
+        std::cerr << "Error: Unable to create temporary directory.\n";
+        std::exit(EXIT_FAILURE);
+    }
+    for (auto i = 0; i != entries; ++i) {
+        auto file = QFile(dir.filePath(QStringLiteral("track %1.mp3").arg(i)));
+        if (!file.open(QFile::WriteOnly)) {
+            std::cerr << "Error: Unable to create file in temporary directory.\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    auto engine = RenamingEngine();
+    if (!engine.setProgram(QStringLiteral("tageditor.rename(\"Renamed \" + tageditor.currentName)"))) {
+        std::cerr << "Error: Unable to set program: " << engine.errorMessage().toStdString() << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+    auto eventLoop = QEventLoop();
+    auto itemsProcessed = 0, errorsOccured = 0;
+    QObject::connect(&engine, &RenamingEngine::progress, &eventLoop, [&](int processed, int errors) {
+        itemsProcessed = processed;
+        errorsOccured = errors;
+    });
+    QObject::connect(&engine, &RenamingEngine::previewGenerated, &eventLoop, &QEventLoop::quit);
+    const auto start = std::chrono::steady_clock::now();
+    if (!engine.generatePreview(QDir(dir.path()), false)) {
+        std::cerr << "Error: Unable to start generating the preview.\n";
+        std::exit(EXIT_FAILURE);
+    }
+    eventLoop.exec();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (itemsProcessed != entries || errorsOccured || !engine.rootItem()) {
+        std::cerr << "Error: Unexpected result of preview generation (" << itemsProcessed << " items processed, " << errorsOccured
+                  << " errors occurred).\n";
+        std::exit(EXIT_FAILURE);
+    }
+    caseSensitivity = engine.rootItem()->caseSensitivity();
+    return seconds;
+}
+#endif
+
+/*!
+ * \brief Prints the result of a benchmark run as JSON object.
+ */
+void printResult(bool &first, std::string_view benchmark, Qt::CaseSensitivity caseSensitivity, int entries, double seconds)
+{
+    std::cout << (first ? "\n" : ",\n") << "    {\"benchmark\": \"" << benchmark
+              << "\", \"caseSensitive\": " << (caseSensitivity == Qt::CaseSensitive ? "true" : "false") << ", \"entries\": " << entries
+              << ", \"seconds\": " << seconds << ", \"microsecondsPerEntry\": " << seconds * 1000000.0 / entries << '}';
+    first = false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    auto maxEntries = 128000;
+    if (argc > 1) {
+        if (std::string_view(argv[1]) == "--help" || std::string_view(argv[1]) == "-h") {
+            std::cout << "Usage: " << argv[0] << " [max. number of entries]\n";
+            return EXIT_SUCCESS;
+        }
+        maxEntries = std::atoi(argv[1]);
+        if (maxEntries < 1000) {
+            std::cerr << "Error: The max. number of entries must be at least 1000.\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "{\n  \"results\": [";
+    auto first = true;
+    for (const auto caseSensitivity : { Qt::CaseSensitive, Qt::CaseInsensitive }) {
+        for (auto entries = 1000; entries <= maxEntries; entries *= 2) {
+            printResult(first, "items", caseSensitivity, entries, simulatePreview(entries, caseSensitivity));
+        }
+    }
+#ifndef TAGEDITOR_NO_JSENGINE
+    for (auto entries = 1000; entries <= maxEntries; entries *= 2) {
+        auto caseSensitivity = Qt::CaseSensitive;
+        const auto seconds = generatePreview(entries, caseSensitivity);
+        printResult(first, "generatePreview", caseSensitivity, entries, seconds);
+    }
+#else
+    std::cerr << "Skipping generatePreview benchmark (not compiled with JavaScript support)\n";
+#endif
+    std::cout << "\n  ]\n}\n";
+    return EXIT_SUCCESS;
+}